@@ -0,0 +1,50 @@
+#include "image-processing/color-convert/kernels/bayer2rgb.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+template <image_processing::color_convert::ImageFormat output_format,
+          image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkBayer2RGB(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  std::vector<unsigned char> input_image(width * height);
+  for (size_t i = 0; i < input_image.size(); i++) {
+    input_image[i] = static_cast<unsigned char>(i * 7);
+  }
+  std::vector<unsigned char> output_image(
+      image_format_size(output_format, width, height), 0);
+  ConstImageView input(input_image.data(), width, height,
+                       ImageFormat::IMAGE_BAYER_RGGB);
+  ImageView output(output_image.data(), width, height, output_format);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    kernels::bayer_2_rgb(input, output, algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, input_image.size() + output_image.size(),
+                    algo_type);
+}
+
+BENCHMARK(
+    BenchmarkBayer2RGB<image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+                       image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(
+    BenchmarkBayer2RGB<image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+                       image_processing::color_convert::AlgoType::kParallelCpu>);
+BENCHMARK(
+    BenchmarkBayer2RGB<image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+                       image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(
+    BenchmarkBayer2RGB<image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+                       image_processing::color_convert::AlgoType::kParallelSimdCpu>);
+
+BENCHMARK(
+    BenchmarkBayer2RGB<image_processing::color_convert::ImageFormat::IMAGE_RGBA8,
+                       image_processing::color_convert::AlgoType::kSimdCpu>);
@@ -0,0 +1,63 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+template <image_processing::color_convert::ImageFormat input_format,
+          image_processing::color_convert::ImageFormat output_format,
+          image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkFloat(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  ImageBuffer input(width, height, input_format);
+  ImageBuffer output(width, height, output_format);
+  std::fill(input.data(), input.data() + input.size(), 0);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    color_convert(input.view(), output.view(), algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, input.size() + output.size(), algo_type);
+}
+
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::ImageFormat::IMAGE_GRAY32F,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::ImageFormat::IMAGE_GRAY32F,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGBA32F,
+          image_processing::color_convert::ImageFormat::IMAGE_GRAY32F,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGBA32F,
+          image_processing::color_convert::ImageFormat::IMAGE_GRAY32F,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+
+// uint8 <-> float with the default scaling
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkFloat<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
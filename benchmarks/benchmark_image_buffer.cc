@@ -0,0 +1,47 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+// one output frame allocated per converted frame, the pattern the pool
+// replaces
+static void BenchmarkFrameVector(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  ImageBuffer input(width, height, ImageFormat::IMAGE_BGR8);
+  std::fill(input.data(), input.data() + input.size(), 0);
+
+  for (auto _ : state) {
+    std::vector<unsigned char> output_image(
+        image_format_size(ImageFormat::IMAGE_RGBA8, width, height));
+    color_convert(input.view(),
+                  ImageView(output_image.data(), width, height,
+                            ImageFormat::IMAGE_RGBA8),
+                  AlgoType::kSimdCpu);
+    benchmark::DoNotOptimize(output_image.data());
+  }
+}
+
+static void BenchmarkFramePool(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  BufferPoolOptions options;
+  options.huge_pages = state.range(0) != 0;
+  BufferPool pool(options);
+  ImageBuffer input(width, height, ImageFormat::IMAGE_BGR8);
+  std::fill(input.data(), input.data() + input.size(), 0);
+
+  for (auto _ : state) {
+    ImageBuffer output =
+        pool.acquire(width, height, ImageFormat::IMAGE_RGBA8);
+    color_convert(input.view(), output.view(), AlgoType::kSimdCpu);
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+
+BENCHMARK(BenchmarkFrameVector);
+BENCHMARK(BenchmarkFramePool)->Arg(0)->Arg(1);
@@ -0,0 +1,69 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+template <image_processing::color_convert::ImageFormat format,
+          image_processing::color_convert::MemLayout input_layout,
+          image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkLayout(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  constexpr MemLayout output_layout = input_layout == MemLayout::Packed
+                                          ? MemLayout::Planar
+                                          : MemLayout::Packed;
+  ImageBuffer input(width, height, format, input_layout);
+  ImageBuffer output(width, height, format, output_layout);
+  std::fill(input.data(), input.data() + input.size(), 0);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    color_convert_layout(input.view(), output.view(), algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, input.size() + output.size(), algo_type);
+}
+
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+          image_processing::color_convert::MemLayout::Planar,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGBA8,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGBA8,
+          image_processing::color_convert::MemLayout::Planar,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+          image_processing::color_convert::MemLayout::Planar,
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkLayout<
+          image_processing::color_convert::ImageFormat::IMAGE_RGBA32F,
+          image_processing::color_convert::MemLayout::Packed,
+          image_processing::color_convert::AlgoType::kParallelSimdCpu>);
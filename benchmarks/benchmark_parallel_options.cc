@@ -0,0 +1,46 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/common/parallel-options.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+// range(0): ParallelOptions::grain_rows, range(1): affinity
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkGrainRows(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  ImageBuffer input(width, height, ImageFormat::IMAGE_RGB8);
+  ImageBuffer output(width, height, ImageFormat::IMAGE_GRAY8);
+  std::fill(input.data(), input.data() + input.size(), 0);
+
+  ParallelOptions options;
+  options.grain_rows = static_cast<int>(state.range(0));
+  options.affinity = state.range(1) != 0;
+  set_parallel_options(options);
+  reset_parallel_stats();
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    color_convert(input.view(), output.view(), algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, input.size() + output.size(), algo_type);
+
+  const ParallelStats stats = parallel_stats();
+  state.counters["bands"] = benchmark::Counter(
+      static_cast<double>(stats.bands) / std::max<size_t>(stats.calls, 1));
+  set_parallel_options(ParallelOptions());
+}
+
+BENCHMARK(BenchmarkGrainRows<
+              image_processing::color_convert::AlgoType::kParallelCpu>)
+    ->ArgsProduct({{0, 1, 8, 64, 1080}, {0, 1}});
+BENCHMARK(BenchmarkGrainRows<
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->ArgsProduct({{0, 1, 8, 64, 1080}, {0, 1}});
@@ -0,0 +1,64 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/pipeline.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <string.h>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+constexpr size_t frames = 16;
+
+// read = copy of a decoded frame, write = checksum of the gray frame
+
+static void BenchmarkSerialFrames(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  ImageBuffer source(width, height, ImageFormat::IMAGE_RGB8);
+  std::fill(source.data(), source.data() + source.size(), 1);
+  BufferPool pool;
+
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (size_t i = 0; i < frames; ++i) {
+      ImageBuffer input = pool.acquire(width, height, ImageFormat::IMAGE_RGB8);
+      memcpy(input.data(), source.data(), source.size());
+      ImageBuffer gray = pool.acquire(width, height, ImageFormat::IMAGE_GRAY8);
+      color_convert(input.view(), gray.view(), AlgoType::kSimdCpu);
+      sum += std::count(gray.data(), gray.data() + gray.size(), 1);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+static void BenchmarkPipelineFrames(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  ImageBuffer source(width, height, ImageFormat::IMAGE_RGB8);
+  std::fill(source.data(), source.data() + source.size(), 1);
+  Pipeline pipeline;
+  size_t sum = 0;
+  pipeline
+      .read([&](PipelineFrame &frame) {
+        if (frame.index == frames) {
+          return false;
+        }
+        frame.image =
+            pipeline.pool().acquire(width, height, ImageFormat::IMAGE_RGB8);
+        memcpy(frame.image.data(), source.data(), source.size());
+        return true;
+      })
+      .convert(ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu)
+      .write([&](PipelineFrame &frame) {
+        sum += std::count(frame.image.data(),
+                          frame.image.data() + frame.image.size(), 1);
+      });
+
+  for (auto _ : state) {
+    pipeline.run();
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+BENCHMARK(BenchmarkSerialFrames);
+BENCHMARK(BenchmarkPipelineFrames);
@@ -1,4 +1,8 @@
+#include "image-processing/color-convert/color-convert.hpp"
 #include "image-processing/color-convert/kernels/rgb2gray.hpp"
+#include "frame_content.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
 #include <array>
 #include <benchmark/benchmark.h>
 #include <cstdlib>
@@ -14,14 +18,25 @@ template <image_processing::color_convert::AlgoType algo_type,
           image_processing::color_convert::MemLayout mem_layout>
 static void BenchmarkRGB2Gray(benchmark::State &state) {
 
-  std::vector<unsigned char> input_image(pixel_count * 3, 128);
+  std::vector<unsigned char> input_image(pixel_count * 3);
+  fill_frame(input_image.data(), input_image.size(), width * 3);
   std::vector<unsigned char> output_image(pixel_count, 0);
 
+  // kAuto measures the algorithms on its first call, keep that out of the
+  // timing
+  image_processing::color_convert::kernels::rgb_2_gray(
+      input_image.data(), output_image.data(), width, height, algo_type,
+      mem_layout);
+
+  PerfCounters perf;
   for (auto _ : state) {
     image_processing::color_convert::kernels::rgb_2_gray(
         input_image.data(), output_image.data(), width, height, algo_type,
         mem_layout);
   }
+  perf.report(state);
+
+  report_throughput(state, pixel_count * 4, algo_type);
 }
 
 BENCHMARK(
@@ -33,6 +48,12 @@ BENCHMARK(
 BENCHMARK(
     BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kSimdCpu,
                       image_processing::color_convert::MemLayout::Packed>);
+BENCHMARK(
+    BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kParallelSimdCpu,
+                      image_processing::color_convert::MemLayout::Packed>);
+BENCHMARK(
+    BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kAuto,
+                      image_processing::color_convert::MemLayout::Packed>);
 
 #if HAS_CUDA
 
@@ -50,10 +71,171 @@ BENCHMARK(
 BENCHMARK(
     BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kSimdCpu,
                       image_processing::color_convert::MemLayout::Planar>);
+BENCHMARK(
+    BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kParallelSimdCpu,
+                      image_processing::color_convert::MemLayout::Planar>);
+BENCHMARK(
+    BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kAuto,
+                      image_processing::color_convert::MemLayout::Planar>);
 
 #if HAS_CUDA
 
 BENCHMARK(
     BenchmarkRGB2Gray<image_processing::color_convert::AlgoType::kCuda,
                       image_processing::color_convert::MemLayout::Planar>);
-#endif
\ No newline at end of file
+#endif
+
+// converts the centered 1920x1080 region of the frame in place, through a view
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkRGB2GrayRoi(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  std::vector<unsigned char> input_image(pixel_count * 3);
+  fill_frame(input_image.data(), input_image.size(), width * 3);
+  std::vector<unsigned char> output_image(pixel_count / 4, 0);
+  ConstImageView input =
+      ConstImageView(input_image.data(), width, height, ImageFormat::IMAGE_RGB8)
+          .roi(width / 4, height / 4, width / 2, height / 2);
+  ImageView output(output_image.data(), width / 2, height / 2,
+                   ImageFormat::IMAGE_GRAY8);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    kernels::rgb_2_gray(input, output, algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, pixel_count / 4 * 4, algo_type);
+}
+
+BENCHMARK(BenchmarkRGB2GrayRoi<
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkRGB2GrayRoi<
+          image_processing::color_convert::AlgoType::kParallelSimdCpu>);
+
+constexpr int thumbnail_width = 640;
+constexpr int thumbnail_height = 480;
+constexpr int thumbnail_count = 256;
+
+// thumbnails converted one call at a time
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkRGB2GrayThumbnails(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  const size_t thumbnail_pixels = thumbnail_width * thumbnail_height;
+  std::vector<unsigned char> input_image(thumbnail_pixels * 3 *
+                                         thumbnail_count);
+  fill_frame(input_image.data(), input_image.size(), thumbnail_width * 3);
+  std::vector<unsigned char> output_image(thumbnail_pixels * thumbnail_count,
+                                          0);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    for (int i = 0; i < thumbnail_count; i++) {
+      kernels::rgb_2_gray(input_image.data() + i * thumbnail_pixels * 3,
+                          output_image.data() + i * thumbnail_pixels,
+                          thumbnail_width, thumbnail_height, algo_type,
+                          MemLayout::Packed);
+    }
+  }
+  perf.report(state);
+
+  report_throughput(state, thumbnail_pixels * 4 * thumbnail_count, algo_type);
+}
+
+// the same thumbnails converted by one color_convert_batch() call
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkRGB2GrayThumbnailsBatch(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  const size_t thumbnail_pixels = thumbnail_width * thumbnail_height;
+  std::vector<unsigned char> input_image(thumbnail_pixels * 3 *
+                                         thumbnail_count);
+  fill_frame(input_image.data(), input_image.size(), thumbnail_width * 3);
+  std::vector<unsigned char> output_image(thumbnail_pixels * thumbnail_count,
+                                          0);
+  std::vector<ConstImageView> inputs;
+  std::vector<ImageView> outputs;
+  for (int i = 0; i < thumbnail_count; i++) {
+    inputs.emplace_back(input_image.data() + i * thumbnail_pixels * 3,
+                        thumbnail_width, thumbnail_height,
+                        ImageFormat::IMAGE_RGB8);
+    outputs.emplace_back(output_image.data() + i * thumbnail_pixels,
+                         thumbnail_width, thumbnail_height,
+                         ImageFormat::IMAGE_GRAY8);
+  }
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    color_convert_batch(inputs.data(), outputs.data(), thumbnail_count,
+                        algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, thumbnail_pixels * 4 * thumbnail_count, algo_type);
+}
+
+BENCHMARK(BenchmarkRGB2GrayThumbnails<
+          image_processing::color_convert::AlgoType::kParallelSimdCpu>);
+BENCHMARK(BenchmarkRGB2GrayThumbnailsBatch<
+          image_processing::color_convert::AlgoType::kParallelSimdCpu>);
+
+// rgb_2_gray into a full size buffer followed by a 2x box downscale
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkRGB2GrayThenDownscale(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  std::vector<unsigned char> input_image(pixel_count * 3);
+  fill_frame(input_image.data(), input_image.size(), width * 3);
+  std::vector<unsigned char> gray_image(pixel_count, 0);
+  std::vector<unsigned char> output_image(pixel_count / 4, 0);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    kernels::rgb_2_gray(input_image.data(), gray_image.data(), width, height,
+                        algo_type, MemLayout::Packed);
+    for (int y = 0; y < height / 2; y++) {
+      const unsigned char *row = gray_image.data() + 2 * y * width;
+      for (int x = 0; x < width / 2; x++) {
+        output_image[y * width / 2 + x] =
+            (row[2 * x] + row[2 * x + 1] + row[width + 2 * x] +
+             row[width + 2 * x + 1] + 2) >>
+            2;
+      }
+    }
+  }
+  perf.report(state);
+
+  // the bytes the conversion has to move, the gray frame in between is
+  // overhead
+  report_throughput(state, pixel_count * 3 + pixel_count / 4, algo_type);
+}
+
+// the same in one pass through the fused kernel
+template <image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkRGB2GrayDownscale(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  std::vector<unsigned char> input_image(pixel_count * 3);
+  fill_frame(input_image.data(), input_image.size(), width * 3);
+  std::vector<unsigned char> output_image(pixel_count / 4, 0);
+  ConstImageView input(input_image.data(), width, height,
+                       ImageFormat::IMAGE_RGB8);
+  ImageView output(output_image.data(), width / 2, height / 2,
+                   ImageFormat::IMAGE_GRAY8);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    kernels::rgb_2_gray_downscale(input, output, 2, algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, pixel_count * 3 + pixel_count / 4, algo_type);
+}
+
+BENCHMARK(BenchmarkRGB2GrayThenDownscale<
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkRGB2GrayDownscale<
+          image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(BenchmarkRGB2GrayDownscale<
+          image_processing::color_convert::AlgoType::kParallelSimdCpu>);
@@ -1,4 +1,7 @@
 #include "image-processing/color-convert/kernels/rgba2gray.hpp"
+#include "frame_content.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
 #include <array>
 #include <benchmark/benchmark.h>
 #include <cstdlib>
@@ -14,14 +17,19 @@ template <image_processing::color_convert::AlgoType algo_type,
           image_processing::color_convert::MemLayout mem_layout>
 static void BenchmarkRGBA2Gray(benchmark::State &state) {
 
-  std::vector<unsigned char> input_image(pixel_count * 4, 128);
+  std::vector<unsigned char> input_image(pixel_count * 4);
+  fill_frame(input_image.data(), input_image.size(), width * 4);
   std::vector<unsigned char> output_image(pixel_count, 0);
 
+  PerfCounters perf;
   for (auto _ : state) {
     image_processing::color_convert::kernels::rgba_2_gray(
         input_image.data(), output_image.data(), width, height, algo_type,
         mem_layout);
   }
+  perf.report(state);
+
+  report_throughput(state, pixel_count * 5, algo_type);
 }
 
 BENCHMARK(
@@ -33,6 +41,9 @@ BENCHMARK(
 BENCHMARK(
     BenchmarkRGBA2Gray<image_processing::color_convert::AlgoType::kSimdCpu,
                        image_processing::color_convert::MemLayout::Packed>);
+BENCHMARK(
+    BenchmarkRGBA2Gray<image_processing::color_convert::AlgoType::kParallelSimdCpu,
+                       image_processing::color_convert::MemLayout::Packed>);
 #if HAS_CUDA
 
 BENCHMARK(
@@ -49,6 +60,9 @@ BENCHMARK(
 BENCHMARK(
     BenchmarkRGBA2Gray<image_processing::color_convert::AlgoType::kSimdCpu,
                        image_processing::color_convert::MemLayout::Planar>);
+BENCHMARK(
+    BenchmarkRGBA2Gray<image_processing::color_convert::AlgoType::kParallelSimdCpu,
+                       image_processing::color_convert::MemLayout::Planar>);
 #if HAS_CUDA
 BENCHMARK(
     BenchmarkRGBA2Gray<image_processing::color_convert::AlgoType::kCuda,
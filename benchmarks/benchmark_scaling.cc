@@ -0,0 +1,145 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/execution-context.hpp"
+#include "frame_content.hpp"
+#include "roofline.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <map>
+#include <tbb/info.h>
+#include <tuple>
+
+// Thread scaling of the parallel kernels: every benchmark runs in an
+// ExecutionContext of range(0) threads and reports its speedup over the same
+// kernel on one thread and the parallel efficiency (speedup / threads).
+// Where the efficiency drops while roofline_pct nears 100, memory bandwidth
+// stops the scaling, more threads will not help. Run with
+// --benchmark_filter=BenchmarkScaling.
+
+constexpr int width = 1920 * 2;
+constexpr int height = 1080 * 2;
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+using namespace image_processing::color_convert;
+
+// converts until at least min_time has passed, returns seconds per call
+double time_per_call(const ExecutionContext &context,
+                     const ConstImageView &input, const ImageView &output,
+                     AlgoType algo_type) {
+  constexpr std::chrono::milliseconds min_time(200);
+  color_convert(input, output, algo_type, context);
+  const auto start = Clock::now();
+  int calls = 0;
+  do {
+    color_convert(input, output, algo_type, context);
+    ++calls;
+  } while (Clock::now() - start < min_time);
+  const std::chrono::duration<double> time = Clock::now() - start;
+  return time.count() / calls;
+}
+
+// seconds per call on one thread, measured once per conversion
+double single_thread_time(const ConstImageView &input, const ImageView &output,
+                          AlgoType algo_type) {
+  static std::map<std::tuple<ImageFormat, ImageFormat, AlgoType>, double>
+      times;
+  const auto key = std::make_tuple(input.format, output.format, algo_type);
+  auto it = times.find(key);
+  if (it == times.end()) {
+    ExecutionContextOptions options;
+    options.max_threads = 1;
+    const ExecutionContext context(options);
+    it = times.emplace(key, time_per_call(context, input, output, algo_type))
+             .first;
+  }
+  return it->second;
+}
+
+// 1, 2, 4, ... threads up to and including the default concurrency
+void thread_counts(benchmark::internal::Benchmark *benchmark) {
+  const int max_threads = tbb::info::default_concurrency();
+  for (int threads = 1; threads < max_threads; threads *= 2) {
+    benchmark->Arg(threads);
+  }
+  benchmark->Arg(max_threads);
+}
+
+} // namespace
+
+template <image_processing::color_convert::ImageFormat input_format,
+          image_processing::color_convert::ImageFormat output_format,
+          image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkScaling(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  const int threads = static_cast<int>(state.range(0));
+  ImageBuffer input(width, height, input_format);
+  ImageBuffer output(width, height, output_format);
+  fill_frame(input.data(), input.size(), input.view().pitch);
+
+  ExecutionContextOptions options;
+  options.max_threads = threads;
+  const ExecutionContext context(options);
+  // the arena's threads start on the first call
+  color_convert(input.view(), output.view(), algo_type, context);
+
+  const auto start = Clock::now();
+  for (auto _ : state) {
+    color_convert(input.view(), output.view(), algo_type, context);
+  }
+  const std::chrono::duration<double> time = Clock::now() - start;
+
+  const double speedup =
+      single_thread_time(input.view(), output.view(), algo_type) /
+      (time.count() / state.iterations());
+  state.counters["threads"] = threads;
+  state.counters["speedup"] = speedup;
+  state.counters["efficiency"] = speedup / threads;
+  report_throughput(state, input.size() + output.size(), algo_type);
+}
+
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::ImageFormat::IMAGE_GRAY8,
+              image_processing::color_convert::AlgoType::kParallelCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::ImageFormat::IMAGE_GRAY8,
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_RGBA8,
+              image_processing::color_convert::ImageFormat::IMAGE_GRAY8,
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_NV12,
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::AlgoType::kParallelCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_NV12,
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_BAYER_RGGB,
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
+BENCHMARK(BenchmarkScaling<
+              image_processing::color_convert::ImageFormat::IMAGE_RGB8,
+              image_processing::color_convert::ImageFormat::IMAGE_RGB32F,
+              image_processing::color_convert::AlgoType::kParallelSimdCpu>)
+    ->Apply(thread_counts)
+    ->UseRealTime();
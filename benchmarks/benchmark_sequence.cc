@@ -0,0 +1,58 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/frame-reader.hpp"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <vector>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+constexpr size_t frames = 16;
+
+static const char *kSequencePath = "/tmp/benchmark_sequence.rgb";
+
+static void write_sequence() {
+  std::ofstream file(kSequencePath, std::ios::binary);
+  const std::vector<char> frame(size_t(width) * height * 3, 1);
+  for (size_t i = 0; i < frames; ++i) {
+    file.write(frame.data(), frame.size());
+  }
+}
+
+// read a frame, then convert it
+static void BenchmarkSequenceBlocking(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  write_sequence();
+
+  for (auto _ : state) {
+    // allocated per sequence, as color_convert_sequence() does
+    ImageBuffer input(width, height, ImageFormat::IMAGE_RGB8);
+    ImageBuffer output(width, height, ImageFormat::IMAGE_GRAY8);
+    std::ifstream file(kSequencePath, std::ios::binary);
+    while (file.read(reinterpret_cast<char *>(input.data()), input.size())) {
+      color_convert(input.view(), output.view(), AlgoType::kSimdCpu);
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+}
+
+// the next frame is read while the current one is converted
+static void BenchmarkSequencePrefetch(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  write_sequence();
+
+  for (auto _ : state) {
+    color_convert_sequence(
+        kSequencePath, width, height, ImageFormat::IMAGE_RGB8,
+        ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu,
+        [](size_t, const ConstImageView &frame) {
+          benchmark::DoNotOptimize(frame.data);
+          return true;
+        });
+  }
+}
+
+BENCHMARK(BenchmarkSequenceBlocking)->UseRealTime();
+BENCHMARK(BenchmarkSequencePrefetch)->UseRealTime();
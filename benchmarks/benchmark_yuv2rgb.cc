@@ -0,0 +1,53 @@
+#include "image-processing/color-convert/kernels/yuv2rgb.hpp"
+#include "perf_counters.hpp"
+#include "roofline.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+constexpr int width = 1920;
+constexpr int height = 1080;
+
+template <image_processing::color_convert::ImageFormat input_format,
+          image_processing::color_convert::AlgoType algo_type>
+static void BenchmarkYUV2RGB(benchmark::State &state) {
+  using namespace image_processing::color_convert;
+
+  std::vector<unsigned char> input_image(
+      image_format_size(input_format, width, height), 128);
+  std::vector<unsigned char> output_image(width * height * 3, 0);
+  ConstImageView input(input_image.data(), width, height, input_format);
+  ImageView output(output_image.data(), width, height,
+                   ImageFormat::IMAGE_RGB8);
+
+  PerfCounters perf;
+  for (auto _ : state) {
+    kernels::yuv_2_rgb(input, output, algo_type);
+  }
+  perf.report(state);
+
+  report_throughput(state, input_image.size() + output_image.size(),
+                    algo_type);
+}
+
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_NV12,
+                     image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_NV12,
+                     image_processing::color_convert::AlgoType::kParallelCpu>);
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_NV12,
+                     image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_NV12,
+                     image_processing::color_convert::AlgoType::kParallelSimdCpu>);
+
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_I420,
+                     image_processing::color_convert::AlgoType::kSimdCpu>);
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_YUYV,
+                     image_processing::color_convert::AlgoType::kNativeCpu>);
+BENCHMARK(
+    BenchmarkYUV2RGB<image_processing::color_convert::ImageFormat::IMAGE_YUYV,
+                     image_processing::color_convert::AlgoType::kSimdCpu>);
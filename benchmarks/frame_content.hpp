@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+
+// Fills size bytes with a horizontal gradient of 0 to 240 across every row
+// of row_bytes, plus noise of 0 to 6, rather than a constant frame whose
+// values could make a kernel look faster than on real content.
+inline void fill_frame(unsigned char *data, size_t size, size_t row_bytes) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<unsigned char>(i % row_bytes * 240 / row_bytes +
+                                         i % 7);
+  }
+}
@@ -0,0 +1,142 @@
+#include "perf_counters.hpp"
+#include <cstdlib>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct PerfEvent {
+  const char *name;
+  uint32_t type;
+  uint64_t config;
+};
+
+#ifdef __linux__
+// the first event leads the group, the others are only counted with it
+const PerfEvent kEvents[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+bool perf_counters_enabled() {
+  static const bool enabled = [] {
+    const char *value = std::getenv("IMAGE_PROCESSING_PERF_COUNTERS");
+    return value != nullptr && value[0] != '\0' && strcmp(value, "0") != 0;
+  }();
+  return enabled;
+}
+
+// warns once instead of once per benchmark
+void warn_unavailable(int error) {
+  static bool warned = false;
+  if (!warned) {
+    warned = true;
+    fprintf(stderr, "perf counters unavailable: %s\n",
+            error == EACCES || error == EPERM
+                ? "not permitted, see /proc/sys/kernel/perf_event_paranoid"
+                : "no hardware counters on this CPU or virtual machine");
+  }
+}
+
+int open_event(const PerfEvent &event, int group) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = group == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                     PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+}
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  for (int i = 0; i < kEventCount; ++i) {
+    fds_[i] = -1;
+    ids_[i] = 0;
+  }
+#ifdef __linux__
+  if (!perf_counters_enabled()) {
+    return;
+  }
+  fds_[0] = open_event(kEvents[0], -1);
+  if (fds_[0] == -1) {
+    warn_unavailable(errno);
+    return;
+  }
+  for (int i = 1; i < kEventCount; ++i) {
+    fds_[i] = open_event(kEvents[i], fds_[0]);
+  }
+  for (int i = 0; i < kEventCount; ++i) {
+    if (fds_[i] != -1) {
+      ioctl(fds_[i], PERF_EVENT_IOC_ID, &ids_[i]);
+    }
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int i = kEventCount - 1; i >= 0; --i) {
+    if (fds_[i] != -1) {
+      close(fds_[i]);
+    }
+  }
+#endif
+}
+
+void PerfCounters::report(benchmark::State &state) {
+#ifdef __linux__
+  if (fds_[0] == -1) {
+    return;
+  }
+  ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+  // nr, time enabled, time running, then a value and id per event
+  uint64_t buffer[3 + 2 * kEventCount];
+  if (read(fds_[0], buffer, sizeof(buffer)) < 0 || buffer[2] == 0) {
+    return;
+  }
+  // scaled up if the group was multiplexed with other counters
+  const double scale = static_cast<double>(buffer[1]) / buffer[2];
+  double values[kEventCount] = {};
+  for (uint64_t n = 0; n < buffer[0] && n < kEventCount; ++n) {
+    for (int i = 0; i < kEventCount; ++i) {
+      if (fds_[i] != -1 && ids_[i] == buffer[4 + 2 * n]) {
+        values[i] = buffer[3 + 2 * n] * scale;
+      }
+    }
+  }
+
+  for (int i = 0; i < kEventCount; ++i) {
+    if (fds_[i] != -1) {
+      state.counters[kEvents[i].name] =
+          benchmark::Counter(values[i], benchmark::Counter::kAvgIterations);
+    }
+  }
+  if (fds_[1] != -1 && values[0] > 0) {
+    state.counters["IPC"] = values[1] / values[0];
+  }
+#else
+  (void)state;
+#endif
+}
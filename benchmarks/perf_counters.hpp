@@ -0,0 +1,35 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+
+// Hardware counters of the calling thread (Linux perf_event_open): cycles,
+// instructions, last level cache misses and branch misses, user space only.
+// Collected when the environment variable IMAGE_PROCESSING_PERF_COUNTERS is
+// set to anything but 0, e.g.
+//
+//   IMAGE_PROCESSING_PERF_COUNTERS=1 ./run_benchmarks
+//
+// Counting starts when the object is created, so create it right before the
+// timed loop. Counters the CPU, the kernel (perf_event_paranoid) or a
+// container do not allow are left out; without any, nothing is reported.
+// The TBB worker threads of the parallel kernels are not counted.
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // Stops counting and adds the counts per iteration (and IPC) to the user
+  // counters of state.
+  void report(benchmark::State &state);
+
+private:
+  static constexpr int kEventCount = 4;
+
+  // group leader first, -1 for an event that could not be opened
+  int fds_[kEventCount];
+  uint64_t ids_[kEventCount];
+};
@@ -0,0 +1,104 @@
+#include "roofline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace {
+
+using image_processing::color_convert::AlgoType;
+
+// per buffer, far beyond any last level cache
+constexpr size_t kStreamBytes = size_t(256) << 20;
+// the all-core copy is cut into chunks of this size
+constexpr size_t kChunkBytes = size_t(1) << 20;
+constexpr int kStreamRuns = 5;
+
+struct StreamBuffers {
+  std::vector<unsigned char> source;
+  std::vector<unsigned char> destination;
+
+  // every page is touched once, the copies see no page faults
+  StreamBuffers()
+      : source(kStreamBytes, 1), destination(kStreamBytes, 0) {}
+
+  void copy(bool all_cores) {
+    if (!all_cores) {
+      memcpy(destination.data(), source.data(), kStreamBytes);
+      return;
+    }
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, kStreamBytes / kChunkBytes),
+                      [this](const tbb::blocked_range<size_t> &range) {
+                        const size_t begin = range.begin() * kChunkBytes;
+                        memcpy(destination.data() + begin,
+                               source.data() + begin,
+                               range.size() * kChunkBytes);
+                      });
+  }
+};
+
+// bytes read plus written per second, the fastest of kStreamRuns copies
+double measure_copy(StreamBuffers &buffers, bool all_cores) {
+  using clock = std::chrono::steady_clock;
+  buffers.copy(all_cores);
+  double best = 0;
+  for (int run = 0; run < kStreamRuns; ++run) {
+    const auto start = clock::now();
+    buffers.copy(all_cores);
+    const std::chrono::duration<double> time = clock::now() - start;
+    best = std::max(best, 2.0 * kStreamBytes / time.count());
+  }
+  return best;
+}
+
+// kAuto may pick a parallel algorithm, so it is held to the all-core roofline
+bool is_parallel(AlgoType algo_type) {
+  return algo_type == AlgoType::kParallelCpu ||
+         algo_type == AlgoType::kParallelSimdCpu ||
+         algo_type == AlgoType::kAuto;
+}
+
+template <bool all_cores> void BenchmarkMemcpy(benchmark::State &state) {
+  StreamBuffers buffers;
+  for (auto _ : state) {
+    buffers.copy(all_cores);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * 2 *
+                          kStreamBytes);
+}
+
+} // namespace
+
+const Roofline &roofline() {
+  static const Roofline result = [] {
+    StreamBuffers buffers;
+    Roofline roofline;
+    roofline.single_core = measure_copy(buffers, false);
+    // one thread is an option of the pool too
+    roofline.all_cores =
+        std::max(measure_copy(buffers, true), roofline.single_core);
+    return roofline;
+  }();
+  return result;
+}
+
+void report_throughput(benchmark::State &state, size_t bytes_per_iteration,
+                       AlgoType algo_type) {
+  const double bytes =
+      static_cast<double>(state.iterations()) * bytes_per_iteration;
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  if (algo_type == AlgoType::kCuda) {
+    return;
+  }
+  const double peak = is_parallel(algo_type) ? roofline().all_cores
+                                             : roofline().single_core;
+  // a rate counter, divided by the time of the run
+  state.counters["roofline_pct"] =
+      benchmark::Counter(100.0 * bytes / peak, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BenchmarkMemcpy<false>)->Name("BenchmarkMemcpy/single_core");
+BENCHMARK(BenchmarkMemcpy<true>)->Name("BenchmarkMemcpy/all_cores");
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include <benchmark/benchmark.h>
+#include <stddef.h>
+
+// Memory bandwidth of the host, the ceiling of a streaming kernel: a
+// conversion reads its input and writes its output once, so it cannot move
+// bytes faster than memcpy does. Measured with a copy far larger than the
+// last level cache, counting the bytes read plus the bytes written.
+struct Roofline {
+  // bytes per second of one thread
+  double single_core = 0;
+  // bytes per second of all threads of the TBB pool
+  double all_cores = 0;
+};
+
+// measured on the first call
+const Roofline &roofline();
+
+// Reports bytes_per_iteration (input plus output) as the bytes processed and
+// as percent of the roofline: single core for the serial algorithms, all
+// cores for the parallel ones. Working sets that fit in a cache can exceed
+// 100%.
+void report_throughput(benchmark::State &state, size_t bytes_per_iteration,
+                       image_processing::color_convert::AlgoType algo_type);
@@ -0,0 +1,151 @@
+// Resolution sweep over every registered conversion. Every (input format,
+// output format, algorithm, layout) with a kernel is run at sizes from a few
+// KiB (L1 resident) up to 8K, on noisy gradient content instead of a constant
+// frame, and reports bytes and pixels (items) per second and the percent of
+// the memory bandwidth roofline. Where a kernel's throughput drops along the
+// sizes shows which cache level it falls out of.
+//
+// Without --benchmark_out the results are also written to
+// benchmark-sweep.json. Use --benchmark_filter to pick conversions, e.g.
+// --benchmark_filter='Sweep/rgb8/gray8/'.
+
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "../perf_counters.hpp"
+#include "../roofline.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace image_processing::color_convert;
+
+const int kResolutions[][2] = {
+    {64, 48},     {160, 120},   {320, 240},   {640, 480},
+    {1280, 720},  {1920, 1080}, {3840, 2160}, {7680, 4320},
+};
+
+const AlgoType kAlgoTypes[] = {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                               AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu,
+#if HAS_CUDA
+                               AlgoType::kCuda
+#endif
+};
+
+const MemLayout kLayouts[] = {MemLayout::Packed, MemLayout::Planar};
+
+// A diagonal gradient with +-16 of noise: neighbouring samples are correlated
+// like in a photo, but branchy or saturating kernels cannot take a shortcut
+// as on a constant frame.
+void fill_content(ImageBuffer &image) {
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int> noise(-16, 16);
+  const size_t row_bytes = image.size() / image.height();
+  const bool is_float = image_format_to_base_type(image.format()) ==
+                        ImageBaseType::IMAGE_FLOAT;
+  const size_t samples = is_float ? image.size() / sizeof(float) : image.size();
+  for (size_t i = 0; i < samples; ++i) {
+    const size_t byte = is_float ? i * sizeof(float) : i;
+    const size_t x = byte % row_bytes * 255 / row_bytes;
+    const size_t y = byte / row_bytes * 255 / image.height();
+    int value = static_cast<int>(x + y) / 2 + noise(random);
+    value = value < 0 ? 0 : value > 255 ? 255 : value;
+    if (is_float) {
+      reinterpret_cast<float *>(image.data())[i] = value / 255.0f;
+    } else {
+      image.data()[i] = static_cast<unsigned char>(value);
+    }
+  }
+}
+
+void BenchmarkSweep(benchmark::State &state, ImageFormat input_format,
+                    ImageFormat output_format, AlgoType algo_type,
+                    MemLayout layout) {
+  const int width = static_cast<int>(state.range(0));
+  const int height = static_cast<int>(state.range(1));
+  ImageBuffer input(width, height, input_format, layout);
+  ImageBuffer output(width, height, output_format, layout);
+  fill_content(input);
+  memset(output.data(), 0, output.size());
+
+  if (!color_convert(input.view(), output.view(), algo_type)) {
+    state.SkipWithError("conversion failed");
+    return;
+  }
+  PerfCounters perf;
+  for (auto _ : state) {
+    color_convert(input.view(), output.view(), algo_type);
+    benchmark::ClobberMemory();
+  }
+  perf.report(state);
+
+  report_throughput(state, input.size() + output.size(), algo_type);
+  // items are pixels
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * width *
+                          height);
+  state.counters["working_set"] =
+      benchmark::Counter(static_cast<double>(input.size() + output.size()),
+                         benchmark::Counter::kDefaults,
+                         benchmark::Counter::kIs1024);
+}
+
+void register_sweep() {
+  const int format_count = static_cast<int>(ImageFormat::IMAGE_COUNT);
+  for (int in = 0; in < format_count; ++in) {
+    for (int out = 0; out < format_count; ++out) {
+      const ImageFormat input_format = static_cast<ImageFormat>(in);
+      const ImageFormat output_format = static_cast<ImageFormat>(out);
+      for (MemLayout layout : kLayouts) {
+        for (AlgoType algo_type : kAlgoTypes) {
+          if (color_convert_kernel(input_format, output_format, algo_type,
+                                   layout) == nullptr) {
+            continue;
+          }
+          const std::string name =
+              std::string("Sweep/") + image_format_to_str(input_format) +
+              "/" + image_format_to_str(output_format) + "/" +
+              algo_type_to_str(algo_type) + "/" +
+              (layout == MemLayout::Planar ? "planar" : "packed");
+          benchmark::internal::Benchmark *benchmark =
+              benchmark::RegisterBenchmark(name.c_str(), BenchmarkSweep,
+                                           input_format, output_format,
+                                           algo_type, layout);
+          benchmark->ArgNames({"width", "height"});
+          for (const auto &resolution : kResolutions) {
+            benchmark->Args({resolution[0], resolution[1]});
+          }
+          benchmark->UseRealTime();
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<char *> args(argv, argv + argc);
+  bool has_out = false;
+  for (int i = 1; i < argc; ++i) {
+    has_out = has_out || strncmp(argv[i], "--benchmark_out=", 16) == 0;
+  }
+  std::string out = "--benchmark_out=benchmark-sweep.json";
+  std::string out_format = "--benchmark_out_format=json";
+  if (!has_out) {
+    args.push_back(&out[0]);
+    args.push_back(&out_format[0]);
+  }
+  int count = static_cast<int>(args.size());
+
+  register_sweep();
+  benchmark::Initialize(&count, args.data());
+  if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
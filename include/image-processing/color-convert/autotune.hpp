@@ -0,0 +1,47 @@
+#pragma once
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * @brief Get the algorithm AlgoType::kAuto uses to convert input to output.
+ *
+ * The choice is made per (format pair, memory layout, resolution bucket,
+ * thread count), where the resolution bucket is the pixel count rounded up
+ * to a power of two and the thread count is the concurrency of the current
+ * TBB arena. The first time a key is seen, every CPU algorithm with a kernel
+ * for the conversion is timed on input and output (output is overwritten)
+ * and the fastest one is remembered, and written to the cache file if one is
+ * set. color_convert_downscale(), color_convert_normalize() and
+ * color_convert_layout() tune kAuto the same way, with results of their own.
+ *
+ * @return the fastest algorithm, kNativeCpu if no CPU kernel exists
+ */
+AlgoType autotune_algo_type(const ConstImageView &input,
+                            const ImageView &output);
+
+/**
+ * @brief Use a cache file for the autotuning results. Its entries are loaded
+ * right away, so later processes pick their algorithms without measuring;
+ * new results are added to the file. Processes sharing the file keep each
+ * other's results: every write merges the entries on disk under a lock on
+ * path + ".lock".
+ *
+ * Without a call, the file named by the environment variable
+ * IMAGE_PROCESSING_AUTOTUNE_CACHE is used, if set.
+ *
+ * @param path the file, nullptr to keep results in memory only
+ * @return false if the file exists but cannot be read
+ */
+bool autotune_set_cache_file(const char *path);
+
+/**
+ * @brief Forget every result in memory, the cache file is kept.
+ */
+void autotune_clear();
+
+} // namespace color_convert
+} // namespace image_processing
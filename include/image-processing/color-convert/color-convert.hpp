@@ -2,14 +2,149 @@
 
 #include "image-processing/color-convert/common/algo-type.hpp"
 #include "image-processing/color-convert/common/image-format.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+#include "image-processing/color-convert/common/mem-layout.hpp"
+#include <stddef.h>
 
 namespace image_processing {
 namespace color_convert {
 
+/**
+ * @brief Signature shared by every registered color conversion kernel.
+ *
+ * Kernels walk the images row by row through ImageView::row(), so padded
+ * rows and regions of interest are handled by every kernel. The caller
+ * guarantees that both views are valid and have the same dimensions.
+ */
+using ColorConvertFunc = bool (*)(const ConstImageView &input,
+                                  const ImageView &output);
+
+/**
+ * @brief Look up the kernel registered for a conversion.
+ *
+ * The lookup is a single index into a flat table, so the returned handle can
+ * be cached and called once per frame without going through the dispatch
+ * again.
+ *
+ * @param input_format
+ * @param output_format
+ * @param algo_type
+ * @param mem_layout
+ * @return ColorConvertFunc, or nullptr if no kernel is registered for the
+ * combination. AlgoType::kAuto depends on the image size and has no kernel,
+ * use autotune_algo_type() to resolve it first.
+ */
+ColorConvertFunc color_convert_kernel(const ImageFormat &input_format,
+                                      const ImageFormat &output_format,
+                                      const AlgoType &algo_type,
+                                      const MemLayout &mem_layout);
+
+/**
+ * @brief Convert an image from input_format to output_format.
+ *
+ * @return true on success, false if the arguments are invalid or no kernel
+ * is registered for the combination.
+ */
 bool color_convert(const unsigned char *input_buffer,
-                   unsigned char *output_buffer,
+                   unsigned char *output_buffer, int width, int height,
                    const ImageFormat &input_format,
-                   const ImageFormat &output_format, const AlgoType &algo_type);
+                   const ImageFormat &output_format, const AlgoType &algo_type,
+                   const MemLayout &mem_layout = MemLayout::Packed);
+
+/**
+ * @brief Convert the image seen by input into the image seen by output.
+ *
+ * The formats and the memory layout are taken from the views, both views
+ * must have the same layout (@see same_layout()). Both views may have a pitch
+ * larger than their width (padded frames, regions of interest). With
+ * AlgoType::kAuto the fastest CPU algorithm measured for the conversion is
+ * used, see autotune_algo_type().
+ *
+ * @return true on success, false if a view is empty, the dimensions or the
+ * layouts differ or no kernel is registered for the combination.
+ */
+bool color_convert(const ConstImageView &input, const ImageView &output,
+                   const AlgoType &algo_type);
+
+/**
+ * @brief Convert count images with a single call.
+ *
+ * inputs[i] is converted into outputs[i]. With kParallelCpu and
+ * kParallelSimdCpu the whole batch is scheduled as one parallel job: every
+ * image is cut into bands of rows, small images are a single band and run in
+ * parallel with each other, large ones are split so that their rows are
+ * converted in parallel too. Images whose rows do not convert independently
+ * (4:2:0 YUV, Bayer, planar layout) are not cut, the parallel kernel
+ * converts each of them whole within the same job. The other algorithms
+ * convert the images one after the other.
+ *
+ * The images may differ in size and format.
+ *
+ * @return true on success, false if any pair of views is invalid (nothing is
+ * converted then) or a kernel fails.
+ */
+bool color_convert_batch(const ConstImageView *inputs,
+                         const ImageView *outputs, size_t count,
+                         const AlgoType &algo_type);
+
+/**
+ * @brief Convert input to output_format and shrink it by factor in the same
+ * pass.
+ *
+ * Every output pixel is the rounded average of a factor x factor block of
+ * converted input pixels (box filter), the full size converted image is never
+ * written to memory. Only GRAY8 output is supported.
+ *
+ * @param input
+ * @param output input.width / factor x input.height / factor, extra input
+ * rows and columns are ignored.
+ * @param factor 2 or 4
+ * @param algo_type kAuto uses the fastest CPU algorithm measured for the
+ * fused downscale, not the one of the plain conversion.
+ * @return true on success, false if the views or the factor are invalid or no
+ * kernel is registered for the combination.
+ */
+bool color_convert_downscale(const ConstImageView &input,
+                             const ImageView &output, int factor,
+                             const AlgoType &algo_type);
+
+/**
+ * @brief Convert between a uint8 format and the float format with the same
+ * channels (e.g. RGB8 <-> RGB32F, GRAY8 <-> GRAY32F), every sample becomes
+ * sample * scale + offset.
+ *
+ * Converting uint8 to float and scaling happen in the same pass. Float to
+ * uint8 rounds to nearest even and saturates to [0, 255], NaN becomes 0.
+ * color_convert() between such a pair uses scale 1 / 255 (uint8 to float) or
+ * 255 (float to uint8) and offset 0.
+ *
+ * @param input
+ * @param output same dimensions and memory layout as input
+ * @param scale
+ * @param offset
+ * @param algo_type kAuto is tuned for normalize on its own.
+ * @return true on success, false if the views are invalid, the formats are
+ * not such a pair or no kernel is registered for algo_type.
+ */
+bool color_convert_normalize(const ConstImageView &input,
+                             const ImageView &output, float scale,
+                             float offset, const AlgoType &algo_type);
+
+/**
+ * @brief Repack a 3 or 4 channel uint8 or float image between the packed and
+ * the planar memory layout, the samples are copied unchanged.
+ *
+ * The planar layout is the fast path of several kernels (e.g. gray and float
+ * gray), repacking a frame once lets every later step use it.
+ *
+ * @param input
+ * @param output same dimensions and format as input, the other layout
+ * @param algo_type kAuto is tuned for the repacking on its own.
+ * @return true on success, false if the views are invalid, the format has not
+ * 3 or 4 uint8 or float channels or no kernel is registered for algo_type.
+ */
+bool color_convert_layout(const ConstImageView &input,
+                          const ImageView &output, const AlgoType &algo_type);
 
-}
-} // namespace image_processing
\ No newline at end of file
+} // namespace color_convert
+} // namespace image_processing
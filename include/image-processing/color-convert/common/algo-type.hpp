@@ -1,9 +1,65 @@
 #pragma once
 
+#include <string.h>
+
 namespace image_processing {
 namespace color_convert {
 
-enum class AlgoType { kNativeCpu, kParallelCpu, kSimdCpu, kCuda };
+// kParallelSimdCpu splits the image into row bands with TBB and runs the
+// vectorized kernel of kSimdCpu on every band. kAuto is resolved per call to
+// the fastest CPU algorithm measured for the conversion (see autotune.hpp),
+// it has no kernels of its own and stays after kCuda.
+enum class AlgoType {
+  kNativeCpu,
+  kParallelCpu,
+  kSimdCpu,
+  kParallelSimdCpu,
+  kCuda,
+  kAuto
+};
+
+/**
+ * @brief Convert an AlgoType enum to a string.
+ *
+ * @param algo_type
+ * @return const char*
+ */
+static inline const char *algo_type_to_str(AlgoType algo_type) {
+  switch (algo_type) {
+  case AlgoType::kNativeCpu:
+    return "native";
+  case AlgoType::kParallelCpu:
+    return "parallel";
+  case AlgoType::kSimdCpu:
+    return "simd";
+  case AlgoType::kParallelSimdCpu:
+    return "parallel-simd";
+  case AlgoType::kCuda:
+    return "cuda";
+  case AlgoType::kAuto:
+    return "auto";
+  }
+
+  return "unknown";
+}
+
+/**
+ * @brief Convert a string of algo_type_to_str() to an AlgoType enum.
+ *
+ * @return true if the string names an algorithm
+ */
+static inline bool algo_type_from_str(const char *str, AlgoType *algo_type) {
+  if (!str)
+    return false;
+
+  for (int n = 0; n <= static_cast<int>(AlgoType::kAuto); n++) {
+    if (strcmp(str, algo_type_to_str(static_cast<AlgoType>(n))) == 0) {
+      *algo_type = static_cast<AlgoType>(n);
+      return true;
+    }
+  }
+  return false;
+}
 
 }
-} // namespace image_processing
\ No newline at end of file
+} // namespace image_processing
@@ -0,0 +1,67 @@
+#pragma once
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * The CpuIsa enum identifies the instruction set variant used by the
+ * AlgoType::kSimdCpu kernels. Every variant is compiled into the library,
+ * the best one supported by the CPU is selected once when the library is
+ * loaded.
+ *
+ * kGeneric is the portable std::experimental::simd build for the baseline
+ * target of the compiler. kAvx2 and kAvx512bw also require FMA.
+ */
+enum class CpuIsa { kGeneric, kSse41, kAvx2, kAvx512bw, kNeon };
+
+/**
+ * @brief Convert a CpuIsa enum to a string.
+ *
+ * @param isa
+ * @return const char*
+ */
+static inline const char *cpu_isa_to_str(CpuIsa isa) {
+  switch (isa) {
+  case CpuIsa::kGeneric:
+    return "generic";
+  case CpuIsa::kSse41:
+    return "sse4.1";
+  case CpuIsa::kAvx2:
+    return "avx2";
+  case CpuIsa::kAvx512bw:
+    return "avx512bw";
+  case CpuIsa::kNeon:
+    return "neon";
+  }
+
+  return "unknown";
+}
+
+/**
+ * @brief Check if a variant is compiled into the library and can run on this
+ * CPU.
+ *
+ * @param isa
+ * @return true
+ * @return false
+ */
+bool cpu_isa_supported(CpuIsa isa);
+
+/**
+ * @brief Get the variant currently used by the SIMD kernels.
+ *
+ * @return CpuIsa
+ */
+CpuIsa cpu_isa();
+
+/**
+ * @brief Force the SIMD kernels to a specific variant, e.g. to compare them.
+ *
+ * @param isa
+ * @return false if the variant is not supported on this CPU, the selection is
+ * left unchanged in that case.
+ */
+bool set_cpu_isa(CpuIsa isa);
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+
+#include "image-processing/color-convert/common/image-format.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+#include "image-processing/color-convert/common/mem-layout.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * Alignment of every ImageBuffer, one cache line and one AVX-512 vector.
+ */
+constexpr size_t kImageBufferAlignment = 64;
+
+/**
+ * Options of a BufferPool.
+ */
+struct BufferPoolOptions {
+  /**
+   * Back buffers of at least 2 MiB with transparent huge pages (Linux only,
+   * ignored elsewhere). A 1080p RGB frame spans ~1500 4 KiB pages but only 3
+   * huge pages, which saves page faults and TLB misses.
+   */
+  bool huge_pages = false;
+
+  /**
+   * Released buffers are kept for reuse up to this many bytes, anything
+   * beyond is freed right away.
+   */
+  size_t max_cached_bytes = size_t(256) << 20;
+};
+
+namespace detail {
+struct BufferPoolState;
+} // namespace detail
+
+/**
+ * An owning image buffer, aligned to kImageBufferAlignment and sized by
+ * image_format_size(). Buffers only move, they are never copied.
+ *
+ * A buffer from BufferPool::acquire() goes back to its pool when it is
+ * destroyed, it may outlive the pool. A buffer created with the constructor
+ * is freed instead.
+ */
+class ImageBuffer {
+public:
+  ImageBuffer() = default;
+
+  /**
+   * @brief Allocate an unpooled, tightly packed buffer.
+   *
+   * @throws std::bad_alloc if the allocation fails
+   */
+  ImageBuffer(int width, int height, ImageFormat format,
+              MemLayout layout = MemLayout::Packed);
+
+  ~ImageBuffer();
+
+  ImageBuffer(ImageBuffer &&other) noexcept;
+  ImageBuffer &operator=(ImageBuffer &&other) noexcept;
+  ImageBuffer(const ImageBuffer &) = delete;
+  ImageBuffer &operator=(const ImageBuffer &) = delete;
+
+  unsigned char *data() const { return data_; }
+
+  /**
+   * @brief Get the size of the image in bytes, the allocation may be larger.
+   */
+  size_t size() const { return size_; }
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  ImageFormat format() const { return format_; }
+  MemLayout layout() const { return layout_; }
+
+  /**
+   * @brief Get a tightly packed view of the whole buffer.
+   */
+  ImageView view() const {
+    return ImageView(data_, width_, height_, format_, layout_);
+  }
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+private:
+  friend class BufferPool;
+
+  void release();
+
+  unsigned char *data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+  ImageFormat format_ = ImageFormat::IMAGE_UNKNOWN;
+  MemLayout layout_ = MemLayout::Packed;
+  std::shared_ptr<detail::BufferPoolState> pool_;
+};
+
+/**
+ * A thread safe pool of ImageBuffer allocations. Buffers of the same size
+ * are recycled, so converting a stream of equally sized frames allocates (and
+ * page faults) only for the first few frames.
+ */
+class BufferPool {
+public:
+  explicit BufferPool(const BufferPoolOptions &options = BufferPoolOptions());
+
+  /**
+   * @brief Get a buffer for a tightly packed width x height image, reusing a
+   * released one of the same size when possible. The content is undefined.
+   *
+   * @return the buffer, empty if width or height is not positive
+   * @throws std::bad_alloc if the allocation fails
+   */
+  ImageBuffer acquire(int width, int height, ImageFormat format,
+                      MemLayout layout = MemLayout::Packed);
+
+  /**
+   * @brief Get the number of bytes held by released buffers.
+   */
+  size_t cached_bytes() const;
+
+  /**
+   * @brief Free every released buffer.
+   */
+  void trim();
+
+private:
+  std::shared_ptr<detail::BufferPoolState> state_;
+};
+
+} // namespace color_convert
+} // namespace image_processing
@@ -267,6 +267,20 @@ static inline bool image_format_is_yuv(ImageFormat format) {
   return false;
 }
 
+/**
+ * @brief Check if an image format is a 4:2:0 YUV format (I420, YV12, NV12),
+ * whose chroma samples live in plane(s) after the luma plane.
+ *
+ * @param format
+ * @return true
+ * @return false
+ */
+static inline bool image_format_is_yuv420(ImageFormat format) {
+  return format == ImageFormat::IMAGE_I420 ||
+         format == ImageFormat::IMAGE_YV12 ||
+         format == ImageFormat::IMAGE_NV12;
+}
+
 /**
  * @brief Check if an image format is a Grayscale format.
  *
@@ -378,29 +392,86 @@ template <> inline ImageFormat image_format_from_type<float4>() {
   return ImageFormat::IMAGE_RGBA32F;
 }
 
+/**
+ * Compile-time traits of the packed RGB and BGR formats: the base and vector
+ * types plus the number of channels and the offsets of the color channels
+ * inside a pixel (alpha, if present, is always the last channel). Kernels
+ * templated over a format read the channel order from here, so every
+ * instantiation has its offsets baked in.
+ */
 template <ImageFormat format> struct ImageFormatType {
   static_assert(format == ImageFormat::IMAGE_RGB8 ||
                     format == ImageFormat::IMAGE_RGBA8 ||
                     format == ImageFormat::IMAGE_RGB32F ||
-                    format == ImageFormat::IMAGE_RGBA32F,
+                    format == ImageFormat::IMAGE_RGBA32F ||
+                    format == ImageFormat::IMAGE_BGR8 ||
+                    format == ImageFormat::IMAGE_BGRA8 ||
+                    format == ImageFormat::IMAGE_BGR32F ||
+                    format == ImageFormat::IMAGE_BGRA32F,
                 "invalid image format type - supported types are IMAGE_RGB8, "
-                "IMAGE_RGBA8, IMAGE_RGB32F, IMAGE_RGBA32F");
+                "IMAGE_RGBA8, IMAGE_RGB32F, IMAGE_RGBA32F, IMAGE_BGR8, "
+                "IMAGE_BGRA8, IMAGE_BGR32F, IMAGE_BGRA32F");
+};
+
+/**
+ * Channel offsets shared by the ImageFormatType specializations.
+ */
+template <size_t channel_count, size_t red_offset, size_t blue_offset>
+struct ImageChannelOrder {
+  static constexpr size_t channels = channel_count;
+  static constexpr size_t red = red_offset;
+  static constexpr size_t green = 1;
+  static constexpr size_t blue = blue_offset;
+};
+
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_RGB8>
+    : ImageChannelOrder<3, 0, 2> {
+  typedef uint8_t Base;
+  typedef uchar3 Vector;
+};
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_RGBA8>
+    : ImageChannelOrder<4, 0, 2> {
+  typedef uint8_t Base;
+  typedef uchar4 Vector;
+};
+
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_RGB32F>
+    : ImageChannelOrder<3, 0, 2> {
+  typedef float Base;
+  typedef float3 Vector;
+};
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_RGBA32F>
+    : ImageChannelOrder<4, 0, 2> {
+  typedef float Base;
+  typedef float4 Vector;
 };
 
-template <> struct ImageFormatType<ImageFormat::IMAGE_RGB8> {
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_BGR8>
+    : ImageChannelOrder<3, 2, 0> {
   typedef uint8_t Base;
   typedef uchar3 Vector;
 };
-template <> struct ImageFormatType<ImageFormat::IMAGE_RGBA8> {
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_BGRA8>
+    : ImageChannelOrder<4, 2, 0> {
   typedef uint8_t Base;
   typedef uchar4 Vector;
 };
 
-template <> struct ImageFormatType<ImageFormat::IMAGE_RGB32F> {
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_BGR32F>
+    : ImageChannelOrder<3, 2, 0> {
   typedef float Base;
   typedef float3 Vector;
 };
-template <> struct ImageFormatType<ImageFormat::IMAGE_RGBA32F> {
+template <>
+struct ImageFormatType<ImageFormat::IMAGE_BGRA32F>
+    : ImageChannelOrder<4, 2, 0> {
   typedef float Base;
   typedef float4 Vector;
 };
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "image-processing/color-convert/common/image-format.hpp"
+#include "image-processing/color-convert/common/mem-layout.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * @brief Get the number of bytes one pixel occupies in a row of an image.
+ *
+ * For the planar layout this is the size of one channel, since every channel
+ * lives in its own plane. YUV formats have a fixed arrangement of their planes
+ * and ignore the layout, this is the size of a luma sample (4:2:0) or of one
+ * pixel of the packed 4:2:2 row.
+ *
+ * @param format
+ * @param layout
+ * @return size_t
+ */
+static inline size_t image_format_pixel_size(ImageFormat format,
+                                             MemLayout layout) {
+  const size_t depth = image_format_depth(format);
+  if (layout == MemLayout::Planar && image_format_channels(format) > 1 &&
+      !image_format_is_yuv(format)) {
+    return depth / image_format_channels(format) / 8;
+  }
+  return depth / 8;
+}
+
+/**
+ * A non-owning view of an image: a pointer to the first pixel, the
+ * dimensions, the format, the memory layout and the distance in bytes between
+ * two rows (pitch) and between two planes (plane_pitch, planar layout only).
+ *
+ * Views of padded frames or of a region of interest (@see roi()) can be passed
+ * to the kernels directly, no copy into a tightly packed buffer is needed.
+ *
+ * For the 4:2:0 YUV formats (I420, YV12, NV12) pitch and plane_pitch describe
+ * the luma plane, the chroma plane(s) start plane_pitch bytes after data with
+ * half (I420, YV12) or the same (NV12) pitch, the second plane of I420 and
+ * YV12 right after the first. A region of interest of these formats records
+ * where its chroma starts in chroma and chroma_plane_pitch (@see
+ * chroma_plane()).
+ *
+ * ImageView refers to writable pixels, ConstImageView to read only ones. An
+ * ImageView converts to a ConstImageView implicitly.
+ */
+template <typename T> struct BasicImageView {
+  T *data = nullptr;
+  int width = 0;
+  int height = 0;
+  size_t pitch = 0;
+  size_t plane_pitch = 0;
+  ImageFormat format = ImageFormat::IMAGE_UNKNOWN;
+  MemLayout layout = MemLayout::Packed;
+
+  /**
+   * 4:2:0 YUV only: the first chroma sample of the view and the distance
+   * between the two chroma planes of I420 and YV12. Set by roi(), 0 for the
+   * default layout described above.
+   */
+  T *chroma = nullptr;
+  size_t chroma_plane_pitch = 0;
+
+  BasicImageView() = default;
+
+  /**
+   * @brief Create a view, pitch and plane_pitch default to a tightly packed
+   * image when 0.
+   */
+  BasicImageView(T *data, int width, int height, ImageFormat format,
+                 MemLayout layout = MemLayout::Packed, size_t pitch = 0,
+                 size_t plane_pitch = 0)
+      : data(data), width(width), height(height), pitch(pitch),
+        plane_pitch(plane_pitch), format(format), layout(layout) {
+    if (this->pitch == 0 && width > 0) {
+      this->pitch = width * image_format_pixel_size(format, layout);
+    }
+    if (this->plane_pitch == 0 && height > 0) {
+      this->plane_pitch = this->pitch * height;
+    }
+  }
+
+  template <typename U,
+            typename = std::enable_if_t<std::is_convertible<U *, T *>::value>>
+  BasicImageView(const BasicImageView<U> &other)
+      : data(other.data), width(other.width), height(other.height),
+        pitch(other.pitch), plane_pitch(other.plane_pitch),
+        format(other.format), layout(other.layout), chroma(other.chroma),
+        chroma_plane_pitch(other.chroma_plane_pitch) {}
+
+  /**
+   * @brief Get the first pixel of row y, in plane `plane` for planar images.
+   */
+  T *row(int y, int plane = 0) const {
+    return data + plane * plane_pitch + y * pitch;
+  }
+
+  /**
+   * @brief Get the pitch of the chroma plane(s) of a 4:2:0 YUV image.
+   */
+  size_t chroma_pitch() const {
+    return format == ImageFormat::IMAGE_NV12 ? pitch : pitch / 2;
+  }
+
+  /**
+   * @brief Get the first chroma row of a 4:2:0 YUV image: of U (plane 0) or V
+   * (plane 1) for I420, the other way round for YV12, of the interleaved UV
+   * samples (plane 0) for NV12.
+   */
+  T *chroma_plane(int plane) const {
+    T *first = chroma != nullptr ? chroma : data + plane_pitch;
+    const size_t distance = chroma_plane_pitch != 0
+                                ? chroma_plane_pitch
+                                : chroma_pitch() * (height / 2);
+    return first + plane * distance;
+  }
+
+  /**
+   * @brief Get a view of the width x height region starting at (x, y). The
+   * region shares pitch and plane_pitch with this view.
+   *
+   * A region of a 4:2:0 YUV image must start on an even column and row, it
+   * would split chroma samples otherwise; an empty view (data == nullptr) is
+   * returned then.
+   */
+  BasicImageView roi(int x, int y, int width, int height) const {
+    BasicImageView view = *this;
+    view.data = row(y) + x * image_format_pixel_size(format, layout);
+    view.width = width;
+    view.height = height;
+    if (image_format_is_yuv420(format)) {
+      if (x % 2 != 0 || y % 2 != 0) {
+        return BasicImageView();
+      }
+      const size_t chroma_step = format == ImageFormat::IMAGE_NV12 ? 2 : 1;
+      view.chroma =
+          chroma_plane(0) + y / 2 * chroma_pitch() + x / 2 * chroma_step;
+      view.chroma_plane_pitch = chroma_plane(1) - chroma_plane(0);
+    }
+    return view;
+  }
+};
+
+using ImageView = BasicImageView<unsigned char>;
+using ConstImageView = BasicImageView<const unsigned char>;
+
+/**
+ * @brief Check if two views arrange their pixels the same way. The layout of
+ * a single channel image makes no difference, it matches either layout.
+ */
+template <typename T, typename U>
+bool same_layout(const BasicImageView<T> &a, const BasicImageView<U> &b) {
+  return a.layout == b.layout || image_format_channels(a.format) == 1 ||
+         image_format_channels(b.format) == 1;
+}
+
+/**
+ * @brief Get the luma plane of a 4:2:0 YUV image (I420, YV12, NV12) as a
+ * GRAY8 view, without a copy.
+ *
+ * @return the GRAY8 view, or an empty view (data == nullptr) for formats whose
+ * luma samples are not a plane of their own (packed 4:2:2 formats).
+ */
+template <typename T>
+BasicImageView<T> luma_view(const BasicImageView<T> &view) {
+  switch (view.format) {
+  case ImageFormat::IMAGE_I420:
+  case ImageFormat::IMAGE_YV12:
+  case ImageFormat::IMAGE_NV12:
+    return BasicImageView<T>(view.data, view.width, view.height,
+                             ImageFormat::IMAGE_GRAY8, MemLayout::Packed,
+                             view.pitch);
+  default:
+    return BasicImageView<T>();
+  }
+}
+
+} // namespace color_convert
+} // namespace image_processing
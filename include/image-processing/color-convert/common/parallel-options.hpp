@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * How the kParallelCpu and kParallelSimdCpu kernels cut a frame into bands of
+ * rows for TBB.
+ */
+struct ParallelOptions {
+  /**
+   * Rows per band. 0 picks bands of about 16K pixels, small enough to balance
+   * the load and large enough that neighbouring bands rarely share a cache
+   * line. Kernels that read neighbouring rows may use larger bands.
+   */
+  int grain_rows = 0;
+
+  /**
+   * Schedule the bands with a tbb::affinity_partitioner that is kept across
+   * calls (one per calling thread): band n of the next frame runs on the core
+   * that converted band n of the last one. Otherwise, and for kernels called
+   * from within another parallel loop of the same thread (batches, pipeline
+   * stages), the bands are scheduled with the auto_partitioner.
+   */
+  bool affinity = true;
+};
+
+/**
+ * @brief Set the options used by every parallel kernel from now on.
+ */
+void set_parallel_options(const ParallelOptions &options);
+
+/**
+ * @brief Get the options used by the parallel kernels.
+ */
+ParallelOptions parallel_options();
+
+/**
+ * How the parallel kernels partitioned their work since the last reset.
+ */
+struct ParallelStats {
+  // parallel kernel calls
+  size_t calls = 0;
+  // bands of rows run as one task, TBB may split a call into fewer bands
+  // than its grain allows when threads are busy
+  size_t bands = 0;
+  size_t rows = 0;
+  // smallest and largest band, 0 before the first call
+  size_t min_band_rows = 0;
+  size_t max_band_rows = 0;
+};
+
+/**
+ * @brief Get the partition statistics of the parallel kernels.
+ */
+ParallelStats parallel_stats();
+
+/**
+ * @brief Reset the partition statistics.
+ */
+void reset_parallel_stats();
+
+} // namespace color_convert
+} // namespace image_processing
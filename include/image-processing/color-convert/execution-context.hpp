@@ -0,0 +1,94 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "image-processing/color-convert/color-convert.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+namespace detail {
+struct ExecutionContextState;
+} // namespace detail
+
+/**
+ * Options of an ExecutionContext.
+ */
+struct ExecutionContextOptions {
+  /**
+   * Threads working on a conversion, the calling thread included. 0 uses one
+   * thread per core (of the NUMA node, if one is set).
+   */
+  int max_threads = 0;
+
+  /**
+   * Pin every thread working in the context to these CPUs while it does (the
+   * calling thread gets its own mask back afterwards). Empty for no pinning.
+   * Only supported on Linux, ignored elsewhere.
+   */
+  std::vector<int> cpus;
+
+  /**
+   * Run on the cores of this NUMA node, -1 for any. Needs the TBB hwloc
+   * binding (tbbbind) at run time; a node TBB does not know is ignored.
+   */
+  int numa_node = -1;
+};
+
+/**
+ * A bounded, isolated set of threads for the parallel kernels.
+ *
+ * By default the kParallelCpu and kParallelSimdCpu kernels use every core of
+ * the machine through the global TBB scheduler. Conversions run in a context
+ * use its tbb::task_arena instead: at most max_threads threads, optionally
+ * pinned to cores or a NUMA node, and its tasks never mix with the work of
+ * other arenas. A service sharing the machine, or each of several pipelines,
+ * gets its own context and cannot oversubscribe the cores.
+ *
+ * @code
+ * ExecutionContextOptions options;
+ * options.max_threads = 2;
+ * options.cpus = {2, 3};
+ * ExecutionContext context(options);
+ * color_convert(input, output, AlgoType::kParallelSimdCpu, context);
+ * context.execute([&] { color_convert_batch(inputs, outputs, n, algo); });
+ * @endcode
+ */
+class ExecutionContext {
+public:
+  explicit ExecutionContext(
+      const ExecutionContextOptions &options = ExecutionContextOptions());
+  ~ExecutionContext();
+
+  ExecutionContext(const ExecutionContext &) = delete;
+  ExecutionContext &operator=(const ExecutionContext &) = delete;
+
+  /**
+   * @brief Get the number of threads the context runs work on.
+   */
+  int max_concurrency() const;
+
+  /**
+   * @brief Run work on the calling thread inside the context, every parallel
+   * kernel it calls uses the threads of the context. Blocks until work
+   * returns.
+   */
+  void execute(const std::function<void()> &work) const;
+
+private:
+  std::unique_ptr<detail::ExecutionContextState> state_;
+};
+
+/**
+ * @brief color_convert() with the parallel kernels running in context.
+ *
+ * With AlgoType::kAuto the algorithm is tuned for the thread count of the
+ * context.
+ */
+bool color_convert(const ConstImageView &input, const ImageView &output,
+                   const AlgoType &algo_type, const ExecutionContext &context);
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "image-processing/color-convert/color-convert.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * Options of color_convert_file().
+ */
+struct FileConvertOptions {
+  /**
+   * Input bytes converted per band of rows. Only the band being converted
+   * and the one read ahead are resident, so memory use stays around a few
+   * times this, whatever the file size.
+   */
+  size_t band_bytes = size_t(8) << 20;
+
+  /**
+   * Memory layout of the frames in both files.
+   */
+  MemLayout layout = MemLayout::Packed;
+};
+
+/**
+ * @brief Convert a raw file of tightly packed width x height frames to
+ * output_format, frame by frame, into output_path (created or truncated).
+ *
+ * Both files are memory mapped (POSIX only) and converted in bands of rows:
+ * the next input band is requested ahead with madvise(MADV_WILLNEED) and the
+ * pages of converted bands are dropped from the process again, the page cache
+ * writes the output back. Frames that cannot be cut into bands (Bayer, 4:2:0
+ * YUV, planar layout) are converted as one band each.
+ *
+ * @param input_path
+ * @param output_path
+ * @param width
+ * @param height
+ * @param input_format
+ * @param output_format
+ * @param algo_type
+ * @param options
+ * @return true on success, false if a file cannot be opened or mapped, the
+ * input size is not a positive multiple of the frame size or a conversion
+ * fails.
+ */
+bool color_convert_file(const char *input_path, const char *output_path,
+                        int width, int height, ImageFormat input_format,
+                        ImageFormat output_format, const AlgoType &algo_type,
+                        const FileConvertOptions &options =
+                            FileConvertOptions());
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+
+#include "image-processing/color-convert/color-convert.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+namespace detail {
+struct FrameReaderState;
+} // namespace detail
+
+/**
+ * Reads a raw sequence of tightly packed, equally sized frames (e.g. the
+ * output of scripts/generate-rgb.py concatenated) front to back.
+ *
+ * A reader thread of its own reads ahead into a small ring of buffers: while
+ * the caller works on frame n, frame n + 1 is read, so the disk latency is
+ * hidden as long as processing a frame takes longer than reading it. A
+ * trailing partial frame is ignored.
+ */
+class FrameReader {
+public:
+  FrameReader(const char *path, int width, int height, ImageFormat format,
+              MemLayout layout = MemLayout::Packed);
+  ~FrameReader();
+
+  FrameReader(const FrameReader &) = delete;
+  FrameReader &operator=(const FrameReader &) = delete;
+
+  /**
+   * @brief Check if the file could be opened.
+   */
+  explicit operator bool() const { return state_ != nullptr; }
+
+  /**
+   * @brief Get the number of complete frames in the file.
+   */
+  size_t frame_count() const;
+
+  /**
+   * @brief Get the next frame. The view stays valid until the next call.
+   *
+   * @return false at the end of the file or if reading failed
+   */
+  bool next(ConstImageView *frame);
+
+private:
+  std::unique_ptr<detail::FrameReaderState> state_;
+};
+
+/**
+ * Called with every converted frame, return false to stop.
+ */
+using SequenceFrameFunc =
+    std::function<bool(size_t index, const ConstImageView &frame)>;
+
+/**
+ * @brief Convert every frame of a raw sequence file (@see FrameReader) to
+ * output_format and pass it to consume. The converted frames share one
+ * output buffer, a frame is valid until consume returns.
+ *
+ * @return true if every frame was converted or consume stopped, false if the
+ * file cannot be read or a conversion failed.
+ */
+bool color_convert_sequence(const char *input_path, int width, int height,
+                            ImageFormat input_format,
+                            ImageFormat output_format,
+                            const AlgoType &algo_type,
+                            const SequenceFrameFunc &consume);
+
+} // namespace color_convert
+} // namespace image_processing
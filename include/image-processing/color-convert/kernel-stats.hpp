@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/common/image-format.hpp"
+#include "image-processing/color-convert/common/mem-layout.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+/**
+ * The entry point a kernel was called through.
+ */
+enum class KernelOperation {
+  kConvert,   /**< color_convert(), color_convert_batch() */
+  kDownscale, /**< color_convert_downscale() */
+  kNormalize, /**< color_convert_normalize() */
+  kLayout,    /**< color_convert_layout() */
+};
+
+/**
+ * Calls of one kernel variant, summed over every thread.
+ */
+struct KernelStats {
+  KernelOperation operation = KernelOperation::kConvert;
+  ImageFormat input_format = ImageFormat::IMAGE_UNKNOWN;
+  ImageFormat output_format = ImageFormat::IMAGE_UNKNOWN;
+
+  /**
+   * The algorithm that ran, never kAuto: calls with kAuto are counted under
+   * the algorithm it picked. The bands of a parallel color_convert_batch()
+   * are counted as calls of the serial kernel that converts each band, the
+   * images it does not cut as calls of the parallel kernel.
+   */
+  AlgoType algo_type = AlgoType::kNativeCpu;
+
+  MemLayout layout = MemLayout::Packed;
+
+  /**
+   * The SIMD variant for kSimdCpu and kParallelSimdCpu, kGeneric otherwise.
+   */
+  CpuIsa isa = CpuIsa::kGeneric;
+
+  /**
+   * Successful calls, failed ones are not counted.
+   */
+  uint64_t calls = 0;
+
+  /**
+   * Input pixels converted.
+   */
+  uint64_t pixels = 0;
+
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+};
+
+/**
+ * @brief Check if the library collects kernel statistics.
+ *
+ * Collecting is a build option (cmake -DKERNEL_STATS=ON). Without it the
+ * timing is compiled out of the kernel dispatch and kernel_stats() is always
+ * empty.
+ */
+bool kernel_stats_enabled();
+
+/**
+ * @brief Get the statistics of every kernel called since the last reset.
+ *
+ * Each thread counts its own calls without locks or shared cache lines; the
+ * query adds up the counts of all threads, including the ones that have
+ * exited. Calls running during the query may be partially counted.
+ */
+std::vector<KernelStats> kernel_stats();
+
+/**
+ * @brief Set every count to 0. Calls running during the reset may keep part
+ * of their count.
+ */
+void reset_kernel_stats();
+
+} // namespace color_convert
+} // namespace image_processing
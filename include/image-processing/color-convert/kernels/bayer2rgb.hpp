@@ -0,0 +1,19 @@
+#pragma once
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// bilinear demosaic, input is BAYER_BGGR, BAYER_GBRG, BAYER_GRBG or
+// BAYER_RGGB (at least 2x2), output RGB8, RGBA8, BGR8 or BGRA8
+bool bayer_2_rgb(const ConstImageView &input, const ImageView &output,
+                 AlgoType algo_type);
+
+} // namespace kernels
+} // namespace color_convert
+} // namespace image_processing
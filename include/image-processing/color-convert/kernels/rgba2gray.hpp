@@ -1,6 +1,7 @@
 #pragma once
 
 #include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
 #include "image-processing/color-convert/common/mem-layout.hpp"
 
 namespace image_processing {
@@ -12,6 +13,16 @@ namespace kernels {
 bool rgba_2_gray(const unsigned char *input, unsigned char *output, int width,
                 int height, AlgoType algo_type, MemLayout mem_layout);
 
+// the memory layout is taken from input
+bool rgba_2_gray(const ConstImageView &input, const ImageView &output,
+                 AlgoType algo_type);
+
+// converts and shrinks by factor (2 or 4) in one pass, @see
+// color_convert_downscale()
+bool rgba_2_gray_downscale(const ConstImageView &input,
+                           const ImageView &output, int factor,
+                           AlgoType algo_type);
+
 }
 } // namespace color_convert
 } // namespace image_processing
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// input is YUYV, YVYU, UYVY, I420, YV12 or NV12 (BT.601 limited range),
+// output RGB8, RGBA8, BGR8 or BGRA8
+bool yuv_2_rgb(const ConstImageView &input, const ImageView &output,
+               AlgoType algo_type);
+
+// copies the luma samples, for I420, YV12 and NV12 luma_view() gives the same
+// image without a copy
+bool yuv_2_gray(const ConstImageView &input, const ImageView &output,
+                AlgoType algo_type);
+
+} // namespace kernels
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <functional>
+#include <stddef.h>
+#include <vector>
+
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+
+namespace image_processing {
+namespace color_convert {
+
+class ExecutionContext;
+
+/**
+ * A frame travelling through a Pipeline.
+ */
+struct PipelineFrame {
+  /**
+   * Position of the frame in the stream, starting at 0.
+   */
+  size_t index = 0;
+
+  /**
+   * The image as read, replaced by the converted image in a conversion stage.
+   */
+  ImageBuffer image;
+};
+
+/**
+ * Options of a Pipeline.
+ */
+struct PipelineOptions {
+  /**
+   * At most this many frames are between the read and the write stage. When
+   * all of them are in flight, reading waits until a frame is written
+   * (backpressure), which also bounds the memory held by the frames.
+   */
+  size_t max_in_flight = 4;
+
+  /**
+   * Run the stages, and the parallel kernels they call, on the threads of
+   * this context instead of the shared TBB thread pool. nullptr for the
+   * shared pool. The context must outlive the pipeline.
+   */
+  const ExecutionContext *context = nullptr;
+};
+
+/**
+ * A read -> convert -> postprocess -> write pipeline over a stream of frames.
+ *
+ * The read and write stages run one frame at a time in stream order, every
+ * stage in between runs on several frames at once. So while frame n is
+ * written, frame n + 1 can be converted and frame n + 2 read. The stages run
+ * as tasks on the shared TBB thread pool, the same one the parallel kernels
+ * use, or on the threads of PipelineOptions::context.
+ *
+ * Frame buffers should come from pool(): the pipeline releases each frame
+ * after the write stage, and with max_in_flight frames at most a stream of
+ * equal frames stops allocating after the first ones.
+ *
+ * @code
+ * Pipeline pipeline;
+ * BufferPool &pool = pipeline.pool();
+ * pipeline
+ *     .read([&](PipelineFrame &frame) { return decode(frame, pool); })
+ *     .convert(ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu)
+ *     .then([](PipelineFrame &frame) { threshold(frame.image.view()); })
+ *     .write([&](PipelineFrame &frame) { encode(frame.image); });
+ * pipeline.run();
+ * @endcode
+ */
+class Pipeline {
+public:
+  /**
+   * Fills frame.image, returns false at the end of the stream.
+   */
+  using ReadStage = std::function<bool(PipelineFrame &frame)>;
+
+  using Stage = std::function<void(PipelineFrame &frame)>;
+
+  explicit Pipeline(const PipelineOptions &options = PipelineOptions());
+
+  // the stages refer to the pipeline's pool
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+
+  /**
+   * @brief Set the stage producing the frames, in stream order.
+   */
+  Pipeline &read(ReadStage stage);
+
+  /**
+   * @brief Append a stage converting frame.image to output_format with
+   * color_convert(). The output buffer comes from pool().
+   */
+  Pipeline &convert(ImageFormat output_format, AlgoType algo_type);
+
+  /**
+   * @brief Append a stage that may run on several frames at once.
+   */
+  Pipeline &then(Stage stage);
+
+  /**
+   * @brief Set the stage consuming the frames, in stream order.
+   */
+  Pipeline &write(Stage stage);
+
+  /**
+   * @brief Get the pool frame buffers should be acquired from.
+   */
+  BufferPool &pool() { return pool_; }
+
+  /**
+   * @brief Run the stream until the read stage returns false and every frame
+   * is written. Exceptions of a stage cancel the stream and are rethrown.
+   *
+   * @return true on success, false if no read stage is set or a conversion
+   * failed. A failed frame is not passed to later stages and no more frames
+   * are read, the frames already in flight are finished.
+   */
+  bool run();
+
+  /**
+   * @brief Get the number of frames written by the last run().
+   */
+  size_t frames() const { return frames_; }
+
+private:
+  PipelineOptions options_;
+  BufferPool pool_;
+  ReadStage read_;
+  std::vector<std::function<bool(PipelineFrame &frame)>> stages_;
+  Stage write_;
+  size_t frames_ = 0;
+};
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "image-processing/color-convert/common/algo-type.hpp"
+#include "image-processing/color-convert/common/image-view.hpp"
+#include "image-processing/color-convert/kernel-stats.hpp"
+#include <functional>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace detail {
+
+// autotune_algo_type() for any entry point: the results are kept and cached
+// per operation. run(algo_type) calls the operation on input and output with
+// algo_type and returns false if it has no kernel for it.
+AlgoType autotune_algo_type(KernelOperation operation,
+                            const ConstImageView &input,
+                            const ImageView &output,
+                            const std::function<bool(AlgoType)> &run);
+
+} // namespace detail
+
+} // namespace color_convert
+
+} // namespace image_processing
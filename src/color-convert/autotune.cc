@@ -0,0 +1,310 @@
+#include "image-processing/color-convert/autotune.hpp"
+#include "image-processing/color-convert/color-convert.hpp"
+#include "autotune-operation.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <tbb/task_arena.h>
+#include <tuple>
+#include <unistd.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+constexpr const char *kCacheEnv = "IMAGE_PROCESSING_AUTOTUNE_CACHE";
+constexpr const char *kCacheHeader = "# image-processing autotune cache v1";
+
+// every candidate runs this often, the fastest run counts
+constexpr int kTuneRuns = 3;
+
+const AlgoType kCandidates[] = {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                                AlgoType::kSimdCpu,
+                                AlgoType::kParallelSimdCpu};
+
+struct AutotuneKey {
+  KernelOperation operation;
+  ImageFormat input_format;
+  ImageFormat output_format;
+  MemLayout layout;
+  int bucket;
+  int threads;
+
+  bool operator<(const AutotuneKey &other) const {
+    return std::tie(operation, input_format, output_format, layout, bucket,
+                    threads) < std::tie(other.operation, other.input_format,
+                                        other.output_format, other.layout,
+                                        other.bucket, other.threads);
+  }
+};
+
+struct AutotuneState {
+  std::mutex mutex;
+  std::map<AutotuneKey, AlgoType> results;
+  std::string cache_file;
+  bool env_checked = false;
+};
+
+AutotuneState &autotune_state() {
+  static AutotuneState state;
+  return state;
+}
+
+// pixel count rounded up to a power of two, as its exponent
+int resolution_bucket(int width, int height) {
+  const size_t pixels = static_cast<size_t>(width) * height;
+  int bucket = 0;
+  while ((size_t(1) << bucket) < pixels) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+const char *layout_to_str(MemLayout layout) {
+  return layout == MemLayout::Planar ? "planar" : "packed";
+}
+
+// the name of an operation in the cache file, color_convert() has none
+const char *operation_to_str(KernelOperation operation) {
+  switch (operation) {
+  case KernelOperation::kDownscale:
+    return "downscale";
+  case KernelOperation::kNormalize:
+    return "normalize";
+  case KernelOperation::kLayout:
+    return "layout";
+  default:
+    return "";
+  }
+}
+
+bool operation_from_str(const std::string &str, KernelOperation *operation) {
+  for (KernelOperation candidate :
+       {KernelOperation::kDownscale, KernelOperation::kNormalize,
+        KernelOperation::kLayout}) {
+    if (str == operation_to_str(candidate)) {
+      *operation = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// One entry per line: the operation unless it is color_convert(), input
+// format, output format, layout, bucket, threads and the algorithm, e.g.
+// "rgb8 gray8 packed 21 8 parallel-simd" or
+// "downscale rgba8 gray8 packed 21 8 simd". Lines that do not parse are
+// skipped.
+bool load_cache(const std::string &path,
+                std::map<AutotuneKey, AlgoType> &results) {
+  std::ifstream file(path);
+  if (!file) {
+    struct stat st;
+    return stat(path.c_str(), &st) != 0;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    std::string input, output, layout, algo;
+    AutotuneKey key;
+    AlgoType algo_type;
+    if (line.empty() || line[0] == '#' || !(fields >> input)) {
+      continue;
+    }
+    key.operation = KernelOperation::kConvert;
+    if (operation_from_str(input, &key.operation)) {
+      fields >> input;
+    }
+    if (!(fields >> output >> layout >> key.bucket >> key.threads >> algo) ||
+        !algo_type_from_str(algo.c_str(), &algo_type) ||
+        std::find(std::begin(kCandidates), std::end(kCandidates),
+                  algo_type) == std::end(kCandidates)) {
+      continue;
+    }
+    key.input_format = image_format_from_str(input.c_str());
+    key.output_format = image_format_from_str(output.c_str());
+    key.layout = layout == "planar" ? MemLayout::Planar : MemLayout::Packed;
+    if (key.input_format != ImageFormat::IMAGE_UNKNOWN &&
+        key.output_format != ImageFormat::IMAGE_UNKNOWN) {
+      results[key] = algo_type;
+    }
+  }
+  return true;
+}
+
+// Merged with the entries other processes wrote since the file was loaded
+// and rewritten as a whole to a temporary file that is renamed into place, so
+// readers never see a partial file. The cache file itself is replaced, so the
+// writers take turns on a lock file next to it. results gets the merged
+// entries, its own win over the file's.
+void save_cache(const std::string &path,
+                std::map<AutotuneKey, AlgoType> &results) {
+  const int lock = open((path + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+  if (lock < 0) {
+    return;
+  }
+  if (flock(lock, LOCK_EX) != 0) {
+    close(lock);
+    return;
+  }
+
+  std::map<AutotuneKey, AlgoType> merged;
+  load_cache(path, merged);
+  for (const auto &entry : results) {
+    merged[entry.first] = entry.second;
+  }
+  results = merged;
+
+  std::string temp = path + ".XXXXXX";
+  const int fd = mkstemp(&temp[0]);
+  FILE *file = fd >= 0 ? fdopen(fd, "w") : nullptr;
+  if (file == nullptr) {
+    if (fd >= 0) {
+      close(fd);
+      unlink(temp.c_str());
+    }
+    close(lock);
+    return;
+  }
+  // mkstemp() creates the file readable by the owner only
+  bool written = fchmod(fd, 0644) == 0 &&
+                 fprintf(file, "%s\n", kCacheHeader) >= 0;
+  for (const auto &entry : results) {
+    const AutotuneKey &key = entry.first;
+    written = written &&
+              fprintf(file, "%s%s%s %s %s %d %d %s\n",
+                      operation_to_str(key.operation),
+                      key.operation == KernelOperation::kConvert ? "" : " ",
+                      image_format_to_str(key.input_format),
+                      image_format_to_str(key.output_format),
+                      layout_to_str(key.layout), key.bucket, key.threads,
+                      algo_type_to_str(entry.second)) >= 0;
+  }
+  written = fclose(file) == 0 && written;
+  if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+    unlink(temp.c_str());
+  }
+  close(lock);
+}
+
+void check_env(AutotuneState &state) {
+  if (state.env_checked) {
+    return;
+  }
+  state.env_checked = true;
+  const char *path = std::getenv(kCacheEnv);
+  if (path != nullptr && path[0] != '\0') {
+    state.cache_file = path;
+    load_cache(state.cache_file, state.results);
+  }
+}
+
+// the fastest candidate, kAuto if none has a kernel
+AlgoType tune(const std::function<bool(AlgoType)> &run) {
+  using clock = std::chrono::steady_clock;
+
+  AlgoType best = AlgoType::kAuto;
+  clock::duration best_time = clock::duration::max();
+  for (AlgoType algo_type : kCandidates) {
+    if (!run(algo_type)) {
+      continue;
+    }
+    // the run above warmed up caches and the thread pool
+    clock::duration time = clock::duration::max();
+    for (int i = 0; i < kTuneRuns; ++i) {
+      const auto start = clock::now();
+      run(algo_type);
+      time = std::min(time, clock::now() - start);
+    }
+    if (time < best_time) {
+      best = algo_type;
+      best_time = time;
+    }
+  }
+  return best;
+}
+
+} // namespace
+
+namespace detail {
+
+AlgoType autotune_algo_type(KernelOperation operation,
+                            const ConstImageView &input,
+                            const ImageView &output,
+                            const std::function<bool(AlgoType)> &run) {
+  const AutotuneKey key = {operation,
+                           input.format,
+                           output.format,
+                           input.layout,
+                           resolution_bucket(input.width, input.height),
+                           tbb::this_task_arena::max_concurrency()};
+  AutotuneState &state = autotune_state();
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    check_env(state);
+    const auto it = state.results.find(key);
+    if (it != state.results.end()) {
+      return it->second;
+    }
+  }
+
+  // measured without the lock, two threads may tune the same key at once
+  const AlgoType best = tune(run);
+  if (best == AlgoType::kAuto) {
+    return AlgoType::kNativeCpu;
+  }
+
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.results[key] = best;
+  if (!state.cache_file.empty()) {
+    save_cache(state.cache_file, state.results);
+  }
+  return best;
+}
+
+} // namespace detail
+
+AlgoType autotune_algo_type(const ConstImageView &input,
+                            const ImageView &output) {
+  return detail::autotune_algo_type(
+      KernelOperation::kConvert, input, output, [&](AlgoType algo_type) {
+        const ColorConvertFunc kernel = color_convert_kernel(
+            input.format, output.format, algo_type, input.layout);
+        return kernel != nullptr && kernel(input, output);
+      });
+}
+
+bool autotune_set_cache_file(const char *path) {
+  AutotuneState &state = autotune_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.env_checked = true;
+  state.cache_file = path != nullptr ? path : "";
+  if (state.cache_file.empty()) {
+    return true;
+  }
+  return load_cache(state.cache_file, state.results);
+}
+
+void autotune_clear() {
+  AutotuneState &state = autotune_state();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.results.clear();
+}
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,123 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "record-stats.hpp"
+#include "row-bands.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stddef.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+// Target size of one band of rows. A 640x480 frame is one band, a 4K frame
+// is cut into ~32 of them.
+constexpr size_t kBatchBandPixels = 1 << 18;
+
+struct BatchBand {
+  ColorConvertFunc kernel;
+  AlgoType algo_type;
+  ConstImageView input;
+  ImageView output;
+};
+
+// the single threaded kernel the parallel algorithms use for each band
+AlgoType band_algo_type(AlgoType algo_type) {
+  switch (algo_type) {
+  case AlgoType::kParallelCpu:
+    return AlgoType::kNativeCpu;
+  case AlgoType::kParallelSimdCpu:
+    return AlgoType::kSimdCpu;
+  default:
+    return algo_type;
+  }
+}
+
+bool valid_views(const ConstImageView &input, const ImageView &output) {
+  return input.data != nullptr && output.data != nullptr && input.width > 0 &&
+         input.height > 0 && input.width == output.width &&
+         input.height == output.height && same_layout(input, output);
+}
+
+} // namespace
+
+bool color_convert_batch(const ConstImageView *inputs,
+                         const ImageView *outputs, size_t count,
+                         const AlgoType &algo_type) {
+  if (count == 0) {
+    return true;
+  }
+  if (inputs == nullptr || outputs == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (!valid_views(inputs[i], outputs[i])) {
+      return false;
+    }
+  }
+
+  if (band_algo_type(algo_type) == algo_type) {
+    for (size_t i = 0; i < count; i++) {
+      if (!color_convert(inputs[i], outputs[i], algo_type)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const AlgoType band_algo = band_algo_type(algo_type);
+  std::vector<BatchBand> bands;
+  for (size_t i = 0; i < count; i++) {
+    const int width = inputs[i].width;
+    const int height = inputs[i].height;
+    // the other frames go whole to the parallel kernel, nested in this job
+    if (!detail::converts_in_bands(inputs[i].format, inputs[i].layout) ||
+        !detail::converts_in_bands(outputs[i].format, outputs[i].layout)) {
+      const ColorConvertFunc kernel =
+          color_convert_kernel(inputs[i].format, outputs[i].format, algo_type,
+                               inputs[i].layout);
+      if (kernel == nullptr) {
+        return false;
+      }
+      bands.push_back({kernel, algo_type, inputs[i], outputs[i]});
+      continue;
+    }
+
+    const ColorConvertFunc kernel =
+        color_convert_kernel(inputs[i].format, outputs[i].format, band_algo,
+                             inputs[i].layout);
+    if (kernel == nullptr) {
+      return false;
+    }
+    const int band_rows = static_cast<int>(
+        std::max<size_t>(1, kBatchBandPixels / static_cast<size_t>(width)));
+    for (int y = 0; y < height; y += band_rows) {
+      const int rows = std::min(band_rows, height - y);
+      bands.push_back({kernel, band_algo, inputs[i].roi(0, y, width, rows),
+                       outputs[i].roi(0, y, width, rows)});
+    }
+  }
+
+  std::atomic<bool> ok{true};
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, bands.size(), 1),
+                    [&](const tbb::blocked_range<size_t> &range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const BatchBand &band = bands[i];
+                        if (!detail::run_recorded(
+                                KernelOperation::kConvert, band.input,
+                                band.output.format, band.algo_type, [&band] {
+                                  return band.kernel(band.input, band.output);
+                                })) {
+                          ok.store(false, std::memory_order_relaxed);
+                        }
+                      }
+                    });
+  return ok.load(std::memory_order_relaxed);
+}
+
+} // namespace color_convert
+} // namespace image_processing
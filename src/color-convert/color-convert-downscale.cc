@@ -0,0 +1,113 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "autotune-operation.hpp"
+#include "kernels/cpu/gray-downscale.hpp"
+#include "record-stats.hpp"
+#include <stdexcept>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+using DownscaleFunc = bool (*)(const ConstImageView &input,
+                               const ImageView &output, int factor);
+
+struct DownscaleKernelEntry {
+  ImageFormat input_format;
+  AlgoType algo_type;
+  MemLayout mem_layout;
+  DownscaleFunc kernel;
+};
+
+// every fused kernel writes GRAY8, the few entries are searched linearly
+const DownscaleKernelEntry kDownscaleKernelEntries[] = {
+    // RGB8 -> GRAY8
+    {ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu, MemLayout::Packed,
+     kernels::rgb_packed_2_gray_downscale_native},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu, MemLayout::Planar,
+     kernels::rgb_planar_2_gray_downscale_native},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelCpu, MemLayout::Packed,
+     kernels::rgb_packed_2_gray_downscale_parallel},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelCpu, MemLayout::Planar,
+     kernels::rgb_planar_2_gray_downscale_parallel},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu, MemLayout::Packed,
+     kernels::rgb_packed_2_gray_downscale_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu, MemLayout::Planar,
+     kernels::rgb_planar_2_gray_downscale_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelSimdCpu, MemLayout::Packed,
+     kernels::rgb_packed_2_gray_downscale_parallel_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::rgb_planar_2_gray_downscale_parallel_simd},
+
+    // RGBA8 -> GRAY8
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kNativeCpu, MemLayout::Packed,
+     kernels::rgba_packed_2_gray_downscale_native},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kNativeCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_downscale_native},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelCpu, MemLayout::Packed,
+     kernels::rgba_packed_2_gray_downscale_parallel},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_downscale_parallel},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kSimdCpu, MemLayout::Packed,
+     kernels::rgba_packed_2_gray_downscale_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kSimdCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_downscale_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelSimdCpu, MemLayout::Packed,
+     kernels::rgba_packed_2_gray_downscale_parallel_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_downscale_parallel_simd},
+};
+
+DownscaleFunc downscale_kernel(ImageFormat input_format, AlgoType algo_type,
+                               MemLayout mem_layout) {
+  for (const auto &entry : kDownscaleKernelEntries) {
+    if (entry.input_format == input_format && entry.algo_type == algo_type &&
+        entry.mem_layout == mem_layout) {
+      return entry.kernel;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+bool color_convert_downscale(const ConstImageView &input,
+                             const ImageView &output, int factor,
+                             const AlgoType &algo_type) {
+  if (input.data == nullptr || output.data == nullptr ||
+      (factor != 2 && factor != 4) || output.width <= 0 ||
+      output.height <= 0 || output.width != input.width / factor ||
+      output.height != input.height / factor ||
+      output.format != ImageFormat::IMAGE_GRAY8) {
+    return false;
+  }
+
+#if !HAS_CUDA
+  if (algo_type == AlgoType::kCuda) {
+    throw std::runtime_error("Cuda not supported in this build.");
+  }
+#endif
+
+  const AlgoType resolved_algo_type =
+      algo_type == AlgoType::kAuto
+          ? detail::autotune_algo_type(
+                KernelOperation::kDownscale, input, output,
+                [&](AlgoType candidate) {
+                  const DownscaleFunc kernel =
+                      downscale_kernel(input.format, candidate, input.layout);
+                  return kernel != nullptr && kernel(input, output, factor);
+                })
+          : algo_type;
+  const DownscaleFunc kernel =
+      downscale_kernel(input.format, resolved_algo_type, input.layout);
+  if (kernel == nullptr) {
+    return false;
+  }
+  return detail::run_recorded(KernelOperation::kDownscale, input,
+                              output.format, resolved_algo_type,
+                              [&] { return kernel(input, output, factor); });
+}
+
+} // namespace color_convert
+} // namespace image_processing
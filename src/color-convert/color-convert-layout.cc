@@ -0,0 +1,72 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "autotune-operation.hpp"
+#include "kernels/cpu/transpose.hpp"
+#include "record-stats.hpp"
+#include <stdexcept>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+struct LayoutKernelEntry {
+  AlgoType algo_type;
+  ColorConvertFunc kernel;
+};
+
+// every kernel handles both directions and all 3 and 4 channel formats
+const LayoutKernelEntry kLayoutKernelEntries[] = {
+    {AlgoType::kNativeCpu, kernels::transpose_layout_native},
+    {AlgoType::kParallelCpu, kernels::transpose_layout_parallel},
+    {AlgoType::kSimdCpu, kernels::transpose_layout_simd},
+    {AlgoType::kParallelSimdCpu, kernels::transpose_layout_parallel_simd},
+};
+
+ColorConvertFunc layout_kernel(AlgoType algo_type) {
+  for (const auto &entry : kLayoutKernelEntries) {
+    if (entry.algo_type == algo_type) {
+      return entry.kernel;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+bool color_convert_layout(const ConstImageView &input,
+                          const ImageView &output,
+                          const AlgoType &algo_type) {
+  if (input.data == nullptr || output.data == nullptr || input.width <= 0 ||
+      input.height <= 0 || input.width != output.width ||
+      input.height != output.height || input.format != output.format ||
+      input.layout == output.layout) {
+    return false;
+  }
+
+#if !HAS_CUDA
+  if (algo_type == AlgoType::kCuda) {
+    throw std::runtime_error("Cuda not supported in this build.");
+  }
+#endif
+
+  const AlgoType resolved_algo_type =
+      algo_type == AlgoType::kAuto
+          ? detail::autotune_algo_type(
+                KernelOperation::kLayout, input, output,
+                [&](AlgoType candidate) {
+                  const ColorConvertFunc kernel = layout_kernel(candidate);
+                  return kernel != nullptr && kernel(input, output);
+                })
+          : algo_type;
+  const ColorConvertFunc kernel = layout_kernel(resolved_algo_type);
+  if (kernel == nullptr) {
+    return false;
+  }
+  return detail::run_recorded(KernelOperation::kLayout, input, output.format,
+                              resolved_algo_type,
+                              [&] { return kernel(input, output); });
+}
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,76 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "autotune-operation.hpp"
+#include "kernels/cpu/normalize.hpp"
+#include "record-stats.hpp"
+#include <stdexcept>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+using NormalizeFunc = bool (*)(const ConstImageView &input,
+                               const ImageView &output, float scale,
+                               float offset);
+
+struct NormalizeKernelEntry {
+  AlgoType algo_type;
+  NormalizeFunc kernel;
+};
+
+// every kernel handles all format pairs and both memory layouts
+const NormalizeKernelEntry kNormalizeKernelEntries[] = {
+    {AlgoType::kNativeCpu, kernels::normalize_native},
+    {AlgoType::kParallelCpu, kernels::normalize_parallel},
+    {AlgoType::kSimdCpu, kernels::normalize_simd},
+    {AlgoType::kParallelSimdCpu, kernels::normalize_parallel_simd},
+};
+
+NormalizeFunc normalize_kernel(AlgoType algo_type) {
+  for (const auto &entry : kNormalizeKernelEntries) {
+    if (entry.algo_type == algo_type) {
+      return entry.kernel;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+bool color_convert_normalize(const ConstImageView &input,
+                             const ImageView &output, float scale,
+                             float offset, const AlgoType &algo_type) {
+  if (input.data == nullptr || output.data == nullptr || input.width <= 0 ||
+      input.height <= 0 || input.width != output.width ||
+      input.height != output.height || !same_layout(input, output)) {
+    return false;
+  }
+
+#if !HAS_CUDA
+  if (algo_type == AlgoType::kCuda) {
+    throw std::runtime_error("Cuda not supported in this build.");
+  }
+#endif
+
+  const AlgoType resolved_algo_type =
+      algo_type == AlgoType::kAuto
+          ? detail::autotune_algo_type(
+                KernelOperation::kNormalize, input, output,
+                [&](AlgoType candidate) {
+                  const NormalizeFunc kernel = normalize_kernel(candidate);
+                  return kernel != nullptr &&
+                         kernel(input, output, scale, offset);
+                })
+          : algo_type;
+  const NormalizeFunc kernel = normalize_kernel(resolved_algo_type);
+  if (kernel == nullptr) {
+    return false;
+  }
+  return detail::run_recorded(
+      KernelOperation::kNormalize, input, output.format, resolved_algo_type,
+      [&] { return kernel(input, output, scale, offset); });
+}
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,408 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/autotune.hpp"
+#include "kernels/cpu/bayer2rgb.hpp"
+#include "kernels/cpu/float2gray.hpp"
+#include "kernels/cpu/normalize.hpp"
+#include "kernels/cpu/packed2gray.hpp"
+#include "kernels/cpu/reorder.hpp"
+#include "kernels/cpu/rgb2gray.hpp"
+#include "kernels/cpu/rgba2gray.hpp"
+#include "kernels/cpu/yuv2rgb.hpp"
+#include "kernels/cuda/rgb2gray.cuh"
+#include "kernels/cuda/rgba2gray.cuh"
+#include "record-stats.hpp"
+#include <array>
+#include <initializer_list>
+#include <stddef.h>
+#include <stdexcept>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+struct KernelEntry {
+  ImageFormat input_format;
+  ImageFormat output_format;
+  AlgoType algo_type;
+  MemLayout mem_layout;
+  ColorConvertFunc kernel;
+};
+
+// Every kernel the library provides. Adding a conversion only needs a new row
+// here, the lookup itself never changes. Packed RGB8/RGBA8 -> GRAY8 is
+// registered with the other channel orders below.
+const KernelEntry kKernelEntries[] = {
+    // RGB8 -> GRAY8
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu,
+     MemLayout::Planar, kernels::rgb_planar_2_gray_native},
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8, AlgoType::kParallelCpu,
+     MemLayout::Planar, kernels::rgb_planar_2_gray_parallel},
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu,
+     MemLayout::Planar, kernels::rgb_planar_2_gray_simd},
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8,
+     AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::rgb_planar_2_gray_parallel_simd},
+#if HAS_CUDA
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8, AlgoType::kCuda,
+     MemLayout::Packed, kernels::launch_rgb_packed_2_gray_cuda},
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8, AlgoType::kCuda,
+     MemLayout::Planar, kernels::launch_rgb_planar_2_gray_cuda},
+#endif
+
+    // RGBA8 -> GRAY8
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu,
+     MemLayout::Planar, kernels::rgba_planar_2_gray_native},
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8,
+     AlgoType::kParallelCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_parallel},
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu,
+     MemLayout::Planar, kernels::rgba_planar_2_gray_simd},
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8,
+     AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::rgba_planar_2_gray_parallel_simd},
+#if HAS_CUDA
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8, AlgoType::kCuda,
+     MemLayout::Packed, kernels::launch_rgba_packed_2_gray_cuda},
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8, AlgoType::kCuda,
+     MemLayout::Planar, kernels::launch_rgba_planar_2_gray_cuda},
+#endif
+
+    // RGB32F -> GRAY32F
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kNativeCpu, MemLayout::Packed,
+     kernels::float_2_gray_native},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kNativeCpu, MemLayout::Planar,
+     kernels::float_2_gray_native},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelCpu, MemLayout::Packed,
+     kernels::float_2_gray_parallel},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelCpu, MemLayout::Planar,
+     kernels::float_2_gray_parallel},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kSimdCpu, MemLayout::Packed,
+     kernels::float_2_gray_simd},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kSimdCpu, MemLayout::Planar,
+     kernels::float_2_gray_simd},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelSimdCpu, MemLayout::Packed,
+     kernels::float_2_gray_parallel_simd},
+    {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::float_2_gray_parallel_simd},
+
+    // RGBA32F -> GRAY32F
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kNativeCpu, MemLayout::Packed,
+     kernels::float_2_gray_native},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kNativeCpu, MemLayout::Planar,
+     kernels::float_2_gray_native},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelCpu, MemLayout::Packed,
+     kernels::float_2_gray_parallel},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelCpu, MemLayout::Planar,
+     kernels::float_2_gray_parallel},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kSimdCpu, MemLayout::Packed,
+     kernels::float_2_gray_simd},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kSimdCpu, MemLayout::Planar,
+     kernels::float_2_gray_simd},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelSimdCpu, MemLayout::Packed,
+     kernels::float_2_gray_parallel_simd},
+    {ImageFormat::IMAGE_RGBA32F, ImageFormat::IMAGE_GRAY32F,
+     AlgoType::kParallelSimdCpu, MemLayout::Planar,
+     kernels::float_2_gray_parallel_simd},
+};
+
+// The YUV, Bayer and packed RGB/BGR kernels take every input format of their
+// family (always MemLayout::Packed, the formats fix their own plane
+// arrangement), they are registered once per input format.
+struct FamilyKernelEntry {
+  ImageFormat output_format;
+  AlgoType algo_type;
+  ColorConvertFunc kernel;
+};
+
+const ImageFormat kYuvFormats[] = {
+    ImageFormat::IMAGE_YUYV, ImageFormat::IMAGE_YVYU, ImageFormat::IMAGE_UYVY,
+    ImageFormat::IMAGE_I420, ImageFormat::IMAGE_YV12, ImageFormat::IMAGE_NV12};
+
+const FamilyKernelEntry kYuvKernelEntries[] = {
+    {ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu, kernels::yuv_2_rgb_native},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelCpu,
+     kernels::yuv_2_rgb_parallel},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu, kernels::yuv_2_rgb_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelSimdCpu,
+     kernels::yuv_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kNativeCpu, kernels::yuv_2_rgb_native},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelCpu,
+     kernels::yuv_2_rgb_parallel},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kSimdCpu, kernels::yuv_2_rgb_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelSimdCpu,
+     kernels::yuv_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kNativeCpu, kernels::yuv_2_rgb_native},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelCpu,
+     kernels::yuv_2_rgb_parallel},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kSimdCpu, kernels::yuv_2_rgb_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelSimdCpu,
+     kernels::yuv_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kNativeCpu, kernels::yuv_2_rgb_native},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelCpu,
+     kernels::yuv_2_rgb_parallel},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kSimdCpu, kernels::yuv_2_rgb_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelSimdCpu,
+     kernels::yuv_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu,
+     kernels::yuv_2_gray_native},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kParallelCpu,
+     kernels::yuv_2_gray_parallel},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu, kernels::yuv_2_gray_simd},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kParallelSimdCpu,
+     kernels::yuv_2_gray_parallel_simd},
+};
+
+const ImageFormat kPackedRgbFormats[] = {
+    ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_BGR8,
+    ImageFormat::IMAGE_BGRA8};
+
+// the reorder kernels are registered for every output but the input format
+const FamilyKernelEntry kPackedRgbKernelEntries[] = {
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu,
+     kernels::packed_2_gray_native},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kParallelCpu,
+     kernels::packed_2_gray_parallel},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu, kernels::packed_2_gray_simd},
+    {ImageFormat::IMAGE_GRAY8, AlgoType::kParallelSimdCpu,
+     kernels::packed_2_gray_parallel_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu,
+     kernels::reorder_channels_native},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelCpu,
+     kernels::reorder_channels_parallel},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu,
+     kernels::reorder_channels_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelSimdCpu,
+     kernels::reorder_channels_parallel_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kNativeCpu,
+     kernels::reorder_channels_native},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelCpu,
+     kernels::reorder_channels_parallel},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kSimdCpu,
+     kernels::reorder_channels_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelSimdCpu,
+     kernels::reorder_channels_parallel_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kNativeCpu,
+     kernels::reorder_channels_native},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelCpu,
+     kernels::reorder_channels_parallel},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kSimdCpu,
+     kernels::reorder_channels_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelSimdCpu,
+     kernels::reorder_channels_parallel_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kNativeCpu,
+     kernels::reorder_channels_native},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelCpu,
+     kernels::reorder_channels_parallel},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kSimdCpu,
+     kernels::reorder_channels_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelSimdCpu,
+     kernels::reorder_channels_parallel_simd},
+};
+
+const ImageFormat kBayerFormats[] = {
+    ImageFormat::IMAGE_BAYER_BGGR, ImageFormat::IMAGE_BAYER_GBRG,
+    ImageFormat::IMAGE_BAYER_GRBG, ImageFormat::IMAGE_BAYER_RGGB};
+
+const FamilyKernelEntry kBayerKernelEntries[] = {
+    {ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu,
+     kernels::bayer_2_rgb_native},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelCpu,
+     kernels::bayer_2_rgb_parallel},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu, kernels::bayer_2_rgb_simd},
+    {ImageFormat::IMAGE_RGB8, AlgoType::kParallelSimdCpu,
+     kernels::bayer_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kNativeCpu,
+     kernels::bayer_2_rgb_native},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelCpu,
+     kernels::bayer_2_rgb_parallel},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kSimdCpu, kernels::bayer_2_rgb_simd},
+    {ImageFormat::IMAGE_RGBA8, AlgoType::kParallelSimdCpu,
+     kernels::bayer_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kNativeCpu,
+     kernels::bayer_2_rgb_native},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelCpu,
+     kernels::bayer_2_rgb_parallel},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kSimdCpu, kernels::bayer_2_rgb_simd},
+    {ImageFormat::IMAGE_BGR8, AlgoType::kParallelSimdCpu,
+     kernels::bayer_2_rgb_parallel_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kNativeCpu,
+     kernels::bayer_2_rgb_native},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelCpu,
+     kernels::bayer_2_rgb_parallel},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kSimdCpu, kernels::bayer_2_rgb_simd},
+    {ImageFormat::IMAGE_BGRA8, AlgoType::kParallelSimdCpu,
+     kernels::bayer_2_rgb_parallel_simd},
+};
+
+// uint8 <-> float with the default scaling, registered for both directions
+// of every pair and both memory layouts
+struct DepthFormatPair {
+  ImageFormat uint8_format;
+  ImageFormat float_format;
+};
+
+const DepthFormatPair kDepthFormatPairs[] = {
+    {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGB32F},
+    {ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_RGBA32F},
+    {ImageFormat::IMAGE_BGR8, ImageFormat::IMAGE_BGR32F},
+    {ImageFormat::IMAGE_BGRA8, ImageFormat::IMAGE_BGRA32F},
+    {ImageFormat::IMAGE_GRAY8, ImageFormat::IMAGE_GRAY32F}};
+
+struct AlgoKernelEntry {
+  AlgoType algo_type;
+  ColorConvertFunc kernel;
+};
+
+const AlgoKernelEntry kDepthKernelEntries[] = {
+    {AlgoType::kNativeCpu, kernels::convert_depth_native},
+    {AlgoType::kParallelCpu, kernels::convert_depth_parallel},
+    {AlgoType::kSimdCpu, kernels::convert_depth_simd},
+    {AlgoType::kParallelSimdCpu, kernels::convert_depth_parallel_simd}};
+
+constexpr size_t kFormatCount = static_cast<size_t>(ImageFormat::IMAGE_COUNT);
+constexpr size_t kAlgoTypeCount = static_cast<size_t>(AlgoType::kCuda) + 1;
+constexpr size_t kMemLayoutCount = static_cast<size_t>(MemLayout::Planar) + 1;
+constexpr size_t kKernelTableSize =
+    kFormatCount * kFormatCount * kAlgoTypeCount * kMemLayoutCount;
+
+// returns kKernelTableSize for combinations outside of the table
+size_t kernel_index(ImageFormat input_format, ImageFormat output_format,
+                    AlgoType algo_type, MemLayout mem_layout) {
+  const auto in = static_cast<size_t>(input_format);
+  const auto out = static_cast<size_t>(output_format);
+  const auto algo = static_cast<size_t>(algo_type);
+  const auto layout = static_cast<size_t>(mem_layout);
+  if (in >= kFormatCount || out >= kFormatCount || algo >= kAlgoTypeCount ||
+      layout >= kMemLayoutCount) {
+    return kKernelTableSize;
+  }
+  return ((in * kFormatCount + out) * kAlgoTypeCount + algo) *
+             kMemLayoutCount +
+         layout;
+}
+
+const std::array<ColorConvertFunc, kKernelTableSize> &kernel_table() {
+  static const auto table = [] {
+    std::array<ColorConvertFunc, kKernelTableSize> table{};
+    const auto add = [&table](ImageFormat input_format,
+                              ImageFormat output_format, AlgoType algo_type,
+                              MemLayout mem_layout, ColorConvertFunc kernel) {
+      const size_t index =
+          kernel_index(input_format, output_format, algo_type, mem_layout);
+      if (index != kKernelTableSize) {
+        table[index] = kernel;
+      }
+    };
+    for (const auto &entry : kKernelEntries) {
+      add(entry.input_format, entry.output_format, entry.algo_type,
+          entry.mem_layout, entry.kernel);
+    }
+    for (ImageFormat input_format : kYuvFormats) {
+      for (const auto &entry : kYuvKernelEntries) {
+        add(input_format, entry.output_format, entry.algo_type,
+            MemLayout::Packed, entry.kernel);
+      }
+    }
+    for (ImageFormat input_format : kPackedRgbFormats) {
+      for (const auto &entry : kPackedRgbKernelEntries) {
+        if (entry.output_format != input_format) {
+          add(input_format, entry.output_format, entry.algo_type,
+              MemLayout::Packed, entry.kernel);
+        }
+      }
+    }
+    for (ImageFormat input_format : kBayerFormats) {
+      for (const auto &entry : kBayerKernelEntries) {
+        add(input_format, entry.output_format, entry.algo_type,
+            MemLayout::Packed, entry.kernel);
+      }
+    }
+    for (const auto &pair : kDepthFormatPairs) {
+      for (const auto &entry : kDepthKernelEntries) {
+        for (MemLayout layout : {MemLayout::Packed, MemLayout::Planar}) {
+          add(pair.uint8_format, pair.float_format, entry.algo_type, layout,
+              entry.kernel);
+          add(pair.float_format, pair.uint8_format, entry.algo_type, layout,
+              entry.kernel);
+        }
+      }
+    }
+    return table;
+  }();
+  return table;
+}
+
+} // namespace
+
+ColorConvertFunc color_convert_kernel(const ImageFormat &input_format,
+                                      const ImageFormat &output_format,
+                                      const AlgoType &algo_type,
+                                      const MemLayout &mem_layout) {
+  const size_t index =
+      kernel_index(input_format, output_format, algo_type, mem_layout);
+  if (index == kKernelTableSize) {
+    return nullptr;
+  }
+  return kernel_table()[index];
+}
+
+bool color_convert(const unsigned char *input_buffer,
+                   unsigned char *output_buffer, int width, int height,
+                   const ImageFormat &input_format,
+                   const ImageFormat &output_format, const AlgoType &algo_type,
+                   const MemLayout &mem_layout) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  return color_convert(
+      ConstImageView(input_buffer, width, height, input_format, mem_layout),
+      ImageView(output_buffer, width, height, output_format, mem_layout),
+      algo_type);
+}
+
+bool color_convert(const ConstImageView &input, const ImageView &output,
+                   const AlgoType &algo_type) {
+  if (input.data == nullptr || output.data == nullptr || input.width <= 0 ||
+      input.height <= 0 || input.width != output.width ||
+      input.height != output.height || !same_layout(input, output)) {
+    return false;
+  }
+
+#if !HAS_CUDA
+  if (algo_type == AlgoType::kCuda) {
+    throw std::runtime_error("Cuda not supported in this build.");
+  }
+#endif
+
+  const AlgoType resolved_algo_type = algo_type == AlgoType::kAuto
+                                         ? autotune_algo_type(input, output)
+                                         : algo_type;
+  const ColorConvertFunc kernel = color_convert_kernel(
+      input.format, output.format, resolved_algo_type, input.layout);
+  if (kernel == nullptr) {
+    return false;
+  }
+  return detail::run_recorded(KernelOperation::kConvert, input, output.format,
+                              resolved_algo_type,
+                              [&] { return kernel(input, output); });
+}
+
+} // namespace color_convert
+} // namespace image_processing
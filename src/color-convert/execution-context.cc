@@ -0,0 +1,126 @@
+#include "image-processing/color-convert/execution-context.hpp"
+#include <algorithm>
+#include <tbb/info.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace detail {
+
+// Pins the threads entering the arena to a CPU set and gives them their
+// previous mask back when they leave, worker threads return to the global
+// pool and the calling thread to its own work.
+class PinningObserver : public tbb::task_scheduler_observer {
+public:
+  PinningObserver(tbb::task_arena &arena, const std::vector<int> &cpus)
+      : tbb::task_scheduler_observer(arena) {
+#ifdef __linux__
+    CPU_ZERO(&mask_);
+    for (int cpu : cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &mask_);
+      }
+    }
+#endif
+  }
+
+  void on_scheduler_entry(bool) override {
+#ifdef __linux__
+    saved().valid = sched_getaffinity(0, sizeof(cpu_set_t),
+                                      &saved().mask) == 0 &&
+                    sched_setaffinity(0, sizeof(cpu_set_t), &mask_) == 0;
+#endif
+  }
+
+  void on_scheduler_exit(bool) override {
+#ifdef __linux__
+    if (saved().valid) {
+      sched_setaffinity(0, sizeof(cpu_set_t), &saved().mask);
+      saved().valid = false;
+    }
+#endif
+  }
+
+private:
+#ifdef __linux__
+  struct SavedMask {
+    cpu_set_t mask;
+    bool valid = false;
+  };
+
+  static SavedMask &saved() {
+    thread_local SavedMask mask;
+    return mask;
+  }
+
+  cpu_set_t mask_;
+#endif
+};
+
+struct ExecutionContextState {
+  tbb::task_arena arena;
+  // declared after the arena, so it stops observing before the arena goes
+  std::unique_ptr<PinningObserver> observer;
+};
+
+} // namespace detail
+
+namespace {
+
+tbb::task_arena::constraints arena_constraints(
+    const ExecutionContextOptions &options) {
+  tbb::task_arena::constraints constraints;
+  if (options.numa_node >= 0) {
+    const std::vector<tbb::numa_node_id> nodes = tbb::info::numa_nodes();
+    if (std::find(nodes.begin(), nodes.end(), options.numa_node) !=
+        nodes.end()) {
+      constraints.numa_id = options.numa_node;
+    }
+  }
+  if (options.max_threads > 0) {
+    constraints.max_concurrency = options.max_threads;
+  }
+  return constraints;
+}
+
+} // namespace
+
+ExecutionContext::ExecutionContext(const ExecutionContextOptions &options)
+    : state_(std::make_unique<detail::ExecutionContextState>()) {
+  state_->arena.initialize(arena_constraints(options));
+  if (!options.cpus.empty()) {
+    state_->observer = std::make_unique<detail::PinningObserver>(
+        state_->arena, options.cpus);
+    state_->observer->observe(true);
+  }
+}
+
+ExecutionContext::~ExecutionContext() = default;
+
+int ExecutionContext::max_concurrency() const {
+  return state_->arena.max_concurrency();
+}
+
+void ExecutionContext::execute(const std::function<void()> &work) const {
+  state_->arena.execute(work);
+}
+
+bool color_convert(const ConstImageView &input, const ImageView &output,
+                   const AlgoType &algo_type,
+                   const ExecutionContext &context) {
+  bool converted = false;
+  // kAuto is resolved inside, so it is tuned for the arena's thread count
+  context.execute(
+      [&] { converted = color_convert(input, output, algo_type); });
+  return converted;
+}
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,179 @@
+#include "image-processing/color-convert/file-convert.hpp"
+#include "row-bands.hpp"
+#include <algorithm>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_MMAP 1
+#endif
+
+namespace image_processing {
+
+namespace color_convert {
+
+#if HAS_MMAP
+
+namespace {
+
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool open_input(const char *path) {
+    fd_ = open(path, O_RDONLY);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0 || st.st_size <= 0) {
+      return false;
+    }
+    return map(static_cast<size_t>(st.st_size), PROT_READ);
+  }
+
+  bool open_output(const char *path, size_t size) {
+    fd_ = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0 || ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      return false;
+    }
+    return map(size, PROT_READ | PROT_WRITE);
+  }
+
+  unsigned char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // asks the kernel to read [begin, end) ahead of its use
+  void will_need(size_t begin, size_t end) const {
+    begin = begin / page_size() * page_size();
+    end = std::min(end, size_);
+    if (end > begin) {
+      madvise(data_ + begin, end - begin, MADV_WILLNEED);
+    }
+  }
+
+  // Unmaps the whole pages before end that are not released yet. Input pages
+  // are clean and output pages of the shared mapping stay in the page cache
+  // until written back, so nothing is lost, only the resident size shrinks.
+  void release(size_t end) {
+    end = end / page_size() * page_size();
+    if (end > released_) {
+      madvise(data_ + released_, end - released_, MADV_DONTNEED);
+      released_ = end;
+    }
+  }
+
+private:
+  static size_t page_size() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+  }
+
+  bool map(size_t size, int protection) {
+    void *data = mmap(nullptr, size, protection, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<unsigned char *>(data);
+    size_ = size;
+    // one pass front to back, readahead can be aggressive
+    madvise(data_, size_, MADV_SEQUENTIAL);
+    return true;
+  }
+
+  int fd_ = -1;
+  unsigned char *data_ = nullptr;
+  size_t size_ = 0;
+  size_t released_ = 0;
+};
+
+} // namespace
+
+bool color_convert_file(const char *input_path, const char *output_path,
+                        int width, int height, ImageFormat input_format,
+                        ImageFormat output_format, const AlgoType &algo_type,
+                        const FileConvertOptions &options) {
+  if (input_path == nullptr || output_path == nullptr || width <= 0 ||
+      height <= 0) {
+    return false;
+  }
+  const size_t input_frame = image_format_size(input_format, width, height);
+  const size_t output_frame = image_format_size(output_format, width, height);
+  if (input_frame == 0 || output_frame == 0) {
+    return false;
+  }
+
+  MappedFile input;
+  if (!input.open_input(input_path) || input.size() % input_frame != 0) {
+    return false;
+  }
+  const size_t frames = input.size() / input_frame;
+  MappedFile output;
+  if (!output.open_output(output_path, frames * output_frame)) {
+    return false;
+  }
+
+  const bool banded =
+      detail::converts_in_bands(input_format, options.layout) &&
+      detail::converts_in_bands(output_format, options.layout);
+  const size_t input_pitch =
+      width * image_format_pixel_size(input_format, options.layout);
+  const int band_rows =
+      banded ? static_cast<int>(std::max<size_t>(
+                   1, std::min<size_t>(options.band_bytes / input_pitch,
+                                       height)))
+             : height;
+
+  for (size_t frame = 0; frame < frames; ++frame) {
+    const ConstImageView input_view(input.data() + frame * input_frame, width,
+                                    height, input_format, options.layout);
+    const ImageView output_view(output.data() + frame * output_frame, width,
+                                height, output_format, options.layout);
+
+    for (int y = 0; y < height; y += band_rows) {
+      const int rows = std::min(band_rows, height - y);
+      // the band after this one, possibly in the next frame
+      const size_t band_end = banded ? frame * input_frame +
+                                           (y + rows) * input_view.pitch
+                                     : (frame + 1) * input_frame;
+      input.will_need(band_end, band_end + rows * input_pitch);
+
+      const bool converted =
+          banded ? color_convert(input_view.roi(0, y, width, rows),
+                                 output_view.roi(0, y, width, rows),
+                                 algo_type)
+                 : color_convert(input_view, output_view, algo_type);
+      if (!converted) {
+        return false;
+      }
+
+      input.release(band_end);
+      output.release(banded ? frame * output_frame +
+                                  (y + rows) * output_view.pitch
+                            : (frame + 1) * output_frame);
+    }
+  }
+  return true;
+}
+
+#else
+
+bool color_convert_file(const char *, const char *, int, int, ImageFormat,
+                        ImageFormat, const AlgoType &,
+                        const FileConvertOptions &) {
+  return false;
+}
+
+#endif
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,169 @@
+#include "image-processing/color-convert/frame-reader.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace detail {
+
+// Frames read ahead of the one the caller holds. Deeper queues only help
+// when read times vary, every buffer adds a frame to the working set.
+constexpr size_t kReadAhead = 1;
+
+// One thread reads the frames in order into a ring of kReadAhead + 1
+// buffers. Frame n goes into buffers[n % size], the reader waits while the
+// ring is full: the frame the caller holds is never overwritten.
+struct FrameReaderState {
+  std::ifstream file;
+  size_t frame_size = 0;
+  size_t frame_count = 0;
+  ImageBuffer buffers[kReadAhead + 1];
+
+  std::mutex mutex;
+  // signalled by the reader when a frame is read or reading failed
+  std::condition_variable frame_read;
+  // signalled by the caller when it releases a buffer or stops the reader
+  std::condition_variable buffer_free;
+  // frames read, frames handed to the caller, frames the caller is done with
+  size_t read = 0;
+  size_t handed = 0;
+  size_t released = 0;
+  bool failed = false;
+  bool stop = false;
+  std::thread reader;
+
+  ~FrameReaderState() {
+    if (reader.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      buffer_free.notify_one();
+      reader.join();
+    }
+  }
+
+  void read_frames() {
+    for (size_t index = 0; index < frame_count; ++index) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        buffer_free.wait(lock, [this, index] {
+          return stop || index < released + kReadAhead + 1;
+        });
+        if (stop) {
+          return;
+        }
+      }
+      // frames are read in order, no seek is needed
+      const bool ok = static_cast<bool>(file.read(
+          reinterpret_cast<char *>(buffers[index % (kReadAhead + 1)].data()),
+          static_cast<std::streamsize>(frame_size)));
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) {
+          ++read;
+        } else {
+          failed = true;
+        }
+      }
+      frame_read.notify_one();
+      if (!ok) {
+        return;
+      }
+    }
+  }
+
+  // waits for the next frame, returns its buffer or nullptr on a read error
+  const ImageBuffer *next_frame() {
+    std::unique_lock<std::mutex> lock(mutex);
+    // the caller is done with every frame it got so far
+    released = handed;
+    buffer_free.notify_one();
+    frame_read.wait(lock, [this] { return read > handed || failed; });
+    if (read == handed) {
+      return nullptr;
+    }
+    return &buffers[handed++ % (kReadAhead + 1)];
+  }
+};
+
+} // namespace detail
+
+FrameReader::FrameReader(const char *path, int width, int height,
+                         ImageFormat format, MemLayout layout) {
+  if (path == nullptr || width <= 0 || height <= 0) {
+    return;
+  }
+  auto state = std::make_unique<detail::FrameReaderState>();
+  state->frame_size = image_format_size(format, width, height);
+  state->file.open(path, std::ios::binary | std::ios::ate);
+  if (state->frame_size == 0 || !state->file) {
+    return;
+  }
+  state->frame_count =
+      static_cast<size_t>(state->file.tellg()) / state->frame_size;
+  state->file.seekg(0);
+  for (ImageBuffer &buffer : state->buffers) {
+    buffer = ImageBuffer(width, height, format, layout);
+  }
+
+  if (state->frame_count > 0) {
+    state->reader =
+        std::thread(&detail::FrameReaderState::read_frames, state.get());
+  }
+  state_ = std::move(state);
+}
+
+FrameReader::~FrameReader() = default;
+
+size_t FrameReader::frame_count() const {
+  return state_ ? state_->frame_count : 0;
+}
+
+bool FrameReader::next(ConstImageView *frame) {
+  if (!state_ || frame == nullptr || state_->handed >= state_->frame_count) {
+    return false;
+  }
+  const ImageBuffer *buffer = state_->next_frame();
+  if (buffer == nullptr) {
+    return false;
+  }
+  *frame = buffer->view();
+  return true;
+}
+
+bool color_convert_sequence(const char *input_path, int width, int height,
+                            ImageFormat input_format,
+                            ImageFormat output_format,
+                            const AlgoType &algo_type,
+                            const SequenceFrameFunc &consume) {
+  FrameReader reader(input_path, width, height, input_format);
+  if (!reader) {
+    return false;
+  }
+  ImageBuffer output(width, height, output_format);
+  if (!output) {
+    return false;
+  }
+
+  ConstImageView frame;
+  for (size_t index = 0; index < reader.frame_count(); ++index) {
+    if (!reader.next(&frame) ||
+        !color_convert(frame, output.view(), algo_type)) {
+      return false;
+    }
+    if (!consume(index, output.view())) {
+      break;
+    }
+  }
+  return true;
+}
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,188 @@
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+size_t round_up(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Blocks that get huge pages are whole huge pages, aligned to one, so that
+// the kernel can back them without splitting. Every other block is rounded
+// to kImageBufferAlignment, which std::aligned_alloc requires.
+bool use_huge_pages(size_t size, bool huge_pages) {
+  return huge_pages && size >= kHugePageSize;
+}
+
+size_t block_capacity(size_t size, bool huge_pages) {
+  return round_up(size, use_huge_pages(size, huge_pages)
+                            ? kHugePageSize
+                            : kImageBufferAlignment);
+}
+
+unsigned char *allocate_block(size_t capacity, bool huge_pages) {
+  const bool huge = use_huge_pages(capacity, huge_pages);
+  void *block = std::aligned_alloc(
+      huge ? kHugePageSize : kImageBufferAlignment, capacity);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // only a hint, the block keeps 4 KiB pages if THP is disabled
+  if (huge) {
+    madvise(block, capacity, MADV_HUGEPAGE);
+  }
+#endif
+  return static_cast<unsigned char *>(block);
+}
+
+} // namespace
+
+namespace detail {
+
+struct BufferPoolState {
+  BufferPoolOptions options;
+  std::mutex mutex;
+  // released blocks by capacity
+  std::unordered_map<size_t, std::vector<unsigned char *>> blocks;
+  size_t cached_bytes = 0;
+
+  explicit BufferPoolState(const BufferPoolOptions &options)
+      : options(options) {}
+
+  ~BufferPoolState() { trim(); }
+
+  unsigned char *take(size_t capacity) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = blocks.find(capacity);
+      if (it != blocks.end() && !it->second.empty()) {
+        unsigned char *block = it->second.back();
+        it->second.pop_back();
+        cached_bytes -= capacity;
+        return block;
+      }
+    }
+    return allocate_block(capacity, options.huge_pages);
+  }
+
+  void recycle(unsigned char *block, size_t capacity) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (cached_bytes + capacity <= options.max_cached_bytes) {
+        blocks[capacity].push_back(block);
+        cached_bytes += capacity;
+        return;
+      }
+    }
+    std::free(block);
+  }
+
+  void trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &entry : blocks) {
+      for (unsigned char *block : entry.second) {
+        std::free(block);
+      }
+    }
+    blocks.clear();
+    cached_bytes = 0;
+  }
+};
+
+} // namespace detail
+
+ImageBuffer::ImageBuffer(int width, int height, ImageFormat format,
+                         MemLayout layout)
+    : width_(width), height_(height), format_(format), layout_(layout) {
+  if (width > 0 && height > 0) {
+    size_ = image_format_size(format, width, height);
+  }
+  if (size_ > 0) {
+    capacity_ = block_capacity(size_, false);
+    data_ = allocate_block(capacity_, false);
+  }
+}
+
+ImageBuffer::~ImageBuffer() { release(); }
+
+ImageBuffer::ImageBuffer(ImageBuffer &&other) noexcept {
+  *this = std::move(other);
+}
+
+ImageBuffer &ImageBuffer::operator=(ImageBuffer &&other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+    width_ = std::exchange(other.width_, 0);
+    height_ = std::exchange(other.height_, 0);
+    format_ = std::exchange(other.format_, ImageFormat::IMAGE_UNKNOWN);
+    layout_ = std::exchange(other.layout_, MemLayout::Packed);
+    pool_ = std::move(other.pool_);
+  }
+  return *this;
+}
+
+void ImageBuffer::release() {
+  if (data_ != nullptr) {
+    if (pool_) {
+      pool_->recycle(data_, capacity_);
+    } else {
+      std::free(data_);
+    }
+  }
+  data_ = nullptr;
+  pool_.reset();
+}
+
+BufferPool::BufferPool(const BufferPoolOptions &options)
+    : state_(std::make_shared<detail::BufferPoolState>(options)) {}
+
+ImageBuffer BufferPool::acquire(int width, int height, ImageFormat format,
+                                MemLayout layout) {
+  ImageBuffer buffer;
+  if (width <= 0 || height <= 0) {
+    return buffer;
+  }
+  const size_t size = image_format_size(format, width, height);
+  if (size == 0) {
+    return buffer;
+  }
+
+  buffer.capacity_ = block_capacity(size, state_->options.huge_pages);
+  buffer.data_ = state_->take(buffer.capacity_);
+  buffer.size_ = size;
+  buffer.width_ = width;
+  buffer.height_ = height;
+  buffer.format_ = format;
+  buffer.layout_ = layout;
+  buffer.pool_ = state_;
+  return buffer;
+}
+
+size_t BufferPool::cached_bytes() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->cached_bytes;
+}
+
+void BufferPool::trim() { state_->trim(); }
+
+} // namespace color_convert
+
+} // namespace image_processing
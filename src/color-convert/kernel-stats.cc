@@ -0,0 +1,236 @@
+#include "image-processing/color-convert/kernel-stats.hpp"
+#include "record-stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace image_processing {
+
+namespace color_convert {
+
+#ifdef IMAGE_PROCESSING_KERNEL_STATS
+
+namespace {
+
+// kernels per block of a thread's table, more blocks are added when full
+constexpr size_t kBlockSlots = 64;
+constexpr uint32_t kUsedKey = 1u << 31;
+
+// Written only by the owning thread (and by a reset), so the adds never
+// contend; the atomics let the query read them while the thread runs.
+struct StatsSlot {
+  std::atomic<uint32_t> key{0};
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> pixels{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::atomic<uint64_t> max_ns{0};
+};
+
+struct Totals {
+  uint64_t calls = 0;
+  uint64_t pixels = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+
+  void add(const StatsSlot &slot) {
+    calls += slot.calls.load(std::memory_order_relaxed);
+    pixels += slot.pixels.load(std::memory_order_relaxed);
+    total_ns += slot.total_ns.load(std::memory_order_relaxed);
+    max_ns = std::max(max_ns, slot.max_ns.load(std::memory_order_relaxed));
+  }
+};
+
+// Open addressing; a slot keeps its key until the thread exits, so a
+// reader never sees a key change under it.
+struct StatsBlock {
+  StatsSlot slots[kBlockSlots];
+  std::atomic<StatsBlock *> next{nullptr};
+
+  ~StatsBlock() { delete next.load(std::memory_order_relaxed); }
+};
+
+struct ThreadStats;
+
+struct StatsRegistry {
+  std::mutex mutex;
+  std::vector<ThreadStats *> threads;
+  // counts of the threads that have exited
+  std::map<uint32_t, Totals> retired;
+};
+
+// never destroyed, TBB workers may exit after the static destructors ran
+StatsRegistry &registry() {
+  static StatsRegistry *registry = new StatsRegistry;
+  return *registry;
+}
+
+struct ThreadStats {
+  StatsBlock blocks;
+
+  ThreadStats() {
+    StatsRegistry &stats = registry();
+    std::lock_guard<std::mutex> lock(stats.mutex);
+    stats.threads.push_back(this);
+  }
+
+  ~ThreadStats() {
+    StatsRegistry &stats = registry();
+    std::lock_guard<std::mutex> lock(stats.mutex);
+    for (const StatsBlock *block = &blocks; block != nullptr;
+         block = block->next.load(std::memory_order_relaxed)) {
+      for (const StatsSlot &slot : block->slots) {
+        const uint32_t key = slot.key.load(std::memory_order_relaxed);
+        if (key != 0) {
+          stats.retired[key].add(slot);
+        }
+      }
+    }
+    stats.threads.erase(
+        std::find(stats.threads.begin(), stats.threads.end(), this));
+  }
+
+  // only called by the owning thread
+  StatsSlot &find(uint32_t key) {
+    for (StatsBlock *block = &blocks;;) {
+      size_t index = (key * 2654435761u) % kBlockSlots;
+      for (size_t probe = 0; probe < kBlockSlots; ++probe) {
+        StatsSlot &slot = block->slots[index];
+        const uint32_t slot_key = slot.key.load(std::memory_order_relaxed);
+        if (slot_key == key) {
+          return slot;
+        }
+        if (slot_key == 0) {
+          slot.key.store(key, std::memory_order_release);
+          return slot;
+        }
+        index = (index + 1) % kBlockSlots;
+      }
+      StatsBlock *next = block->next.load(std::memory_order_relaxed);
+      if (next == nullptr) {
+        next = new StatsBlock;
+        block->next.store(next, std::memory_order_release);
+      }
+      block = next;
+    }
+  }
+};
+
+ThreadStats &thread_stats() {
+  thread_local ThreadStats stats;
+  return stats;
+}
+
+// Bits 0-7 input format, 8-15 output format, 16-19 algorithm, 20-21
+// layout, 22-25 ISA, 26-29 operation; bit 31 (kUsedKey) marks a used slot.
+// unpack_key() masks the same fields.
+uint32_t pack_key(KernelOperation operation, ImageFormat input_format,
+                  ImageFormat output_format, AlgoType algo_type,
+                  MemLayout layout, CpuIsa isa) {
+  return kUsedKey | static_cast<uint32_t>(input_format) |
+         static_cast<uint32_t>(output_format) << 8 |
+         static_cast<uint32_t>(algo_type) << 16 |
+         static_cast<uint32_t>(layout) << 20 |
+         static_cast<uint32_t>(isa) << 22 |
+         static_cast<uint32_t>(operation) << 26;
+}
+
+KernelStats unpack_key(uint32_t key) {
+  KernelStats stats;
+  stats.input_format = static_cast<ImageFormat>(key & 0xff);
+  stats.output_format = static_cast<ImageFormat>(key >> 8 & 0xff);
+  stats.algo_type = static_cast<AlgoType>(key >> 16 & 0xf);
+  stats.layout = static_cast<MemLayout>(key >> 20 & 0x3);
+  stats.isa = static_cast<CpuIsa>(key >> 22 & 0xf);
+  stats.operation = static_cast<KernelOperation>(key >> 26 & 0xf);
+  return stats;
+}
+
+} // namespace
+
+namespace detail {
+
+void record_kernel_call(KernelOperation operation, const ConstImageView &input,
+                        ImageFormat output_format, AlgoType algo_type,
+                        uint64_t nanoseconds) {
+  const bool simd = algo_type == AlgoType::kSimdCpu ||
+                    algo_type == AlgoType::kParallelSimdCpu;
+  StatsSlot &slot = thread_stats().find(
+      pack_key(operation, input.format, output_format, algo_type,
+               input.layout, simd ? cpu_isa() : CpuIsa::kGeneric));
+  slot.calls.fetch_add(1, std::memory_order_relaxed);
+  slot.pixels.fetch_add(static_cast<uint64_t>(input.width) * input.height,
+                        std::memory_order_relaxed);
+  slot.total_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+  uint64_t max = slot.max_ns.load(std::memory_order_relaxed);
+  while (nanoseconds > max &&
+         !slot.max_ns.compare_exchange_weak(max, nanoseconds,
+                                            std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace detail
+
+bool kernel_stats_enabled() { return true; }
+
+std::vector<KernelStats> kernel_stats() {
+  StatsRegistry &stats = registry();
+  std::lock_guard<std::mutex> lock(stats.mutex);
+  std::map<uint32_t, Totals> totals = stats.retired;
+  for (const ThreadStats *thread : stats.threads) {
+    for (const StatsBlock *block = &thread->blocks; block != nullptr;
+         block = block->next.load(std::memory_order_acquire)) {
+      for (const StatsSlot &slot : block->slots) {
+        const uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key != 0) {
+          totals[key].add(slot);
+        }
+      }
+    }
+  }
+
+  std::vector<KernelStats> result;
+  for (const auto &entry : totals) {
+    if (entry.second.calls == 0) {
+      continue;
+    }
+    KernelStats kernel = unpack_key(entry.first);
+    kernel.calls = entry.second.calls;
+    kernel.pixels = entry.second.pixels;
+    kernel.total_ns = entry.second.total_ns;
+    kernel.max_ns = entry.second.max_ns;
+    result.push_back(kernel);
+  }
+  return result;
+}
+
+void reset_kernel_stats() {
+  StatsRegistry &stats = registry();
+  std::lock_guard<std::mutex> lock(stats.mutex);
+  stats.retired.clear();
+  for (ThreadStats *thread : stats.threads) {
+    for (StatsBlock *block = &thread->blocks; block != nullptr;
+         block = block->next.load(std::memory_order_acquire)) {
+      for (StatsSlot &slot : block->slots) {
+        slot.calls.store(0, std::memory_order_relaxed);
+        slot.pixels.store(0, std::memory_order_relaxed);
+        slot.total_ns.store(0, std::memory_order_relaxed);
+        slot.max_ns.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+#else
+
+bool kernel_stats_enabled() { return false; }
+
+std::vector<KernelStats> kernel_stats() { return {}; }
+
+void reset_kernel_stats() {}
+
+#endif
+
+} // namespace color_convert
+
+} // namespace image_processing
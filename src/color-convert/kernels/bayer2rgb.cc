@@ -0,0 +1,18 @@
+#include "image-processing/color-convert/kernels/bayer2rgb.hpp"
+#include "image-processing/color-convert/color-convert.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+bool bayer_2_rgb(const ConstImageView &input, const ImageView &output,
+                 AlgoType algo_type) {
+  if (!image_format_is_bayer(input.format)) {
+    return false;
+  }
+  return color_convert(input, output, algo_type);
+}
+} // namespace kernels
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,268 @@
+#include "bayer-simd.hpp"
+#include "simd-dispatch.hpp"
+#include <stdint.h>
+#include <utility>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+template <bool bgr>
+void bayer_2_rgba_scalar(const unsigned char *above, const unsigned char *row,
+                         const unsigned char *below, unsigned char *output,
+                         size_t count, bool red_row, bool first_green) {
+  for (size_t i = 0; i < count; ++i) {
+    const ptrdiff_t x = static_cast<ptrdiff_t>(i);
+    unsigned char *pixel = output + 4 * i;
+    bayer_2_rgb_bilinear(above, row, below, x, x - 1, x + 1,
+                         (i & 1) == (first_green ? 0u : 1u), red_row,
+                         &pixel[bgr ? 2 : 0], &pixel[1], &pixel[bgr ? 0 : 2]);
+    pixel[3] = 255;
+  }
+}
+
+const BayerSimdKernels kGenericKernels = {bayer_2_rgba_scalar<false>,
+                                          bayer_2_rgba_scalar<true>};
+
+// Every vector step computes all interpolations for all of its pixels and
+// blends them with a mask of the green positions. The steps are even, so the
+// mask is the same for the whole row and the scalar tail keeps the parity.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// ---------------------------------------------------------------- SSE4.1
+
+TARGET_SSE41 inline __m128i load_sse41(const unsigned char *src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+}
+
+// (a + b + c + d + 2) >> 2 of 16 pixels
+TARGET_SSE41 inline __m128i mean4_sse41(__m128i a, __m128i b, __m128i c,
+                                        __m128i d) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i round = _mm_set1_epi16(2);
+  __m128i lo = _mm_add_epi16(
+      _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+      _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+  __m128i hi = _mm_add_epi16(
+      _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+      _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+  return _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, round), 2),
+                          _mm_srli_epi16(_mm_add_epi16(hi, round), 2));
+}
+
+template <bool bgr>
+TARGET_SSE41 void bayer_2_rgba_sse41(const unsigned char *above,
+                                     const unsigned char *row,
+                                     const unsigned char *below,
+                                     unsigned char *output, size_t count,
+                                     bool red_row, bool first_green) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i green =
+      _mm_set1_epi16(first_green ? 0x00FF : static_cast<short>(0xFF00));
+  const __m128i alpha = _mm_set1_epi8(-1);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const size_t x = step * i;
+    const __m128i center = load_sse41(row + x);
+    const __m128i west = load_sse41(row + x - 1);
+    const __m128i east = load_sse41(row + x + 1);
+    const __m128i north = load_sse41(above + x);
+    const __m128i south = load_sse41(below + x);
+
+    const __m128i cross = mean4_sse41(north, south, west, east);
+    const __m128i diagonal =
+        mean4_sse41(load_sse41(above + x - 1), load_sse41(above + x + 1),
+                    load_sse41(below + x - 1), load_sse41(below + x + 1));
+    // the color sampled in this row and the one sampled above and below
+    __m128i own = _mm_blendv_epi8(center, _mm_avg_epu8(west, east), green);
+    __m128i other =
+        _mm_blendv_epi8(diagonal, _mm_avg_epu8(north, south), green);
+    __m128i g = _mm_blendv_epi8(cross, center, green);
+    __m128i r = red_row ? own : other;
+    __m128i b = red_row ? other : own;
+    if (bgr) {
+      std::swap(r, b);
+    }
+
+    __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+    __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+    __m128i ba_lo = _mm_unpacklo_epi8(b, alpha);
+    __m128i ba_hi = _mm_unpackhi_epi8(b, alpha);
+    __m128i *dst = reinterpret_cast<__m128i *>(output + 4 * x);
+    _mm_storeu_si128(dst, _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+  }
+
+  bayer_2_rgba_scalar<bgr>(above + step * tile, row + step * tile,
+                           below + step * tile, output + 4 * step * tile,
+                           count - step * tile, red_row, first_green);
+}
+
+const BayerSimdKernels kSse41Kernels = {bayer_2_rgba_sse41<false>,
+                                        bayer_2_rgba_sse41<true>};
+
+// ------------------------------------------------------------------ AVX2
+
+TARGET_AVX2 inline __m256i load_avx2(const unsigned char *src) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+}
+
+// (a + b + c + d + 2) >> 2 of 32 pixels, the per lane unpacks and packs keep
+// the pixel order
+TARGET_AVX2 inline __m256i mean4_avx2(__m256i a, __m256i b, __m256i c,
+                                      __m256i d) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i round = _mm256_set1_epi16(2);
+  __m256i lo = _mm256_add_epi16(
+      _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero),
+                       _mm256_unpacklo_epi8(b, zero)),
+      _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero),
+                       _mm256_unpacklo_epi8(d, zero)));
+  __m256i hi = _mm256_add_epi16(
+      _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero),
+                       _mm256_unpackhi_epi8(b, zero)),
+      _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero),
+                       _mm256_unpackhi_epi8(d, zero)));
+  return _mm256_packus_epi16(
+      _mm256_srli_epi16(_mm256_add_epi16(lo, round), 2),
+      _mm256_srli_epi16(_mm256_add_epi16(hi, round), 2));
+}
+
+template <bool bgr>
+TARGET_AVX2 void bayer_2_rgba_avx2(const unsigned char *above,
+                                   const unsigned char *row,
+                                   const unsigned char *below,
+                                   unsigned char *output, size_t count,
+                                   bool red_row, bool first_green) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+  const __m256i green =
+      _mm256_set1_epi16(first_green ? 0x00FF : static_cast<short>(0xFF00));
+  const __m256i alpha = _mm256_set1_epi8(-1);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const size_t x = step * i;
+    const __m256i center = load_avx2(row + x);
+    const __m256i west = load_avx2(row + x - 1);
+    const __m256i east = load_avx2(row + x + 1);
+    const __m256i north = load_avx2(above + x);
+    const __m256i south = load_avx2(below + x);
+
+    const __m256i cross = mean4_avx2(north, south, west, east);
+    const __m256i diagonal =
+        mean4_avx2(load_avx2(above + x - 1), load_avx2(above + x + 1),
+                   load_avx2(below + x - 1), load_avx2(below + x + 1));
+    __m256i own =
+        _mm256_blendv_epi8(center, _mm256_avg_epu8(west, east), green);
+    __m256i other =
+        _mm256_blendv_epi8(diagonal, _mm256_avg_epu8(north, south), green);
+    __m256i g = _mm256_blendv_epi8(cross, center, green);
+    __m256i r = red_row ? own : other;
+    __m256i b = red_row ? other : own;
+    if (bgr) {
+      std::swap(r, b);
+    }
+
+    __m256i rg_lo = _mm256_unpacklo_epi8(r, g);
+    __m256i rg_hi = _mm256_unpackhi_epi8(r, g);
+    __m256i ba_lo = _mm256_unpacklo_epi8(b, alpha);
+    __m256i ba_hi = _mm256_unpackhi_epi8(b, alpha);
+    __m256i p0 = _mm256_unpacklo_epi16(rg_lo, ba_lo); // 0..3, 16..19
+    __m256i p1 = _mm256_unpackhi_epi16(rg_lo, ba_lo); // 4..7, 20..23
+    __m256i p2 = _mm256_unpacklo_epi16(rg_hi, ba_hi); // 8..11, 24..27
+    __m256i p3 = _mm256_unpackhi_epi16(rg_hi, ba_hi); // 12..15, 28..31
+
+    __m256i *dst = reinterpret_cast<__m256i *>(output + 4 * x);
+    _mm256_storeu_si256(dst, _mm256_permute2x128_si256(p0, p1, 0x20));
+    _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+    _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+    _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+  }
+
+  bayer_2_rgba_scalar<bgr>(above + step * tile, row + step * tile,
+                           below + step * tile, output + 4 * step * tile,
+                           count - step * tile, red_row, first_green);
+}
+
+const BayerSimdKernels kAvx2Kernels = {bayer_2_rgba_avx2<false>,
+                                       bayer_2_rgba_avx2<true>};
+
+#elif defined(__ARM_NEON__)
+
+// (a + b + c + d + 2) >> 2 of 16 pixels
+inline uint8x16_t mean4_neon(uint8x16_t a, uint8x16_t b, uint8x16_t c,
+                             uint8x16_t d) {
+  uint16x8_t lo = vaddq_u16(vaddl_u8(vget_low_u8(a), vget_low_u8(b)),
+                            vaddl_u8(vget_low_u8(c), vget_low_u8(d)));
+  uint16x8_t hi = vaddq_u16(vaddl_u8(vget_high_u8(a), vget_high_u8(b)),
+                            vaddl_u8(vget_high_u8(c), vget_high_u8(d)));
+  return vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2));
+}
+
+template <bool bgr>
+void bayer_2_rgba_neon(const unsigned char *above, const unsigned char *row,
+                       const unsigned char *below, unsigned char *output,
+                       size_t count, bool red_row, bool first_green) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const uint8x16_t green = vreinterpretq_u8_u16(
+      vdupq_n_u16(first_green ? 0x00FF : 0xFF00));
+
+  for (size_t i = 0; i < tile; ++i) {
+    const size_t x = step * i;
+    const uint8x16_t center = vld1q_u8(row + x);
+    const uint8x16_t west = vld1q_u8(row + x - 1);
+    const uint8x16_t east = vld1q_u8(row + x + 1);
+    const uint8x16_t north = vld1q_u8(above + x);
+    const uint8x16_t south = vld1q_u8(below + x);
+
+    const uint8x16_t cross = mean4_neon(north, south, west, east);
+    const uint8x16_t diagonal =
+        mean4_neon(vld1q_u8(above + x - 1), vld1q_u8(above + x + 1),
+                   vld1q_u8(below + x - 1), vld1q_u8(below + x + 1));
+    uint8x16_t own = vbslq_u8(green, vrhaddq_u8(west, east), center);
+    uint8x16_t other = vbslq_u8(green, vrhaddq_u8(north, south), diagonal);
+
+    uint8x16x4_t pixels;
+    pixels.val[bgr ? 2 : 0] = red_row ? own : other;
+    pixels.val[1] = vbslq_u8(green, center, cross);
+    pixels.val[bgr ? 0 : 2] = red_row ? other : own;
+    pixels.val[3] = vdupq_n_u8(255);
+    vst4q_u8(output + 4 * x, pixels);
+  }
+
+  bayer_2_rgba_scalar<bgr>(above + step * tile, row + step * tile,
+                           below + step * tile, output + 4 * step * tile,
+                           count - step * tile, red_row, first_green);
+}
+
+const BayerSimdKernels kNeonKernels = {bayer_2_rgba_neon<false>,
+                                       bayer_2_rgba_neon<true>};
+
+#endif
+
+} // namespace
+
+const BayerSimdKernels &bayer_simd_kernels() {
+  return select_simd_kernels(
+      kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+      X86_SIMD_KERNELS(kAvx2Kernels), nullptr, NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
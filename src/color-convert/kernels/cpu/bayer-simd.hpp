@@ -0,0 +1,69 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// Bilinear demosaic of pixel x of row, left and right are the indices of its
+// horizontal neighbours. red_row tells whether the row holds red or blue
+// samples next to green.
+//
+// At a green pixel the missing colors are the rounded means of the two
+// horizontal and the two vertical neighbours, at a red/blue pixel green is
+// the mean of the 4 direct and the opposite color the mean of the 4 diagonal
+// neighbours.
+inline void bayer_2_rgb_bilinear(const unsigned char *above,
+                                 const unsigned char *row,
+                                 const unsigned char *below, ptrdiff_t x,
+                                 ptrdiff_t left, ptrdiff_t right, bool green,
+                                 bool red_row, unsigned char *r,
+                                 unsigned char *g, unsigned char *b) {
+  unsigned char own, other;
+  if (green) {
+    *g = row[x];
+    own = static_cast<unsigned char>((row[left] + row[right] + 1) >> 1);
+    other = static_cast<unsigned char>((above[x] + below[x] + 1) >> 1);
+  } else {
+    *g = static_cast<unsigned char>(
+        (above[x] + below[x] + row[left] + row[right] + 2) >> 2);
+    own = row[x];
+    other = static_cast<unsigned char>((above[left] + above[right] +
+                                        below[left] + below[right] + 2) >>
+                                       2);
+  }
+  *r = red_row ? own : other;
+  *b = red_row ? other : own;
+}
+
+// Bilinear demosaic of count pixels of row to 4 channel pixels with an
+// opaque alpha. above, row and below are padded by one pixel on both sides
+// (row[-1] and row[count] are valid), first_green tells whether pixel 0 is
+// green.
+using BayerRowFunc = void (*)(const unsigned char *above,
+                              const unsigned char *row,
+                              const unsigned char *below,
+                              unsigned char *output, size_t count,
+                              bool red_row, bool first_green);
+
+struct BayerSimdKernels {
+  BayerRowFunc bayer_2_rgba;
+  BayerRowFunc bayer_2_bgra;
+};
+
+// the variant selected by cpu_isa()
+const BayerSimdKernels &bayer_simd_kernels();
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
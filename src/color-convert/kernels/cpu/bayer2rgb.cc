@@ -0,0 +1,224 @@
+#include "bayer2rgb.hpp"
+#include "bayer-simd.hpp"
+#include "yuv-simd.hpp"
+#include "parallel-rows.hpp"
+#include <cstring>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+// rows per parallel tile, every tile reads one extra row above and below
+constexpr int kBayerTileRows = 16;
+
+bool valid_bayer_input(const ConstImageView &input) {
+  return image_format_is_bayer(input.format) && input.width >= 2 &&
+         input.height >= 2;
+}
+
+bool valid_rgb_output(const ImageView &output) {
+  return output.format == ImageFormat::IMAGE_RGB8 ||
+         output.format == ImageFormat::IMAGE_RGBA8 ||
+         output.format == ImageFormat::IMAGE_BGR8 ||
+         output.format == ImageFormat::IMAGE_BGRA8;
+}
+
+// The colors of row y: whether it holds red (or blue) samples next to green
+// and whether its first pixel is green.
+struct BayerPhase {
+  bool red_row;
+  bool first_green;
+};
+
+BayerPhase bayer_phase(ImageFormat format, int y) {
+  BayerPhase phase;
+  switch (format) {
+  case ImageFormat::IMAGE_BAYER_RGGB:
+    phase = {true, false};
+    break;
+  case ImageFormat::IMAGE_BAYER_GRBG:
+    phase = {true, true};
+    break;
+  case ImageFormat::IMAGE_BAYER_GBRG:
+    phase = {false, true};
+    break;
+  default: // IMAGE_BAYER_BGGR
+    phase = {false, false};
+  }
+  if (y % 2 == 1) {
+    phase.red_row = !phase.red_row;
+    phase.first_green = !phase.first_green;
+  }
+  return phase;
+}
+
+// mirrors an index outside of [0, size) back in, -1 -> 1, size -> size - 2
+int mirror(int index, int size) {
+  if (index < 0) {
+    return -index;
+  }
+  return index >= size ? 2 * size - 2 - index : index;
+}
+
+template <size_t channels, bool bgr>
+void bayer_row_2_rgb_native(const ConstImageView &input, unsigned char *output,
+                            int y) {
+  const int width = input.width;
+  const unsigned char *above = input.row(mirror(y - 1, input.height));
+  const unsigned char *row = input.row(y);
+  const unsigned char *below = input.row(mirror(y + 1, input.height));
+  const BayerPhase phase = bayer_phase(input.format, y);
+
+  for (int x = 0; x < width; ++x) {
+    unsigned char *pixel = output + channels * x;
+    detail::bayer_2_rgb_bilinear(above, row, below, x, mirror(x - 1, width),
+                                 mirror(x + 1, width),
+                                 (x % 2 == 0) == phase.first_green,
+                                 phase.red_row, &pixel[bgr ? 2 : 0], &pixel[1],
+                                 &pixel[bgr ? 0 : 2]);
+    if (channels == 4) {
+      pixel[3] = 255;
+    }
+  }
+}
+
+using BayerRowNativeFunc = void (*)(const ConstImageView &input,
+                                    unsigned char *output, int y);
+
+BayerRowNativeFunc bayer_row_native_func(ImageFormat output_format) {
+  switch (output_format) {
+  case ImageFormat::IMAGE_RGB8:
+    return bayer_row_2_rgb_native<3, false>;
+  case ImageFormat::IMAGE_RGBA8:
+    return bayer_row_2_rgb_native<4, false>;
+  case ImageFormat::IMAGE_BGR8:
+    return bayer_row_2_rgb_native<3, true>;
+  default: // IMAGE_BGRA8
+    return bayer_row_2_rgb_native<4, true>;
+  }
+}
+
+// 3 mirrored input rows padded by one pixel on both sides plus one row of 4
+// channel pixels
+size_t bayer_scratch_size(int width) {
+  return static_cast<size_t>(width + 2) * 3 + static_cast<size_t>(width) * 4;
+}
+
+// copies row y (mirrored) to padded[1, width] and mirrors its first and last
+// pixel to padded[0] and padded[width + 1]
+void load_padded_row(const ConstImageView &input, int y,
+                     unsigned char *padded) {
+  const size_t width = input.width;
+  std::memcpy(padded + 1, input.row(mirror(y, input.height)), width);
+  padded[0] = padded[2];
+  padded[width + 1] = padded[width - 1];
+}
+
+// Converts the rows [begin, end). The tile starts from its one row halo above
+// and below and keeps a rolling window of 3 padded rows, every input row is
+// loaded once and every output row is written by exactly one tile.
+// 3 channel outputs are produced as 4 channel pixels in scratch and compacted
+// by the row of the YUV kernels.
+void bayer_tile_2_rgb_simd(const detail::BayerSimdKernels &simd,
+                           const ConstImageView &input,
+                           const ImageView &output, int begin, int end,
+                           unsigned char *scratch) {
+  const size_t width = input.width;
+  unsigned char *rows[3] = {scratch, scratch + width + 2,
+                            scratch + 2 * (width + 2)};
+  unsigned char *rgba_scratch = scratch + 3 * (width + 2);
+
+  const bool bgr = output.format == ImageFormat::IMAGE_BGR8 ||
+                   output.format == ImageFormat::IMAGE_BGRA8;
+  const auto convert = bgr ? simd.bayer_2_bgra : simd.bayer_2_rgba;
+  const bool packed_alpha = image_format_channels(output.format) == 4;
+  const auto drop_alpha = detail::yuv_simd_kernels().drop_alpha;
+
+  load_padded_row(input, begin - 1, rows[0]);
+  load_padded_row(input, begin, rows[1]);
+  for (int y = begin; y < end; ++y) {
+    load_padded_row(input, y + 1, rows[2]);
+    const BayerPhase phase = bayer_phase(input.format, y);
+    unsigned char *rgba = packed_alpha ? output.row(y) : rgba_scratch;
+    convert(rows[0] + 1, rows[1] + 1, rows[2] + 1, rgba, width,
+            phase.red_row, phase.first_green);
+    if (!packed_alpha) {
+      drop_alpha(rgba_scratch, output.row(y), width);
+    }
+    std::swap(rows[0], rows[1]);
+    std::swap(rows[1], rows[2]);
+  }
+}
+
+} // namespace
+
+bool bayer_2_rgb_native(const ConstImageView &input, const ImageView &output) {
+  if (!valid_bayer_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const BayerRowNativeFunc convert = bayer_row_native_func(output.format);
+
+  for (int y = 0; y < input.height; ++y) {
+    convert(input, output.row(y), y);
+  }
+  return true;
+}
+
+bool bayer_2_rgb_parallel(const ConstImageView &input,
+                          const ImageView &output) {
+  if (!valid_bayer_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const BayerRowNativeFunc convert = bayer_row_native_func(output.format);
+
+  detail::parallel_rows(
+      input.height, input.width,
+      [&](int begin, int end) {
+        for (int y = begin; y != end; ++y) {
+          convert(input, output.row(y), y);
+        }
+      },
+      kBayerTileRows);
+  return true;
+}
+
+bool bayer_2_rgb_simd(const ConstImageView &input, const ImageView &output) {
+  if (!valid_bayer_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  std::vector<unsigned char> scratch(bayer_scratch_size(input.width));
+
+  bayer_tile_2_rgb_simd(detail::bayer_simd_kernels(), input, output, 0,
+                        input.height, scratch.data());
+  return true;
+}
+
+bool bayer_2_rgb_parallel_simd(const ConstImageView &input,
+                               const ImageView &output) {
+  if (!valid_bayer_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const auto &simd = detail::bayer_simd_kernels();
+
+  detail::parallel_rows(
+      input.height, input.width,
+      [&](int begin, int end) {
+        std::vector<unsigned char> scratch(bayer_scratch_size(input.width));
+        bayer_tile_2_rgb_simd(simd, input, output, begin, end, scratch.data());
+      },
+      kBayerTileRows);
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
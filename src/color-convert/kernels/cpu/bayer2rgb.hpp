@@ -0,0 +1,31 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// Bilinear demosaic of every Bayer input format (BGGR, GBRG, GRBG, RGGB), the
+// format of the input view selects the color filter pattern. The borders are
+// mirrored without repeating the edge pixel, which keeps the pattern, so
+// width and height must be at least 2.
+
+// output is RGB8, RGBA8, BGR8 or BGRA8
+bool bayer_2_rgb_native(const ConstImageView &input, const ImageView &output);
+
+bool bayer_2_rgb_parallel(const ConstImageView &input,
+                          const ImageView &output);
+
+bool bayer_2_rgb_simd(const ConstImageView &input, const ImageView &output);
+
+bool bayer_2_rgb_parallel_simd(const ConstImageView &input,
+                               const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
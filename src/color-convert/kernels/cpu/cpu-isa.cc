@@ -0,0 +1,67 @@
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <atomic>
+#include <initializer_list>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+CpuIsa detect_cpu_isa() {
+  for (CpuIsa isa : {CpuIsa::kAvx512bw, CpuIsa::kAvx2, CpuIsa::kSse41,
+                     CpuIsa::kNeon}) {
+    if (cpu_isa_supported(isa)) {
+      return isa;
+    }
+  }
+  return CpuIsa::kGeneric;
+}
+
+std::atomic<CpuIsa> &active_cpu_isa() {
+  static std::atomic<CpuIsa> isa{detect_cpu_isa()};
+  return isa;
+}
+
+// select the variant when the library is loaded rather than on the first call
+const CpuIsa kLoadTimeCpuIsa = active_cpu_isa().load();
+
+} // namespace
+
+bool cpu_isa_supported(CpuIsa isa) {
+  switch (isa) {
+  case CpuIsa::kGeneric:
+    return true;
+#if defined(__x86_64__) || defined(__i386__)
+  case CpuIsa::kSse41:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+  // the float kernels of both variants use fused multiply-add
+  case CpuIsa::kAvx2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  case CpuIsa::kAvx512bw:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("fma");
+#elif defined(__ARM_NEON__)
+  case CpuIsa::kNeon:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+CpuIsa cpu_isa() { return active_cpu_isa().load(std::memory_order_relaxed); }
+
+bool set_cpu_isa(CpuIsa isa) {
+  if (!cpu_isa_supported(isa)) {
+    return false;
+  }
+  active_cpu_isa().store(isa, std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,456 @@
+#include "float-simd.hpp"
+#include "simd-dispatch.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+inline float gray_f32(float r, float g, float b) {
+  return r * kGrayWeightR + g * kGrayWeightG + b * kGrayWeightB;
+}
+
+template <size_t channels>
+void packed_2_gray_f32_scalar(const float *input, float *output,
+                              size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = gray_f32(input[channels * i], input[channels * i + 1],
+                         input[channels * i + 2]);
+  }
+}
+
+void planar_2_gray_f32_scalar(const float *r, const float *g, const float *b,
+                              float *output, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = gray_f32(r[i], g[i], b[i]);
+  }
+}
+
+void u8_2_f32_scalar(const unsigned char *input, float *output, size_t count,
+                     float scale, float offset) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = input[i] * scale + offset;
+  }
+}
+
+void f32_2_u8_scalar(const float *input, unsigned char *output, size_t count,
+                     float scale, float offset) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = saturate_u8(input[i] * scale + offset);
+  }
+}
+
+const FloatSimdKernels kGenericKernels = {
+    packed_2_gray_f32_scalar<3>, packed_2_gray_f32_scalar<4>,
+    planar_2_gray_f32_scalar, u8_2_f32_scalar, f32_2_u8_scalar};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// ---------------------------------------------------------------- SSE4.1
+
+TARGET_SSE41 inline __m128 gray_f32_sse41(__m128 r, __m128 g, __m128 b) {
+  return _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(kGrayWeightR)),
+                 _mm_mul_ps(g, _mm_set1_ps(kGrayWeightG))),
+      _mm_mul_ps(b, _mm_set1_ps(kGrayWeightB)));
+}
+
+// 4 pixels, the blends pick every channel out of the 3 vectors in the order
+// 0, 3, 2, 1, the shuffles line g and b up with r and restore the order
+TARGET_SSE41 void rgb_packed_2_gray_f32_sse41(const float *input,
+                                              float *output, size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 3 * step * i;
+    __m128 a = _mm_loadu_ps(src);     // r0 g0 b0 r1
+    __m128 b = _mm_loadu_ps(src + 4); // g1 b1 r2 g2
+    __m128 c = _mm_loadu_ps(src + 8); // b2 r3 g3 b3
+    __m128 red = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);
+    __m128 green = _mm_blend_ps(_mm_blend_ps(b, a, 0x2), c, 0x4);
+    __m128 blue = _mm_blend_ps(_mm_blend_ps(c, b, 0x2), a, 0x4);
+    green = _mm_shuffle_ps(green, green, _MM_SHUFFLE(0, 3, 2, 1));
+    blue = _mm_shuffle_ps(blue, blue, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128 gray = gray_f32_sse41(red, green, blue);
+    _mm_storeu_ps(output + step * i,
+                  _mm_shuffle_ps(gray, gray, _MM_SHUFFLE(1, 2, 3, 0)));
+  }
+
+  packed_2_gray_f32_scalar<3>(input + 3 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+TARGET_SSE41 void rgba_packed_2_gray_f32_sse41(const float *input,
+                                               float *output, size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 4 * step * i;
+    __m128 p0 = _mm_loadu_ps(src);
+    __m128 p1 = _mm_loadu_ps(src + 4);
+    __m128 p2 = _mm_loadu_ps(src + 8);
+    __m128 p3 = _mm_loadu_ps(src + 12);
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    _mm_storeu_ps(output + step * i, gray_f32_sse41(p0, p1, p2));
+  }
+
+  packed_2_gray_f32_scalar<4>(input + 4 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+TARGET_SSE41 void planar_2_gray_f32_sse41(const float *r, const float *g,
+                                          const float *b, float *output,
+                                          size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    _mm_storeu_ps(output + step * i,
+                  gray_f32_sse41(_mm_loadu_ps(r + step * i),
+                                 _mm_loadu_ps(g + step * i),
+                                 _mm_loadu_ps(b + step * i)));
+  }
+
+  planar_2_gray_f32_scalar(r + step * tile, g + step * tile, b + step * tile,
+                           output + step * tile, count - step * tile);
+}
+
+TARGET_SSE41 void u8_2_f32_sse41(const unsigned char *input, float *output,
+                                 size_t count, float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128 scale_vec = _mm_set1_ps(scale);
+  const __m128 offset_vec = _mm_set1_ps(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + step * i));
+    for (size_t j = 0; j < 4; ++j) {
+      __m128 value = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes));
+      _mm_storeu_ps(output + step * i + 4 * j,
+                    _mm_add_ps(_mm_mul_ps(value, scale_vec), offset_vec));
+      bytes = _mm_srli_si128(bytes, 4);
+    }
+  }
+
+  u8_2_f32_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+// max(value, 0) returns its second operand for NaN, which makes NaN 0 like
+// saturate_u8(), the conversion rounds to nearest even
+TARGET_SSE41 inline __m128i f32_2_i32_sse41(__m128 value) {
+  value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+  return _mm_cvtps_epi32(value);
+}
+
+TARGET_SSE41 void f32_2_u8_sse41(const float *input, unsigned char *output,
+                                 size_t count, float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128 scale_vec = _mm_set1_ps(scale);
+  const __m128 offset_vec = _mm_set1_ps(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i value[4];
+    for (size_t j = 0; j < 4; ++j) {
+      value[j] = f32_2_i32_sse41(_mm_add_ps(
+          _mm_mul_ps(_mm_loadu_ps(input + step * i + 4 * j), scale_vec),
+          offset_vec));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(_mm_packs_epi32(value[0], value[1]),
+                                      _mm_packs_epi32(value[2], value[3])));
+  }
+
+  f32_2_u8_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+const FloatSimdKernels kSse41Kernels = {
+    rgb_packed_2_gray_f32_sse41, rgba_packed_2_gray_f32_sse41,
+    planar_2_gray_f32_sse41, u8_2_f32_sse41, f32_2_u8_sse41};
+
+// -------------------------------------------------------------- AVX2+FMA
+
+TARGET_AVX2_FMA inline __m256 gray_f32_avx2(__m256 r, __m256 g, __m256 b) {
+  return _mm256_fmadd_ps(
+      b, _mm256_set1_ps(kGrayWeightB),
+      _mm256_fmadd_ps(g, _mm256_set1_ps(kGrayWeightG),
+                      _mm256_mul_ps(r, _mm256_set1_ps(kGrayWeightR))));
+}
+
+// 8 pixels, the blends pick every channel out of the 3 vectors in the order
+// 0, 3, 6, 1, 4, 7, 2, 5, the permutes line g and b up with r and restore the
+// order
+TARGET_AVX2_FMA void rgb_packed_2_gray_f32_avx2(const float *input,
+                                                float *output, size_t count) {
+  constexpr size_t step = 8;
+  size_t tile = count / step;
+  const __m256i green_order = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  const __m256i blue_order = _mm256_setr_epi32(2, 3, 4, 5, 6, 7, 0, 1);
+  const __m256i pixel_order = _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 3 * step * i;
+    __m256 a = _mm256_loadu_ps(src);      // r0 g0 b0 r1 g1 b1 r2 g2
+    __m256 b = _mm256_loadu_ps(src + 8);  // b2 r3 g3 b3 r4 g4 b4 r5
+    __m256 c = _mm256_loadu_ps(src + 16); // g5 b5 r6 g6 b6 r7 g7 b7
+    __m256 red = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+    __m256 green = _mm256_blend_ps(_mm256_blend_ps(c, a, 0x92), b, 0x24);
+    __m256 blue = _mm256_blend_ps(_mm256_blend_ps(b, a, 0x24), c, 0x92);
+    green = _mm256_permutevar8x32_ps(green, green_order);
+    blue = _mm256_permutevar8x32_ps(blue, blue_order);
+    _mm256_storeu_ps(output + step * i,
+                     _mm256_permutevar8x32_ps(gray_f32_avx2(red, green, blue),
+                                              pixel_order));
+  }
+
+  packed_2_gray_f32_scalar<3>(input + 3 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+// 8 pixels, a 4x4 transpose per 128 bit lane leaves them in the order
+// 0, 2, 4, 6, 1, 3, 5, 7
+TARGET_AVX2_FMA void rgba_packed_2_gray_f32_avx2(const float *input,
+                                                 float *output,
+                                                 size_t count) {
+  constexpr size_t step = 8;
+  size_t tile = count / step;
+  const __m256i pixel_order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 4 * step * i;
+    __m256 v0 = _mm256_loadu_ps(src);
+    __m256 v1 = _mm256_loadu_ps(src + 8);
+    __m256 v2 = _mm256_loadu_ps(src + 16);
+    __m256 v3 = _mm256_loadu_ps(src + 24);
+    __m256 rg_lo = _mm256_unpacklo_ps(v0, v1);
+    __m256 ba_lo = _mm256_unpackhi_ps(v0, v1);
+    __m256 rg_hi = _mm256_unpacklo_ps(v2, v3);
+    __m256 ba_hi = _mm256_unpackhi_ps(v2, v3);
+    __m256 red = _mm256_shuffle_ps(rg_lo, rg_hi, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 green = _mm256_shuffle_ps(rg_lo, rg_hi, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 blue = _mm256_shuffle_ps(ba_lo, ba_hi, _MM_SHUFFLE(1, 0, 1, 0));
+    _mm256_storeu_ps(output + step * i,
+                     _mm256_permutevar8x32_ps(gray_f32_avx2(red, green, blue),
+                                              pixel_order));
+  }
+
+  packed_2_gray_f32_scalar<4>(input + 4 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+TARGET_AVX2_FMA void planar_2_gray_f32_avx2(const float *r, const float *g,
+                                            const float *b, float *output,
+                                            size_t count) {
+  constexpr size_t step = 8;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    _mm256_storeu_ps(output + step * i,
+                     gray_f32_avx2(_mm256_loadu_ps(r + step * i),
+                                   _mm256_loadu_ps(g + step * i),
+                                   _mm256_loadu_ps(b + step * i)));
+  }
+
+  planar_2_gray_f32_scalar(r + step * tile, g + step * tile, b + step * tile,
+                           output + step * tile, count - step * tile);
+}
+
+TARGET_AVX2_FMA void u8_2_f32_avx2(const unsigned char *input, float *output,
+                                   size_t count, float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m256 scale_vec = _mm256_set1_ps(scale);
+  const __m256 offset_vec = _mm256_set1_ps(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + step * i));
+    __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+    __m256 hi =
+        _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+    _mm256_storeu_ps(output + step * i,
+                     _mm256_fmadd_ps(lo, scale_vec, offset_vec));
+    _mm256_storeu_ps(output + step * i + 8,
+                     _mm256_fmadd_ps(hi, scale_vec, offset_vec));
+  }
+
+  u8_2_f32_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+TARGET_AVX2_FMA inline __m256i f32_2_i32_avx2(__m256 value) {
+  value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()),
+                        _mm256_set1_ps(255.0f));
+  return _mm256_cvtps_epi32(value);
+}
+
+TARGET_AVX2_FMA void f32_2_u8_avx2(const float *input, unsigned char *output,
+                                   size_t count, float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m256 scale_vec = _mm256_set1_ps(scale);
+  const __m256 offset_vec = _mm256_set1_ps(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m256i lo = f32_2_i32_avx2(_mm256_fmadd_ps(
+        _mm256_loadu_ps(input + step * i), scale_vec, offset_vec));
+    __m256i hi = f32_2_i32_avx2(_mm256_fmadd_ps(
+        _mm256_loadu_ps(input + step * i + 8), scale_vec, offset_vec));
+    // the pack works per 128 bit lane, the permute puts 0..7 before 8..15
+    __m256i words =
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(_mm256_castsi256_si128(words),
+                                      _mm256_extracti128_si256(words, 1)));
+  }
+
+  f32_2_u8_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+const FloatSimdKernels kAvx2Kernels = {
+    rgb_packed_2_gray_f32_avx2, rgba_packed_2_gray_f32_avx2,
+    planar_2_gray_f32_avx2, u8_2_f32_avx2, f32_2_u8_avx2};
+
+#elif defined(__ARM_NEON__)
+
+inline float32x4_t gray_f32_neon(float32x4_t r, float32x4_t g,
+                                 float32x4_t b) {
+  return vaddq_f32(vaddq_f32(vmulq_n_f32(r, kGrayWeightR),
+                             vmulq_n_f32(g, kGrayWeightG)),
+                   vmulq_n_f32(b, kGrayWeightB));
+}
+
+void rgb_packed_2_gray_f32_neon(const float *input, float *output,
+                                size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x3_t pixels = vld3q_f32(input + 3 * step * i);
+    vst1q_f32(output + step * i,
+              gray_f32_neon(pixels.val[0], pixels.val[1], pixels.val[2]));
+  }
+
+  packed_2_gray_f32_scalar<3>(input + 3 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+void rgba_packed_2_gray_f32_neon(const float *input, float *output,
+                                 size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x4_t pixels = vld4q_f32(input + 4 * step * i);
+    vst1q_f32(output + step * i,
+              gray_f32_neon(pixels.val[0], pixels.val[1], pixels.val[2]));
+  }
+
+  packed_2_gray_f32_scalar<4>(input + 4 * step * tile, output + step * tile,
+                              count - step * tile);
+}
+
+void planar_2_gray_f32_neon(const float *r, const float *g, const float *b,
+                            float *output, size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    vst1q_f32(output + step * i,
+              gray_f32_neon(vld1q_f32(r + step * i), vld1q_f32(g + step * i),
+                            vld1q_f32(b + step * i)));
+  }
+
+  planar_2_gray_f32_scalar(r + step * tile, g + step * tile, b + step * tile,
+                           output + step * tile, count - step * tile);
+}
+
+void u8_2_f32_neon(const unsigned char *input, float *output, size_t count,
+                   float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const float32x4_t offset_vec = vdupq_n_f32(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16_t bytes = vld1q_u8(input + step * i);
+    uint16x8_t words[2] = {vmovl_u8(vget_low_u8(bytes)),
+                           vmovl_u8(vget_high_u8(bytes))};
+    for (size_t j = 0; j < 4; ++j) {
+      uint16x8_t word = words[j / 2];
+      uint32x4_t value =
+          vmovl_u16(j % 2 == 0 ? vget_low_u16(word) : vget_high_u16(word));
+      vst1q_f32(output + step * i + 4 * j,
+                vaddq_f32(vmulq_n_f32(vcvtq_f32_u32(value), scale),
+                          offset_vec));
+    }
+  }
+
+  u8_2_f32_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+// adding and subtracting 2^23 rounds [0, 255] to nearest even, the
+// conversion then only truncates whole numbers
+inline uint16x4_t f32_2_u16_neon(float32x4_t value) {
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t magic = vdupq_n_f32(8388608.0f);
+  value = vbslq_f32(vcgtq_f32(value, zero), value, zero);
+  value = vminq_f32(value, vdupq_n_f32(255.0f));
+  value = vsubq_f32(vaddq_f32(value, magic), magic);
+  return vmovn_u32(vcvtq_u32_f32(value));
+}
+
+void f32_2_u8_neon(const float *input, unsigned char *output, size_t count,
+                   float scale, float offset) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const float32x4_t offset_vec = vdupq_n_f32(offset);
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint16x4_t words[4];
+    for (size_t j = 0; j < 4; ++j) {
+      words[j] = f32_2_u16_neon(vaddq_f32(
+          vmulq_n_f32(vld1q_f32(input + step * i + 4 * j), scale),
+          offset_vec));
+    }
+    vst1q_u8(output + step * i,
+             vcombine_u8(vmovn_u16(vcombine_u16(words[0], words[1])),
+                         vmovn_u16(vcombine_u16(words[2], words[3]))));
+  }
+
+  f32_2_u8_scalar(input + step * tile, output + step * tile,
+                  count - step * tile, scale, offset);
+}
+
+const FloatSimdKernels kNeonKernels = {
+    rgb_packed_2_gray_f32_neon, rgba_packed_2_gray_f32_neon,
+    planar_2_gray_f32_neon, u8_2_f32_neon, f32_2_u8_neon};
+
+#endif
+
+} // namespace
+
+const FloatSimdKernels &float_simd_kernels() {
+  return select_simd_kernels(
+      kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+      X86_SIMD_KERNELS(kAvx2Kernels), nullptr, NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <cmath>
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// luminosity weights of the float kernels
+constexpr float kGrayWeightR = 0.299f;
+constexpr float kGrayWeightG = 0.587f;
+constexpr float kGrayWeightB = 0.114f;
+
+// value rounded to nearest even and saturated to [0, 255], NaN becomes 0
+inline unsigned char saturate_u8(float value) {
+  value = value > 0.0f ? value : 0.0f;
+  value = value < 255.0f ? value : 255.0f;
+  return static_cast<unsigned char>(std::nearbyint(value));
+}
+
+// converts count consecutive packed float pixels with 3 or 4 channels
+using PackedGrayF32RowFunc = void (*)(const float *input, float *output,
+                                      size_t count);
+
+// converts count float pixels from separate r, g and b planes
+using PlanarGrayF32RowFunc = void (*)(const float *r, const float *g,
+                                      const float *b, float *output,
+                                      size_t count);
+
+// output[i] = input[i] * scale + offset
+using U8ToF32RowFunc = void (*)(const unsigned char *input, float *output,
+                                size_t count, float scale, float offset);
+
+// output[i] = saturate_u8(input[i] * scale + offset)
+using F32ToU8RowFunc = void (*)(const float *input, unsigned char *output,
+                                size_t count, float scale, float offset);
+
+// The AVX2 rows use fused multiply-add, their results may differ from the
+// other variants in the last bit of the float mantissa.
+struct FloatSimdKernels {
+  PackedGrayF32RowFunc rgb_packed;
+  PackedGrayF32RowFunc rgba_packed;
+  PlanarGrayF32RowFunc planar;
+  U8ToF32RowFunc u8_2_f32;
+  F32ToU8RowFunc f32_2_u8;
+};
+
+// the variant selected by cpu_isa()
+const FloatSimdKernels &float_simd_kernels();
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
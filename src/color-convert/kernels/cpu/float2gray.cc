@@ -0,0 +1,124 @@
+#include "float2gray.hpp"
+#include "float-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+bool valid_float_gray(const ConstImageView &input, const ImageView &output) {
+  return (input.format == ImageFormat::IMAGE_RGB32F ||
+          input.format == ImageFormat::IMAGE_RGBA32F) &&
+         output.format == ImageFormat::IMAGE_GRAY32F;
+}
+
+const float *float_row(const ConstImageView &view, int y, int plane = 0) {
+  return reinterpret_cast<const float *>(view.row(y, plane));
+}
+
+float *float_row(const ImageView &view, int y) {
+  return reinterpret_cast<float *>(view.row(y));
+}
+
+void float_row_2_gray_native(const ConstImageView &input,
+                             const ImageView &output, int y) {
+  float *dst = float_row(output, y);
+  if (input.layout == MemLayout::Planar) {
+    const float *r = float_row(input, y, 0);
+    const float *g = float_row(input, y, 1);
+    const float *b = float_row(input, y, 2);
+    for (int x = 0; x < input.width; ++x) {
+      dst[x] = r[x] * detail::kGrayWeightR + g[x] * detail::kGrayWeightG +
+               b[x] * detail::kGrayWeightB;
+    }
+    return;
+  }
+
+  const size_t channels = image_format_channels(input.format);
+  const float *src = float_row(input, y);
+  for (int x = 0; x < input.width; ++x) {
+    dst[x] = src[channels * x] * detail::kGrayWeightR +
+             src[channels * x + 1] * detail::kGrayWeightG +
+             src[channels * x + 2] * detail::kGrayWeightB;
+  }
+}
+
+void float_row_2_gray_simd(const detail::FloatSimdKernels &simd,
+                           const ConstImageView &input,
+                           const ImageView &output, int y) {
+  if (input.layout == MemLayout::Planar) {
+    simd.planar(float_row(input, y, 0), float_row(input, y, 1),
+                float_row(input, y, 2), float_row(output, y), input.width);
+  } else if (input.format == ImageFormat::IMAGE_RGB32F) {
+    simd.rgb_packed(float_row(input, y), float_row(output, y), input.width);
+  } else {
+    simd.rgba_packed(float_row(input, y), float_row(output, y), input.width);
+  }
+}
+
+} // namespace
+
+bool float_2_gray_native(const ConstImageView &input,
+                         const ImageView &output) {
+  if (!valid_float_gray(input, output)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    float_row_2_gray_native(input, output, y);
+  }
+  return true;
+}
+
+bool float_2_gray_parallel(const ConstImageView &input,
+                           const ImageView &output) {
+  if (!valid_float_gray(input, output)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      float_row_2_gray_native(input, output, y);
+    }
+  });
+  return true;
+}
+
+// the row kernel is chosen for the running CPU, see float-simd.cc
+bool float_2_gray_simd(const ConstImageView &input, const ImageView &output) {
+  if (!valid_float_gray(input, output)) {
+    return false;
+  }
+  const auto &simd = detail::float_simd_kernels();
+
+  for (int y = 0; y < input.height; ++y) {
+    float_row_2_gray_simd(simd, input, output, y);
+  }
+  return true;
+}
+
+bool float_2_gray_parallel_simd(const ConstImageView &input,
+                                const ImageView &output) {
+  if (!valid_float_gray(input, output)) {
+    return false;
+  }
+  const auto &simd = detail::float_simd_kernels();
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      float_row_2_gray_simd(simd, input, output, y);
+    }
+  });
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
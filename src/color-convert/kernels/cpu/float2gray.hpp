@@ -0,0 +1,28 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// input is RGB32F or RGBA32F in either memory layout, output GRAY32F with
+// the weights 0.299, 0.587 and 0.114
+
+bool float_2_gray_native(const ConstImageView &input, const ImageView &output);
+
+bool float_2_gray_parallel(const ConstImageView &input,
+                           const ImageView &output);
+
+bool float_2_gray_simd(const ConstImageView &input, const ImageView &output);
+
+bool float_2_gray_parallel_simd(const ConstImageView &input,
+                                const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,214 @@
+#include "gray-downscale.hpp"
+#include "gray-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+#include <vector>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+template <size_t channels, MemLayout layout>
+unsigned char gray_native(const ConstImageView &input, int x, int y) {
+  unsigned char r, g, b;
+  if (layout == MemLayout::Packed) {
+    const unsigned char *pixel = input.row(y) + channels * x;
+    r = pixel[0];
+    g = pixel[1];
+    b = pixel[2];
+  } else {
+    r = input.row(y, 0)[x];
+    g = input.row(y, 1)[x];
+    b = input.row(y, 2)[x];
+  }
+  // Convert to grayscale using the luminosity method
+  return (unsigned char)(0.299 * r + 0.587 * g + 0.114 * b);
+}
+
+// output row y, the average of the gray values of each factor x factor block
+template <size_t channels, MemLayout layout>
+void downscale_row_native(const ConstImageView &input, const ImageView &output,
+                          int factor, int y) {
+  const int block = factor * factor;
+  unsigned char *dst = output.row(y);
+  for (int x = 0; x < output.width; ++x) {
+    int sum = 0;
+    for (int dy = 0; dy < factor; ++dy) {
+      for (int dx = 0; dx < factor; ++dx) {
+        sum += gray_native<channels, layout>(input, x * factor + dx,
+                                             y * factor + dy);
+      }
+    }
+    dst[x] = (unsigned char)((sum + block / 2) / block);
+  }
+}
+
+// The factor input rows of output row y are converted into scratch (factor
+// rows of output.width * factor pixels, small enough to stay in cache) and
+// reduced from there, so the full size gray image never reaches memory.
+template <size_t channels, MemLayout layout>
+void downscale_row_simd(const detail::GraySimdKernels &simd,
+                        const ConstImageView &input, const ImageView &output,
+                        int factor, int y, unsigned char *scratch) {
+  const size_t width = static_cast<size_t>(output.width) * factor;
+  for (int dy = 0; dy < factor; ++dy) {
+    const int input_y = y * factor + dy;
+    if (layout == MemLayout::Packed) {
+      const auto packed = channels == 3 ? simd.rgb_packed : simd.rgba_packed;
+      packed(input.row(input_y), scratch + dy * width, width);
+    } else {
+      simd.planar(input.row(input_y, 0), input.row(input_y, 1),
+                  input.row(input_y, 2), scratch + dy * width, width);
+    }
+  }
+  const auto box = factor == 2 ? simd.box_2 : simd.box_4;
+  box(scratch, width, output.row(y), output.width);
+}
+
+template <size_t channels, MemLayout layout>
+bool downscale_native(const ConstImageView &input, const ImageView &output,
+                      int factor) {
+  for (int y = 0; y < output.height; ++y) {
+    downscale_row_native<channels, layout>(input, output, factor, y);
+  }
+  return true;
+}
+
+template <size_t channels, MemLayout layout>
+bool downscale_parallel(const ConstImageView &input, const ImageView &output,
+                        int factor) {
+  detail::parallel_rows(output.height, output.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      downscale_row_native<channels, layout>(input, output, factor, y);
+    }
+  });
+  return true;
+}
+
+template <size_t channels, MemLayout layout>
+bool downscale_simd(const ConstImageView &input, const ImageView &output,
+                    int factor) {
+  const auto &simd = detail::gray_simd_kernels();
+  std::vector<unsigned char> scratch(static_cast<size_t>(output.width) *
+                                     factor * factor);
+
+  for (int y = 0; y < output.height; ++y) {
+    downscale_row_simd<channels, layout>(simd, input, output, factor, y,
+                                         scratch.data());
+  }
+  return true;
+}
+
+template <size_t channels, MemLayout layout>
+bool downscale_parallel_simd(const ConstImageView &input,
+                             const ImageView &output, int factor) {
+  const auto &simd = detail::gray_simd_kernels();
+
+  detail::parallel_rows(output.height, output.width, [&](int begin, int end) {
+    std::vector<unsigned char> scratch(
+        static_cast<size_t>(output.width) * factor * factor);
+    for (int y = begin; y != end; ++y) {
+      downscale_row_simd<channels, layout>(
+          simd, input, output, factor, y, scratch.data());
+    }
+  });
+  return true;
+}
+
+} // namespace
+
+bool rgb_packed_2_gray_downscale_native(const ConstImageView &input,
+                                        const ImageView &output, int factor) {
+  return downscale_native<3, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgb_packed_2_gray_downscale_parallel(const ConstImageView &input,
+                                          const ImageView &output, int factor) {
+  return downscale_parallel<3, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgb_packed_2_gray_downscale_simd(const ConstImageView &input,
+                                      const ImageView &output, int factor) {
+  return downscale_simd<3, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgb_packed_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                               const ImageView &output,
+                                               int factor) {
+  return downscale_parallel_simd<3, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgb_planar_2_gray_downscale_native(const ConstImageView &input,
+                                        const ImageView &output, int factor) {
+  return downscale_native<3, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgb_planar_2_gray_downscale_parallel(const ConstImageView &input,
+                                          const ImageView &output, int factor) {
+  return downscale_parallel<3, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgb_planar_2_gray_downscale_simd(const ConstImageView &input,
+                                      const ImageView &output, int factor) {
+  return downscale_simd<3, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgb_planar_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                               const ImageView &output,
+                                               int factor) {
+  return downscale_parallel_simd<3, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgba_packed_2_gray_downscale_native(const ConstImageView &input,
+                                         const ImageView &output, int factor) {
+  return downscale_native<4, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgba_packed_2_gray_downscale_parallel(const ConstImageView &input,
+                                           const ImageView &output,
+                                           int factor) {
+  return downscale_parallel<4, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgba_packed_2_gray_downscale_simd(const ConstImageView &input,
+                                       const ImageView &output, int factor) {
+  return downscale_simd<4, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgba_packed_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                                const ImageView &output,
+                                                int factor) {
+  return downscale_parallel_simd<4, MemLayout::Packed>(input, output, factor);
+}
+
+bool rgba_planar_2_gray_downscale_native(const ConstImageView &input,
+                                         const ImageView &output, int factor) {
+  return downscale_native<4, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgba_planar_2_gray_downscale_parallel(const ConstImageView &input,
+                                           const ImageView &output,
+                                           int factor) {
+  return downscale_parallel<4, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgba_planar_2_gray_downscale_simd(const ConstImageView &input,
+                                       const ImageView &output, int factor) {
+  return downscale_simd<4, MemLayout::Planar>(input, output, factor);
+}
+
+bool rgba_planar_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                                const ImageView &output,
+                                                int factor) {
+  return downscale_parallel_simd<4, MemLayout::Planar>(input, output, factor);
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
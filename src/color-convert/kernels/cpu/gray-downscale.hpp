@@ -0,0 +1,72 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// Fused color conversion and factor x factor box downscale. The output is
+// input.width / factor x input.height / factor, factor is 2 or 4.
+
+bool rgb_packed_2_gray_downscale_native(const ConstImageView &input,
+                                        const ImageView &output, int factor);
+
+bool rgb_packed_2_gray_downscale_parallel(const ConstImageView &input,
+                                          const ImageView &output, int factor);
+
+bool rgb_packed_2_gray_downscale_simd(const ConstImageView &input,
+                                      const ImageView &output, int factor);
+
+bool rgb_packed_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                               const ImageView &output,
+                                               int factor);
+
+bool rgb_planar_2_gray_downscale_native(const ConstImageView &input,
+                                        const ImageView &output, int factor);
+
+bool rgb_planar_2_gray_downscale_parallel(const ConstImageView &input,
+                                          const ImageView &output, int factor);
+
+bool rgb_planar_2_gray_downscale_simd(const ConstImageView &input,
+                                      const ImageView &output, int factor);
+
+bool rgb_planar_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                               const ImageView &output,
+                                               int factor);
+
+bool rgba_packed_2_gray_downscale_native(const ConstImageView &input,
+                                         const ImageView &output, int factor);
+
+bool rgba_packed_2_gray_downscale_parallel(const ConstImageView &input,
+                                           const ImageView &output,
+                                           int factor);
+
+bool rgba_packed_2_gray_downscale_simd(const ConstImageView &input,
+                                       const ImageView &output, int factor);
+
+bool rgba_packed_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                                const ImageView &output,
+                                                int factor);
+
+bool rgba_planar_2_gray_downscale_native(const ConstImageView &input,
+                                         const ImageView &output, int factor);
+
+bool rgba_planar_2_gray_downscale_parallel(const ConstImageView &input,
+                                           const ImageView &output,
+                                           int factor);
+
+bool rgba_planar_2_gray_downscale_simd(const ConstImageView &input,
+                                       const ImageView &output, int factor);
+
+bool rgba_planar_2_gray_downscale_parallel_simd(const ConstImageView &input,
+                                                const ImageView &output,
+                                                int factor);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,798 @@
+#include "gray-simd.hpp"
+#include "image-processing/color-convert/common/image-format.hpp"
+#include "simd-dispatch.hpp"
+#include <stdint.h>
+
+#include <experimental/simd>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+inline unsigned char gray_fixed_point(uint16_t r, uint16_t g, uint16_t b) {
+  return static_cast<unsigned char>((r * 77 + g * 150 + b * 29) >> 8);
+}
+
+// The packed rows are templated over the input format, the channel offsets
+// of ImageFormatType are compile-time constants of every instantiation.
+template <ImageFormat format>
+void packed_2_gray_scalar(const unsigned char *input, unsigned char *output,
+                          size_t count) {
+  using traits = ImageFormatType<format>;
+  for (size_t i = 0; i < count; ++i) {
+    const unsigned char *pixel = input + traits::channels * i;
+    output[i] = gray_fixed_point(pixel[traits::red], pixel[traits::green],
+                                 pixel[traits::blue]);
+  }
+}
+
+void planar_2_gray_scalar(const unsigned char *r, const unsigned char *g,
+                          const unsigned char *b, unsigned char *output,
+                          size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = gray_fixed_point(r[i], g[i], b[i]);
+  }
+}
+
+template <size_t factor>
+void box_gray_scalar(const unsigned char *input, size_t pitch,
+                     unsigned char *output, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    unsigned sum = 0;
+    for (size_t y = 0; y < factor; ++y) {
+      for (size_t x = 0; x < factor; ++x) {
+        sum += input[y * pitch + factor * i + x];
+      }
+    }
+    output[i] = static_cast<unsigned char>((sum + factor * factor / 2) /
+                                           (factor * factor));
+  }
+}
+
+// std::experimental::simd cannot deinterleave, so the packed generic variant
+// gathers every lane with scalar loads
+template <ImageFormat format>
+void packed_2_gray_generic(const unsigned char *input, unsigned char *output,
+                           size_t count) {
+  namespace stdx = std::experimental;
+
+  using traits = ImageFormatType<format>;
+  constexpr size_t channels = traits::channels;
+
+  using simd_t = stdx::native_simd<uint16_t>;
+  constexpr auto step = simd_t::size();
+
+  using fixed_size_simd_t = stdx::fixed_size_simd<uint8_t, step>;
+
+  size_t tile = count / step;
+
+  simd_t r_mul = simd_t(77);
+  simd_t g_mul = simd_t(150);
+  simd_t b_mul = simd_t(29);
+
+  for (size_t i = 0; i < tile; i += 1) {
+    simd_t r_vec;
+    simd_t g_vec;
+    simd_t b_vec;
+    simd_t gray_vec;
+
+#pragma GCC unroll step
+    for (size_t j = 0; j < step; j += 1) {
+      r_vec[j] = input[channels * (i * step + j) + traits::red];
+      g_vec[j] = input[channels * (i * step + j) + traits::green];
+      b_vec[j] = input[channels * (i * step + j) + traits::blue];
+    }
+    gray_vec = (r_vec * r_mul + g_vec * g_mul + b_vec * b_mul) >> 8;
+
+    stdx::parallelism_v2::static_simd_cast<fixed_size_simd_t>(gray_vec).copy_to(
+        output + i * step, stdx::element_aligned);
+  }
+
+  packed_2_gray_scalar<format>(input + channels * tile * step,
+                               output + tile * step, count - tile * step);
+}
+
+void planar_2_gray_generic(const unsigned char *r, const unsigned char *g,
+                           const unsigned char *b, unsigned char *output,
+                           size_t count) {
+  namespace stdx = std::experimental;
+
+  using simd_t = stdx::native_simd<uint16_t>;
+  constexpr auto step = simd_t::size();
+
+  using fixed_size_simd_t = stdx::fixed_size_simd<uint8_t, step>;
+
+  size_t tile = count / step;
+
+  simd_t r_mul = simd_t(77);
+  simd_t g_mul = simd_t(150);
+  simd_t b_mul = simd_t(29);
+
+  for (size_t i = 0; i < tile; i += 1) {
+    simd_t r_vec = stdx::parallelism_v2::static_simd_cast<simd_t>(
+        fixed_size_simd_t(r + i * step, stdx::element_aligned));
+    simd_t g_vec = stdx::parallelism_v2::static_simd_cast<simd_t>(
+        fixed_size_simd_t(g + i * step, stdx::element_aligned));
+    simd_t b_vec = stdx::parallelism_v2::static_simd_cast<simd_t>(
+        fixed_size_simd_t(b + i * step, stdx::element_aligned));
+
+    simd_t gray_vec = (r_vec * r_mul + g_vec * g_mul + b_vec * b_mul) >> 8;
+
+    stdx::parallelism_v2::static_simd_cast<fixed_size_simd_t>(gray_vec).copy_to(
+        output + i * step, stdx::element_aligned);
+  }
+
+  planar_2_gray_scalar(r + tile * step, g + tile * step, b + tile * step,
+                       output + tile * step, count - tile * step);
+}
+
+// the box filter needs horizontal pair sums, which std::experimental::simd
+// lacks as well, the scalar loop is left to the auto vectorizer
+const GraySimdKernels kGenericKernels = {
+    packed_2_gray_generic<ImageFormat::IMAGE_RGB8>,
+    packed_2_gray_generic<ImageFormat::IMAGE_RGBA8>,
+    packed_2_gray_generic<ImageFormat::IMAGE_BGR8>,
+    packed_2_gray_generic<ImageFormat::IMAGE_BGRA8>,
+    planar_2_gray_generic,
+    box_gray_scalar<2>,
+    box_gray_scalar<4>};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// 77 * r + 150 * g + 29 * b overflows the signed 16 bit pair sums of
+// pmaddubsw, so every pixel is expanded to (r, g, g, b) and weighted with
+// (77, 51, 99, 29). Each pair stays below 255 * 128 and both pairs add up to
+// the same fixed point value as the scalar code. The two pair sums wrap as
+// unsigned 16 bit values, the logical shift by 8 undoes that.
+constexpr int kGrayQuadWeights = 0x1d63334d;
+// the same weights for interleaved (r, g) and (g, b) pairs of planar data
+constexpr short kGrayRgWeights = 0x334d;
+constexpr short kGrayGbWeights = 0x1d63;
+
+// ---------------------------------------------------------------- SSE4.1
+
+// pshufb mask expanding the 4 pixels of format starting at byte first to
+// their (r, g, g, b) quads, the channel order only changes the constants
+template <ImageFormat format>
+TARGET_SSE41 inline __m128i gray_quad_shuffle_sse41(char first) {
+  using traits = ImageFormatType<format>;
+  constexpr char c = traits::channels;
+  constexpr char r = traits::red;
+  constexpr char g = traits::green;
+  constexpr char b = traits::blue;
+  return _mm_setr_epi8(first + r, first + g, first + g, first + b,
+                       first + c + r, first + c + g, first + c + g,
+                       first + c + b, first + 2 * c + r, first + 2 * c + g,
+                       first + 2 * c + g, first + 2 * c + b, first + 3 * c + r,
+                       first + 3 * c + g, first + 3 * c + g,
+                       first + 3 * c + b);
+}
+
+template <ImageFormat format>
+TARGET_SSE41 void packed3_2_gray_sse41(const unsigned char *input,
+                                       unsigned char *output, size_t count) {
+  const __m128i shuffle = gray_quad_shuffle_sse41<format>(0);
+  // the last 4 pixels are loaded 4 bytes early so that no byte past the
+  // 48 byte block is read
+  const __m128i shuffle_last = gray_quad_shuffle_sse41<format>(4);
+  const __m128i weights = _mm_set1_epi32(kGrayQuadWeights);
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *src = input + 3 * step * i;
+    __m128i x0 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), shuffle),
+        weights);
+    __m128i x1 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12)),
+            shuffle),
+        weights);
+    __m128i x2 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 24)),
+            shuffle),
+        weights);
+    __m128i x3 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32)),
+            shuffle_last),
+        weights);
+
+    __m128i lo = _mm_srli_epi16(_mm_hadd_epi16(x0, x1), 8);
+    __m128i hi = _mm_srli_epi16(_mm_hadd_epi16(x2, x3), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+
+  packed_2_gray_scalar<format>(input + 3 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+template <ImageFormat format>
+TARGET_SSE41 void packed4_2_gray_sse41(const unsigned char *input,
+                                       unsigned char *output, size_t count) {
+  const __m128i shuffle = gray_quad_shuffle_sse41<format>(0);
+  const __m128i weights = _mm_set1_epi32(kGrayQuadWeights);
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src = reinterpret_cast<const __m128i *>(input + 4 * step * i);
+    __m128i x0 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(_mm_loadu_si128(src), shuffle), weights);
+    __m128i x1 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(_mm_loadu_si128(src + 1), shuffle), weights);
+    __m128i x2 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(_mm_loadu_si128(src + 2), shuffle), weights);
+    __m128i x3 = _mm_maddubs_epi16(
+        _mm_shuffle_epi8(_mm_loadu_si128(src + 3), shuffle), weights);
+
+    __m128i lo = _mm_srli_epi16(_mm_hadd_epi16(x0, x1), 8);
+    __m128i hi = _mm_srli_epi16(_mm_hadd_epi16(x2, x3), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+
+  packed_2_gray_scalar<format>(input + 4 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+TARGET_SSE41 void planar_2_gray_sse41(const unsigned char *r,
+                                      const unsigned char *g,
+                                      const unsigned char *b,
+                                      unsigned char *output, size_t count) {
+  const __m128i rg_weights = _mm_set1_epi16(kGrayRgWeights);
+  const __m128i gb_weights = _mm_set1_epi16(kGrayGbWeights);
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i r_vec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(r + step * i));
+    __m128i g_vec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(g + step * i));
+    __m128i b_vec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + step * i));
+
+    __m128i lo = _mm_srli_epi16(
+        _mm_add_epi16(
+            _mm_maddubs_epi16(_mm_unpacklo_epi8(r_vec, g_vec), rg_weights),
+            _mm_maddubs_epi16(_mm_unpacklo_epi8(g_vec, b_vec), gb_weights)),
+        8);
+    __m128i hi = _mm_srli_epi16(
+        _mm_add_epi16(
+            _mm_maddubs_epi16(_mm_unpackhi_epi8(r_vec, g_vec), rg_weights),
+            _mm_maddubs_epi16(_mm_unpackhi_epi8(g_vec, b_vec), gb_weights)),
+        8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+
+  planar_2_gray_scalar(r + step * tile, g + step * tile, b + step * tile,
+                       output + step * tile, count - step * tile);
+}
+
+// pmaddubsw with all weights 1 adds horizontal pairs of pixels, the block
+// sums stay far below the 16 bit limit
+TARGET_SSE41 inline __m128i box_pair_sums_sse41(const unsigned char *input) {
+  return _mm_maddubs_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(input)),
+      _mm_set1_epi8(1));
+}
+
+TARGET_SSE41 void box_2_gray_sse41(const unsigned char *input, size_t pitch,
+                                   unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i round = _mm_set1_epi16(2);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *p = input + 2 * step * i;
+    __m128i lo = _mm_add_epi16(box_pair_sums_sse41(p),
+                               box_pair_sums_sse41(p + pitch));
+    __m128i hi = _mm_add_epi16(box_pair_sums_sse41(p + 16),
+                               box_pair_sums_sse41(p + pitch + 16));
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 2);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 2);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+
+  box_gray_scalar<2>(input + 2 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+TARGET_SSE41 void box_4_gray_sse41(const unsigned char *input, size_t pitch,
+                                   unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i round = _mm_set1_epi16(8);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i sums[4];
+    for (size_t j = 0; j < 4; ++j) {
+      const unsigned char *p = input + 4 * step * i + 16 * j;
+      sums[j] = _mm_add_epi16(
+          _mm_add_epi16(box_pair_sums_sse41(p),
+                        box_pair_sums_sse41(p + pitch)),
+          _mm_add_epi16(box_pair_sums_sse41(p + 2 * pitch),
+                        box_pair_sums_sse41(p + 3 * pitch)));
+    }
+    __m128i lo = _mm_srli_epi16(
+        _mm_add_epi16(_mm_hadd_epi16(sums[0], sums[1]), round), 4);
+    __m128i hi = _mm_srli_epi16(
+        _mm_add_epi16(_mm_hadd_epi16(sums[2], sums[3]), round), 4);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+
+  box_gray_scalar<4>(input + 4 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+const GraySimdKernels kSse41Kernels = {
+    packed3_2_gray_sse41<ImageFormat::IMAGE_RGB8>,
+    packed4_2_gray_sse41<ImageFormat::IMAGE_RGBA8>,
+    packed3_2_gray_sse41<ImageFormat::IMAGE_BGR8>,
+    packed4_2_gray_sse41<ImageFormat::IMAGE_BGRA8>,
+    planar_2_gray_sse41,
+    box_2_gray_sse41,
+    box_4_gray_sse41};
+
+// ------------------------------------------------------------------ AVX2
+
+// weighted pair sums of 8 rgb pixels, lane 0 holds pixels 0..3 from byte 0,
+// lane 1 holds pixels 4..7 from byte 12 but is loaded from byte 8 so that no
+// byte past 24 is touched
+template <ImageFormat format>
+TARGET_AVX2 inline __m256i packed3_2_gray_avx2_load8(
+    const unsigned char *input) {
+  const __m256i shuffle =
+      _mm256_setr_m128i(gray_quad_shuffle_sse41<format>(0),
+                        gray_quad_shuffle_sse41<format>(4));
+  const __m256i weights = _mm256_set1_epi32(kGrayQuadWeights);
+
+  __m256i pixels = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(input))),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 8)), 1);
+  return _mm256_maddubs_epi16(_mm256_shuffle_epi8(pixels, shuffle), weights);
+}
+
+template <ImageFormat format>
+TARGET_AVX2 inline __m256i packed4_2_gray_avx2_load8(
+    const unsigned char *input) {
+  const __m256i shuffle =
+      _mm256_broadcastsi128_si256(gray_quad_shuffle_sse41<format>(0));
+  const __m256i weights = _mm256_set1_epi32(kGrayQuadWeights);
+
+  __m256i pixels =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input));
+  return _mm256_maddubs_epi16(_mm256_shuffle_epi8(pixels, shuffle), weights);
+}
+
+// combines the pair sums of 4 x 8 pixels into 32 gray values
+TARGET_AVX2 inline void packed_2_gray_avx2_store32(__m256i x0, __m256i x1,
+                                                   __m256i x2, __m256i x3,
+                                                   unsigned char *output) {
+  __m256i lo = _mm256_srli_epi16(_mm256_hadd_epi16(x0, x1), 8);
+  __m256i hi = _mm256_srli_epi16(_mm256_hadd_epi16(x2, x3), 8);
+
+  // packus interleaves 4 pixel groups across the two lanes
+  __m256i gray = _mm256_permutevar8x32_epi32(
+      _mm256_packus_epi16(lo, hi), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), gray);
+}
+
+template <ImageFormat format>
+TARGET_AVX2 void packed3_2_gray_avx2(const unsigned char *input,
+                                     unsigned char *output, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *src = input + 3 * step * i;
+    packed_2_gray_avx2_store32(packed3_2_gray_avx2_load8<format>(src),
+                               packed3_2_gray_avx2_load8<format>(src + 24),
+                               packed3_2_gray_avx2_load8<format>(src + 48),
+                               packed3_2_gray_avx2_load8<format>(src + 72),
+                               output + step * i);
+  }
+
+  packed_2_gray_scalar<format>(input + 3 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+template <ImageFormat format>
+TARGET_AVX2 void packed4_2_gray_avx2(const unsigned char *input,
+                                     unsigned char *output, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *src = input + 4 * step * i;
+    packed_2_gray_avx2_store32(packed4_2_gray_avx2_load8<format>(src),
+                               packed4_2_gray_avx2_load8<format>(src + 32),
+                               packed4_2_gray_avx2_load8<format>(src + 64),
+                               packed4_2_gray_avx2_load8<format>(src + 96),
+                               output + step * i);
+  }
+
+  packed_2_gray_scalar<format>(input + 4 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+TARGET_AVX2 void planar_2_gray_avx2(const unsigned char *r,
+                                    const unsigned char *g,
+                                    const unsigned char *b,
+                                    unsigned char *output, size_t count) {
+  const __m256i rg_weights = _mm256_set1_epi16(kGrayRgWeights);
+  const __m256i gb_weights = _mm256_set1_epi16(kGrayGbWeights);
+
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m256i r_vec =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + step * i));
+    __m256i g_vec =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(g + step * i));
+    __m256i b_vec =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + step * i));
+
+    // unpack and pack both work per lane, so the pixel order is preserved
+    __m256i lo = _mm256_srli_epi16(
+        _mm256_add_epi16(
+            _mm256_maddubs_epi16(_mm256_unpacklo_epi8(r_vec, g_vec),
+                                 rg_weights),
+            _mm256_maddubs_epi16(_mm256_unpacklo_epi8(g_vec, b_vec),
+                                 gb_weights)),
+        8);
+    __m256i hi = _mm256_srli_epi16(
+        _mm256_add_epi16(
+            _mm256_maddubs_epi16(_mm256_unpackhi_epi8(r_vec, g_vec),
+                                 rg_weights),
+            _mm256_maddubs_epi16(_mm256_unpackhi_epi8(g_vec, b_vec),
+                                 gb_weights)),
+        8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + step * i),
+                        _mm256_packus_epi16(lo, hi));
+  }
+
+  planar_2_gray_scalar(r + step * tile, g + step * tile, b + step * tile,
+                       output + step * tile, count - step * tile);
+}
+
+TARGET_AVX2 inline __m256i box_pair_sums_avx2(const unsigned char *input) {
+  return _mm256_maddubs_epi16(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input)),
+      _mm256_set1_epi8(1));
+}
+
+TARGET_AVX2 void box_2_gray_avx2(const unsigned char *input, size_t pitch,
+                                 unsigned char *output, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+  const __m256i round = _mm256_set1_epi16(2);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *p = input + 2 * step * i;
+    __m256i lo = _mm256_add_epi16(box_pair_sums_avx2(p),
+                                  box_pair_sums_avx2(p + pitch));
+    __m256i hi = _mm256_add_epi16(box_pair_sums_avx2(p + 32),
+                                  box_pair_sums_avx2(p + pitch + 32));
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), 2);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), 2);
+    // packus interleaves 8 pixel groups across the two lanes
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + step * i),
+                        _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi),
+                                                 _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+
+  box_gray_scalar<2>(input + 2 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+TARGET_AVX2 void box_4_gray_avx2(const unsigned char *input, size_t pitch,
+                                 unsigned char *output, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+  const __m256i round = _mm256_set1_epi16(8);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m256i sums[4];
+    for (size_t j = 0; j < 4; ++j) {
+      const unsigned char *p = input + 4 * step * i + 32 * j;
+      sums[j] = _mm256_add_epi16(
+          _mm256_add_epi16(box_pair_sums_avx2(p),
+                           box_pair_sums_avx2(p + pitch)),
+          _mm256_add_epi16(box_pair_sums_avx2(p + 2 * pitch),
+                           box_pair_sums_avx2(p + 3 * pitch)));
+    }
+    __m256i lo = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_hadd_epi16(sums[0], sums[1]), round), 4);
+    __m256i hi = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_hadd_epi16(sums[2], sums[3]), round), 4);
+    // hadd and packus both work per lane, which leaves 4 pixel groups
+    // interleaved like in packed_2_gray_avx2_store32
+    __m256i gray = _mm256_permutevar8x32_epi32(
+        _mm256_packus_epi16(lo, hi), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + step * i), gray);
+  }
+
+  box_gray_scalar<4>(input + 4 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+const GraySimdKernels kAvx2Kernels = {
+    packed3_2_gray_avx2<ImageFormat::IMAGE_RGB8>,
+    packed4_2_gray_avx2<ImageFormat::IMAGE_RGBA8>,
+    packed3_2_gray_avx2<ImageFormat::IMAGE_BGR8>,
+    packed4_2_gray_avx2<ImageFormat::IMAGE_BGRA8>,
+    planar_2_gray_avx2,
+    box_2_gray_avx2,
+    box_4_gray_avx2};
+
+// -------------------------------------------------------------- AVX-512BW
+
+// 16 pixels, one 4 pixel group per lane, shuffle expands every pixel of a
+// lane to its weighted (r, g, g, b) quad
+TARGET_AVX512BW inline __m128i packed_2_gray_avx512bw_16(__m512i pixels,
+                                                         __m512i shuffle) {
+  const __m512i weights = _mm512_set1_epi32(kGrayQuadWeights);
+  const __m512i ones = _mm512_set1_epi16(1);
+
+  __m512i sums = _mm512_madd_epi16(
+      _mm512_maddubs_epi16(_mm512_shuffle_epi8(pixels, shuffle), weights),
+      ones);
+  return _mm512_cvtepi32_epi8(_mm512_srli_epi32(sums, 8));
+}
+
+template <ImageFormat format>
+TARGET_AVX512BW void packed3_2_gray_avx512bw(const unsigned char *input,
+                                             unsigned char *output,
+                                             size_t count) {
+  // moves the 12 bytes of every 4 pixel group to the start of its own lane,
+  // the masked load never touches the 16 bytes past the 48 byte block
+  const __m512i spread =
+      _mm512_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0, 6, 7, 8, 0, 9, 10, 11, 0);
+  const __m512i shuffle =
+      _mm512_broadcast_i32x4(gray_quad_shuffle_sse41<format>(0));
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m512i pixels = _mm512_permutexvar_epi32(
+        spread, _mm512_maskz_loadu_epi32(0x0fff, input + 3 * step * i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + step * i),
+                     packed_2_gray_avx512bw_16(pixels, shuffle));
+  }
+
+  packed_2_gray_scalar<format>(input + 3 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+template <ImageFormat format>
+TARGET_AVX512BW void packed4_2_gray_avx512bw(const unsigned char *input,
+                                             unsigned char *output,
+                                             size_t count) {
+  const __m512i shuffle =
+      _mm512_broadcast_i32x4(gray_quad_shuffle_sse41<format>(0));
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(output + step * i),
+        packed_2_gray_avx512bw_16(_mm512_loadu_si512(input + 4 * step * i),
+                                  shuffle));
+  }
+
+  packed_2_gray_scalar<format>(input + 4 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+TARGET_AVX512BW void planar_2_gray_avx512bw(const unsigned char *r,
+                                            const unsigned char *g,
+                                            const unsigned char *b,
+                                            unsigned char *output,
+                                            size_t count) {
+  const __m512i rg_weights = _mm512_set1_epi16(kGrayRgWeights);
+  const __m512i gb_weights = _mm512_set1_epi16(kGrayGbWeights);
+
+  constexpr size_t step = 64;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m512i r_vec = _mm512_loadu_si512(r + step * i);
+    __m512i g_vec = _mm512_loadu_si512(g + step * i);
+    __m512i b_vec = _mm512_loadu_si512(b + step * i);
+
+    __m512i lo = _mm512_srli_epi16(
+        _mm512_add_epi16(
+            _mm512_maddubs_epi16(_mm512_unpacklo_epi8(r_vec, g_vec),
+                                 rg_weights),
+            _mm512_maddubs_epi16(_mm512_unpacklo_epi8(g_vec, b_vec),
+                                 gb_weights)),
+        8);
+    __m512i hi = _mm512_srli_epi16(
+        _mm512_add_epi16(
+            _mm512_maddubs_epi16(_mm512_unpackhi_epi8(r_vec, g_vec),
+                                 rg_weights),
+            _mm512_maddubs_epi16(_mm512_unpackhi_epi8(g_vec, b_vec),
+                                 gb_weights)),
+        8);
+    _mm512_storeu_si512(output + step * i, _mm512_packus_epi16(lo, hi));
+  }
+
+  planar_2_gray_scalar(r + step * tile, g + step * tile, b + step * tile,
+                       output + step * tile, count - step * tile);
+}
+
+// the box filter is bound by the conversion before it, the AVX2 rows are
+// reused
+const GraySimdKernels kAvx512bwKernels = {
+    packed3_2_gray_avx512bw<ImageFormat::IMAGE_RGB8>,
+    packed4_2_gray_avx512bw<ImageFormat::IMAGE_RGBA8>,
+    packed3_2_gray_avx512bw<ImageFormat::IMAGE_BGR8>,
+    packed4_2_gray_avx512bw<ImageFormat::IMAGE_BGRA8>,
+    planar_2_gray_avx512bw,
+    box_2_gray_avx2,
+    box_4_gray_avx2};
+
+#elif defined(__ARM_NEON__)
+
+// vld3q_u8/vld4q_u8 deinterleave the channels while loading, the weights are
+// accumulated with widening multiplies and narrowed back with vshrn
+inline uint8x16_t gray_neon_16(uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+  const uint8x8_t r_mul = vdup_n_u8(77);
+  const uint8x8_t g_mul = vdup_n_u8(150);
+  const uint8x8_t b_mul = vdup_n_u8(29);
+
+  uint16x8_t lo = vmull_u8(vget_low_u8(r), r_mul);
+  lo = vmlal_u8(lo, vget_low_u8(g), g_mul);
+  lo = vmlal_u8(lo, vget_low_u8(b), b_mul);
+
+  uint16x8_t hi = vmull_u8(vget_high_u8(r), r_mul);
+  hi = vmlal_u8(hi, vget_high_u8(g), g_mul);
+  hi = vmlal_u8(hi, vget_high_u8(b), b_mul);
+
+  return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+template <ImageFormat format>
+void packed3_2_gray_neon(const unsigned char *input, unsigned char *output,
+                         size_t count) {
+  using traits = ImageFormatType<format>;
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x3_t pixels = vld3q_u8(input + 3 * step * i);
+    vst1q_u8(output + step * i,
+             gray_neon_16(pixels.val[traits::red], pixels.val[traits::green],
+                          pixels.val[traits::blue]));
+  }
+
+  packed_2_gray_scalar<format>(input + 3 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+template <ImageFormat format>
+void packed4_2_gray_neon(const unsigned char *input, unsigned char *output,
+                         size_t count) {
+  using traits = ImageFormatType<format>;
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x4_t pixels = vld4q_u8(input + 4 * step * i);
+    vst1q_u8(output + step * i,
+             gray_neon_16(pixels.val[traits::red], pixels.val[traits::green],
+                          pixels.val[traits::blue]));
+  }
+
+  packed_2_gray_scalar<format>(input + 4 * step * tile, output + step * tile,
+                               count - step * tile);
+}
+
+void planar_2_gray_neon(const unsigned char *r, const unsigned char *g,
+                        const unsigned char *b, unsigned char *output,
+                        size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    vst1q_u8(output + step * i,
+             gray_neon_16(vld1q_u8(r + step * i), vld1q_u8(g + step * i),
+                          vld1q_u8(b + step * i)));
+  }
+
+  planar_2_gray_scalar(r + step * tile, g + step * tile, b + step * tile,
+                       output + step * tile, count - step * tile);
+}
+
+// vpaddlq_u8/vpadalq_u8 add horizontal pairs while widening, vrshrn rounds
+// the block sums while narrowing
+void box_2_gray_neon(const unsigned char *input, size_t pitch,
+                     unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const unsigned char *p = input + 2 * step * i;
+    uint16x8_t lo = vpadalq_u8(vpaddlq_u8(vld1q_u8(p)), vld1q_u8(p + pitch));
+    uint16x8_t hi =
+        vpadalq_u8(vpaddlq_u8(vld1q_u8(p + 16)), vld1q_u8(p + pitch + 16));
+    vst1q_u8(output + step * i,
+             vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+  }
+
+  box_gray_scalar<2>(input + 2 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+void box_4_gray_neon(const unsigned char *input, size_t pitch,
+                     unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint16x8_t sums[4];
+    for (size_t j = 0; j < 4; ++j) {
+      const unsigned char *p = input + 4 * step * i + 16 * j;
+      sums[j] = vpaddlq_u8(vld1q_u8(p));
+      sums[j] = vpadalq_u8(sums[j], vld1q_u8(p + pitch));
+      sums[j] = vpadalq_u8(sums[j], vld1q_u8(p + 2 * pitch));
+      sums[j] = vpadalq_u8(sums[j], vld1q_u8(p + 3 * pitch));
+    }
+    vst1q_u8(output + step * i,
+             vcombine_u8(vrshrn_n_u16(vpaddq_u16(sums[0], sums[1]), 4),
+                         vrshrn_n_u16(vpaddq_u16(sums[2], sums[3]), 4)));
+  }
+
+  box_gray_scalar<4>(input + 4 * step * tile, pitch, output + step * tile,
+                     count - step * tile);
+}
+
+const GraySimdKernels kNeonKernels = {
+    packed3_2_gray_neon<ImageFormat::IMAGE_RGB8>,
+    packed4_2_gray_neon<ImageFormat::IMAGE_RGBA8>,
+    packed3_2_gray_neon<ImageFormat::IMAGE_BGR8>,
+    packed4_2_gray_neon<ImageFormat::IMAGE_BGRA8>,
+    planar_2_gray_neon,
+    box_2_gray_neon,
+    box_4_gray_neon};
+
+#endif
+
+} // namespace
+
+const GraySimdKernels &gray_simd_kernels() {
+  return select_simd_kernels(
+      kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+      X86_SIMD_KERNELS(kAvx2Kernels), X86_SIMD_KERNELS(kAvx512bwKernels),
+      NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
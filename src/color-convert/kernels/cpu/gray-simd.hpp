@@ -0,0 +1,70 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/common/image-format.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// converts count consecutive packed pixels with 3 or 4 channels
+using PackedGrayRowFunc = void (*)(const unsigned char *input,
+                                   unsigned char *output, size_t count);
+
+// converts count pixels from separate r, g and b planes
+using PlanarGrayRowFunc = void (*)(const unsigned char *r,
+                                   const unsigned char *g,
+                                   const unsigned char *b,
+                                   unsigned char *output, size_t count);
+
+// averages factor x factor blocks of factor rows of gray pixels, pitch bytes
+// apart, into count pixels, rounding to nearest
+using BoxGrayRowFunc = void (*)(const unsigned char *input, size_t pitch,
+                                unsigned char *output, size_t count);
+
+// All rows use the fixed point weights (77 * r + 150 * g + 29 * b) >> 8 and
+// produce identical results on every instruction set. The packed rows are
+// instantiated per channel order, none of them swizzles at run time.
+struct GraySimdKernels {
+  PackedGrayRowFunc rgb_packed;
+  PackedGrayRowFunc rgba_packed;
+  PackedGrayRowFunc bgr_packed;
+  PackedGrayRowFunc bgra_packed;
+  PlanarGrayRowFunc planar;
+  BoxGrayRowFunc box_2;
+  BoxGrayRowFunc box_4;
+};
+
+// the variant selected by cpu_isa()
+const GraySimdKernels &gray_simd_kernels();
+
+// the packed row of kernels for format, nullptr if it is not a packed 8 bit
+// RGB or BGR format
+inline PackedGrayRowFunc packed_gray_row(const GraySimdKernels &kernels,
+                                         ImageFormat format) {
+  switch (format) {
+  case ImageFormat::IMAGE_RGB8:
+    return kernels.rgb_packed;
+  case ImageFormat::IMAGE_RGBA8:
+    return kernels.rgba_packed;
+  case ImageFormat::IMAGE_BGR8:
+    return kernels.bgr_packed;
+  case ImageFormat::IMAGE_BGRA8:
+    return kernels.bgra_packed;
+  default:
+    return nullptr;
+  }
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,177 @@
+#include "normalize.hpp"
+#include "float-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+// the float format with the channels of a uint8 format
+ImageFormat float_format(ImageFormat format) {
+  switch (format) {
+  case ImageFormat::IMAGE_RGB8:
+    return ImageFormat::IMAGE_RGB32F;
+  case ImageFormat::IMAGE_RGBA8:
+    return ImageFormat::IMAGE_RGBA32F;
+  case ImageFormat::IMAGE_BGR8:
+    return ImageFormat::IMAGE_BGR32F;
+  case ImageFormat::IMAGE_BGRA8:
+    return ImageFormat::IMAGE_BGRA32F;
+  case ImageFormat::IMAGE_GRAY8:
+    return ImageFormat::IMAGE_GRAY32F;
+  default:
+    return ImageFormat::IMAGE_UNKNOWN;
+  }
+}
+
+bool valid_normalize(const ConstImageView &input, const ImageView &output) {
+  return (float_format(input.format) != ImageFormat::IMAGE_UNKNOWN &&
+          float_format(input.format) == output.format) ||
+         (float_format(output.format) != ImageFormat::IMAGE_UNKNOWN &&
+          float_format(output.format) == input.format);
+}
+
+// The samples of a row: planes runs of count samples, one run per plane.
+struct SampleRows {
+  int planes;
+  size_t count;
+};
+
+SampleRows sample_rows(const ConstImageView &input) {
+  const int channels = static_cast<int>(image_format_channels(input.format));
+  if (input.layout == MemLayout::Planar) {
+    return {channels, static_cast<size_t>(input.width)};
+  }
+  return {1, static_cast<size_t>(input.width) * channels};
+}
+
+void u8_2_f32_native(const unsigned char *input, float *output, size_t count,
+                     float scale, float offset) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = input[i] * scale + offset;
+  }
+}
+
+void f32_2_u8_native(const float *input, unsigned char *output, size_t count,
+                     float scale, float offset) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = detail::saturate_u8(input[i] * scale + offset);
+  }
+}
+
+// the row converters of one direction
+struct NormalizeRows {
+  detail::U8ToF32RowFunc u8_2_f32;
+  detail::F32ToU8RowFunc f32_2_u8;
+};
+
+const NormalizeRows kNativeRows = {u8_2_f32_native, f32_2_u8_native};
+
+NormalizeRows simd_rows() {
+  const auto &simd = detail::float_simd_kernels();
+  return {simd.u8_2_f32, simd.f32_2_u8};
+}
+
+void normalize_row(const NormalizeRows &rows, const ConstImageView &input,
+                   const ImageView &output, int y, float scale,
+                   float offset) {
+  const SampleRows samples = sample_rows(input);
+  const bool to_float =
+      image_format_to_base_type(output.format) == ImageBaseType::IMAGE_FLOAT;
+  for (int plane = 0; plane < samples.planes; ++plane) {
+    if (to_float) {
+      rows.u8_2_f32(input.row(y, plane),
+                    reinterpret_cast<float *>(output.row(y, plane)),
+                    samples.count, scale, offset);
+    } else {
+      rows.f32_2_u8(reinterpret_cast<const float *>(input.row(y, plane)),
+                    output.row(y, plane), samples.count, scale, offset);
+    }
+  }
+}
+
+bool normalize_serial(const NormalizeRows &rows, const ConstImageView &input,
+                      const ImageView &output, float scale, float offset) {
+  if (!valid_normalize(input, output)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    normalize_row(rows, input, output, y, scale, offset);
+  }
+  return true;
+}
+
+bool normalize_tbb(const NormalizeRows &rows, const ConstImageView &input,
+                   const ImageView &output, float scale, float offset) {
+  if (!valid_normalize(input, output)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      normalize_row(rows, input, output, y, scale, offset);
+    }
+  });
+  return true;
+}
+
+float default_scale(const ImageView &output) {
+  return image_format_to_base_type(output.format) == ImageBaseType::IMAGE_FLOAT
+             ? 1.0f / 255.0f
+             : 255.0f;
+}
+
+} // namespace
+
+bool normalize_native(const ConstImageView &input, const ImageView &output,
+                      float scale, float offset) {
+  return normalize_serial(kNativeRows, input, output, scale, offset);
+}
+
+bool normalize_parallel(const ConstImageView &input, const ImageView &output,
+                        float scale, float offset) {
+  return normalize_tbb(kNativeRows, input, output, scale, offset);
+}
+
+// the row kernels are chosen for the running CPU, see float-simd.cc
+bool normalize_simd(const ConstImageView &input, const ImageView &output,
+                    float scale, float offset) {
+  return normalize_serial(simd_rows(), input, output, scale, offset);
+}
+
+bool normalize_parallel_simd(const ConstImageView &input,
+                             const ImageView &output, float scale,
+                             float offset) {
+  return normalize_tbb(simd_rows(), input, output, scale, offset);
+}
+
+bool convert_depth_native(const ConstImageView &input,
+                          const ImageView &output) {
+  return normalize_native(input, output, default_scale(output), 0.0f);
+}
+
+bool convert_depth_parallel(const ConstImageView &input,
+                            const ImageView &output) {
+  return normalize_parallel(input, output, default_scale(output), 0.0f);
+}
+
+bool convert_depth_simd(const ConstImageView &input, const ImageView &output) {
+  return normalize_simd(input, output, default_scale(output), 0.0f);
+}
+
+bool convert_depth_parallel_simd(const ConstImageView &input,
+                                 const ImageView &output) {
+  return normalize_parallel_simd(input, output, default_scale(output), 0.0f);
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
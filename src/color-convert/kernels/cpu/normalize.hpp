@@ -0,0 +1,47 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// Conversions between the uint8 and the float format with the same channels
+// (RGB8 <-> RGB32F, RGBA8 <-> RGBA32F, BGR8 <-> BGR32F, BGRA8 <-> BGRA32F,
+// GRAY8 <-> GRAY32F) in either memory layout, the direction is taken from the
+// formats of the views. Every sample becomes sample * scale + offset, float
+// to uint8 rounds to nearest even and saturates.
+
+bool normalize_native(const ConstImageView &input, const ImageView &output,
+                      float scale, float offset);
+
+bool normalize_parallel(const ConstImageView &input, const ImageView &output,
+                        float scale, float offset);
+
+bool normalize_simd(const ConstImageView &input, const ImageView &output,
+                    float scale, float offset);
+
+bool normalize_parallel_simd(const ConstImageView &input,
+                             const ImageView &output, float scale,
+                             float offset);
+
+// the same with the default scaling, [0, 255] <-> [0, 1]
+
+bool convert_depth_native(const ConstImageView &input,
+                          const ImageView &output);
+
+bool convert_depth_parallel(const ConstImageView &input,
+                            const ImageView &output);
+
+bool convert_depth_simd(const ConstImageView &input, const ImageView &output);
+
+bool convert_depth_parallel_simd(const ConstImageView &input,
+                                 const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
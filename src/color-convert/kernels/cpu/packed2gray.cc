@@ -0,0 +1,114 @@
+#include "packed2gray.hpp"
+#include "gray-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+using NativeRowFunc = void (*)(const unsigned char *input,
+                               unsigned char *output, int width);
+
+template <ImageFormat format>
+void packed_row_2_gray_native(const unsigned char *input,
+                              unsigned char *output, int width) {
+  using traits = ImageFormatType<format>;
+  for (int x = 0; x < width; ++x) {
+    const unsigned char *pixel = input + traits::channels * x;
+    // Convert to grayscale using the luminosity method
+    output[x] = (unsigned char)(0.299 * pixel[traits::red] +
+                                0.587 * pixel[traits::green] +
+                                0.114 * pixel[traits::blue]);
+  }
+}
+
+NativeRowFunc native_row(ImageFormat format) {
+  switch (format) {
+  case ImageFormat::IMAGE_RGB8:
+    return packed_row_2_gray_native<ImageFormat::IMAGE_RGB8>;
+  case ImageFormat::IMAGE_RGBA8:
+    return packed_row_2_gray_native<ImageFormat::IMAGE_RGBA8>;
+  case ImageFormat::IMAGE_BGR8:
+    return packed_row_2_gray_native<ImageFormat::IMAGE_BGR8>;
+  case ImageFormat::IMAGE_BGRA8:
+    return packed_row_2_gray_native<ImageFormat::IMAGE_BGRA8>;
+  default:
+    return nullptr;
+  }
+}
+
+bool valid_gray_output(const ImageView &output) {
+  return output.format == ImageFormat::IMAGE_GRAY8;
+}
+
+} // namespace
+
+bool packed_2_gray_native(const ConstImageView &input,
+                          const ImageView &output) {
+  const auto row = native_row(input.format);
+  if (row == nullptr || !valid_gray_output(output)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    row(input.row(y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool packed_2_gray_parallel(const ConstImageView &input,
+                            const ImageView &output) {
+  const auto row = native_row(input.format);
+  if (row == nullptr || !valid_gray_output(output)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      row(input.row(y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+// the row kernel is chosen for the running CPU, see gray-simd.cc
+bool packed_2_gray_simd(const ConstImageView &input,
+                        const ImageView &output) {
+  const auto row =
+      detail::packed_gray_row(detail::gray_simd_kernels(), input.format);
+  if (row == nullptr || !valid_gray_output(output)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    row(input.row(y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool packed_2_gray_parallel_simd(const ConstImageView &input,
+                                 const ImageView &output) {
+  const auto row =
+      detail::packed_gray_row(detail::gray_simd_kernels(), input.format);
+  if (row == nullptr || !valid_gray_output(output)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      row(input.row(y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
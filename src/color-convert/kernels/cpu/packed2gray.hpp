@@ -0,0 +1,29 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// input is packed RGB8, RGBA8, BGR8 or BGRA8, output GRAY8. Every channel
+// order runs its own instantiation, see ImageFormatType.
+
+bool packed_2_gray_native(const ConstImageView &input,
+                          const ImageView &output);
+
+bool packed_2_gray_parallel(const ConstImageView &input,
+                            const ImageView &output);
+
+bool packed_2_gray_simd(const ConstImageView &input, const ImageView &output);
+
+bool packed_2_gray_parallel_simd(const ConstImageView &input,
+                                 const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,130 @@
+#include "parallel-rows.hpp"
+#include <atomic>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+// read on every parallel call, so the options are kept in atomics
+struct ParallelState {
+  std::atomic<int> grain_rows{0};
+  std::atomic<bool> affinity{true};
+
+  std::atomic<size_t> calls{0};
+  std::atomic<size_t> bands{0};
+  std::atomic<size_t> rows{0};
+  std::atomic<size_t> min_band_rows{0};
+  std::atomic<size_t> max_band_rows{0};
+};
+
+ParallelState &parallel_state() {
+  static ParallelState state;
+  return state;
+}
+
+} // namespace
+
+void set_parallel_options(const ParallelOptions &options) {
+  ParallelState &state = parallel_state();
+  state.grain_rows.store(std::max(options.grain_rows, 0));
+  state.affinity.store(options.affinity);
+}
+
+ParallelOptions parallel_options() {
+  ParallelState &state = parallel_state();
+  ParallelOptions options;
+  options.grain_rows = state.grain_rows.load(std::memory_order_relaxed);
+  options.affinity = state.affinity.load(std::memory_order_relaxed);
+  return options;
+}
+
+ParallelStats parallel_stats() {
+  ParallelState &state = parallel_state();
+  ParallelStats stats;
+  stats.calls = state.calls.load();
+  stats.bands = state.bands.load();
+  stats.rows = state.rows.load();
+  stats.min_band_rows = state.min_band_rows.load();
+  stats.max_band_rows = state.max_band_rows.load();
+  return stats;
+}
+
+void reset_parallel_stats() {
+  ParallelState &state = parallel_state();
+  state.calls.store(0);
+  state.bands.store(0);
+  state.rows.store(0);
+  state.min_band_rows.store(0);
+  state.max_band_rows.store(0);
+}
+
+namespace kernels {
+
+namespace detail {
+
+int band_rows(int width, int min_grain) {
+  int grain = parallel_state().grain_rows.load(std::memory_order_relaxed);
+  if (grain == 0) {
+    grain = kBandPixels / std::max(width, 1);
+  }
+  return std::max({grain, min_grain, 1});
+}
+
+namespace {
+
+struct AffinityState {
+  tbb::affinity_partitioner partitioner;
+  bool in_use = false;
+};
+
+AffinityState &thread_affinity_state() {
+  thread_local AffinityState state;
+  return state;
+}
+
+} // namespace
+
+ThreadAffinityPartitioner::ThreadAffinityPartitioner() {
+  AffinityState &state = thread_affinity_state();
+  if (!state.in_use) {
+    state.in_use = true;
+    partitioner_ = &state.partitioner;
+  }
+}
+
+ThreadAffinityPartitioner::~ThreadAffinityPartitioner() {
+  if (partitioner_ != nullptr) {
+    thread_affinity_state().in_use = false;
+  }
+}
+
+void record_parallel_call(const BandCounts &counts) {
+  ParallelState &state = parallel_state();
+  state.calls.fetch_add(1, std::memory_order_relaxed);
+  state.bands.fetch_add(counts.bands, std::memory_order_relaxed);
+  state.rows.fetch_add(counts.rows, std::memory_order_relaxed);
+
+  if (counts.bands == 0) {
+    return;
+  }
+  size_t min = state.min_band_rows.load(std::memory_order_relaxed);
+  while ((min == 0 || counts.min_band_rows < min) &&
+         !state.min_band_rows.compare_exchange_weak(
+             min, counts.min_band_rows, std::memory_order_relaxed)) {
+  }
+  size_t max = state.max_band_rows.load(std::memory_order_relaxed);
+  while (counts.max_band_rows > max &&
+         !state.max_band_rows.compare_exchange_weak(
+             max, counts.max_band_rows, std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "image-processing/color-convert/common/parallel-options.hpp"
+#include <algorithm>
+#include <stddef.h>
+#include <tbb/blocked_range.h>
+#include <tbb/combinable.h>
+#include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// target size of a default band, see ParallelOptions::grain_rows
+constexpr int kBandPixels = 1 << 14;
+
+// rows per band for a frame of width pixels, at least min_grain
+int band_rows(int width, int min_grain);
+
+// Lends the affinity partitioner of the calling thread, kept across calls.
+// A thread waiting in a parallel loop may run a task that calls a parallel
+// kernel itself (a batch, a pipeline stage); TBB forbids one partitioner in
+// two running loops, so the nested call gets none and uses auto_partitioner.
+class ThreadAffinityPartitioner {
+public:
+  ThreadAffinityPartitioner();
+  ~ThreadAffinityPartitioner();
+
+  ThreadAffinityPartitioner(const ThreadAffinityPartitioner &) = delete;
+  ThreadAffinityPartitioner &
+  operator=(const ThreadAffinityPartitioner &) = delete;
+
+  // nullptr if an enclosing call of this thread holds the partitioner
+  tbb::affinity_partitioner *get() const { return partitioner_; }
+
+private:
+  tbb::affinity_partitioner *partitioner_ = nullptr;
+};
+
+// the bands of one call, or of the calls of one thread
+struct BandCounts {
+  size_t bands = 0;
+  size_t rows = 0;
+  size_t min_band_rows = 0;
+  size_t max_band_rows = 0;
+
+  void add_band(size_t band_rows) {
+    ++bands;
+    rows += band_rows;
+    min_band_rows = min_band_rows == 0 ? band_rows
+                                       : std::min(min_band_rows, band_rows);
+    max_band_rows = std::max(max_band_rows, band_rows);
+  }
+
+  void add(const BandCounts &other) {
+    bands += other.bands;
+    rows += other.rows;
+    if (other.min_band_rows != 0) {
+      min_band_rows = min_band_rows == 0
+                          ? other.min_band_rows
+                          : std::min(min_band_rows, other.min_band_rows);
+    }
+    max_band_rows = std::max(max_band_rows, other.max_band_rows);
+  }
+};
+
+// adds the bands of one finished call to the ParallelStats
+void record_parallel_call(const BandCounts &counts);
+
+// Runs body(begin, end) on bands of the rows [0, rows) of a frame of width
+// pixels. Every parallel kernel goes through here, so ParallelOptions and
+// ParallelStats cover all of them. The workers count their bands in copies of
+// their own, the shared stats are updated once per call.
+template <typename Body>
+void parallel_rows(int rows, int width, const Body &body, int min_grain = 1) {
+  const tbb::blocked_range<int> range(0, rows, band_rows(width, min_grain));
+  tbb::combinable<BandCounts> counts;
+  const auto band = [&body, &counts](const tbb::blocked_range<int> &range) {
+    counts.local().add_band(static_cast<size_t>(range.end() - range.begin()));
+    body(range.begin(), range.end());
+  };
+
+  const ThreadAffinityPartitioner affinity;
+  if (parallel_options().affinity && affinity.get() != nullptr) {
+    tbb::parallel_for(range, band, *affinity.get());
+  } else {
+    tbb::parallel_for(range, band, tbb::auto_partitioner());
+  }
+
+  BandCounts total;
+  counts.combine_each([&total](const BandCounts &local) { total.add(local); });
+  record_parallel_call(total);
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
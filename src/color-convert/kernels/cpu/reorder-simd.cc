@@ -0,0 +1,175 @@
+#include "reorder-simd.hpp"
+#include "simd-dispatch.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+const ReorderSimdKernels kGenericKernels = reorder_kernels<ReorderScalar>();
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// ---------------------------------------------------------------- SSE4.1
+
+// pshufb mask moving the 4 pixels starting at byte first of the input to
+// the start of the vector in the output order, 3 channel outputs fill 12
+// bytes. Output alpha bytes without an input alpha are cleared.
+template <ImageFormat input_format, ImageFormat output_format>
+TARGET_SSE41 inline __m128i reorder_shuffle_sse41(int first) {
+  using src = ImageFormatType<input_format>;
+  using dst = ImageFormatType<output_format>;
+  alignas(16) signed char mask[16];
+  for (int i = 0; i < 16; ++i) {
+    mask[i] = -1;
+  }
+  for (int k = 0; k < 4; ++k) {
+    const int in = first + static_cast<int>(src::channels) * k;
+    const int out = static_cast<int>(dst::channels) * k;
+    mask[out + dst::red] = static_cast<signed char>(in + src::red);
+    mask[out + dst::green] = static_cast<signed char>(in + src::green);
+    mask[out + dst::blue] = static_cast<signed char>(in + src::blue);
+    if (dst::channels == 4 && src::channels == 4) {
+      mask[out + 3] = static_cast<signed char>(in + 3);
+    }
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+
+// 16 pixels as 4 groups of 4. 3 channel inputs are read at bytes 0, 12 and
+// 24, the last group 4 bytes early at 32 so that no byte past the 48 byte
+// block is read. 3 channel outputs are stitched from the 12 byte groups like
+// drop_alpha_sse41.
+template <ImageFormat input_format, ImageFormat output_format>
+struct ReorderSse41 {
+  TARGET_SSE41 static void run(const unsigned char *input,
+                               unsigned char *output, size_t count) {
+    constexpr size_t in_channels = ImageFormatType<input_format>::channels;
+    constexpr size_t out_channels = ImageFormatType<output_format>::channels;
+    const __m128i shuffle =
+        reorder_shuffle_sse41<input_format, output_format>(0);
+    const __m128i shuffle_last = reorder_shuffle_sse41<input_format,
+                                                       output_format>(
+        in_channels == 3 ? 4 : 0);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(
+        in_channels == 3 && out_channels == 4 ? 0xff000000u : 0u));
+
+    constexpr size_t step = 16;
+    size_t tile = count / step;
+
+    for (size_t i = 0; i < tile; ++i) {
+      const unsigned char *src = input + in_channels * step * i;
+      __m128i groups[4];
+      for (size_t j = 0; j < 3; ++j) {
+        groups[j] = _mm_shuffle_epi8(
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(src + 4 * in_channels * j)),
+            shuffle);
+      }
+      groups[3] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+              src + (in_channels == 3 ? 32 : 48))),
+          shuffle_last);
+
+      __m128i *dst =
+          reinterpret_cast<__m128i *>(output + out_channels * step * i);
+      if (out_channels == 4) {
+        for (size_t j = 0; j < 4; ++j) {
+          _mm_storeu_si128(dst + j, _mm_or_si128(groups[j], alpha));
+        }
+      } else {
+        _mm_storeu_si128(
+            dst, _mm_or_si128(groups[0], _mm_slli_si128(groups[1], 12)));
+        _mm_storeu_si128(dst + 1,
+                         _mm_or_si128(_mm_srli_si128(groups[1], 4),
+                                      _mm_slli_si128(groups[2], 8)));
+        _mm_storeu_si128(dst + 2,
+                         _mm_or_si128(_mm_srli_si128(groups[2], 8),
+                                      _mm_slli_si128(groups[3], 4)));
+      }
+    }
+
+    reorder_scalar<input_format, output_format>(
+        input + in_channels * step * tile, output + out_channels * step * tile,
+        count - step * tile);
+  }
+};
+
+// a single byte shuffle per 16 bytes is bound by memory bandwidth, wider
+// vectors would only add lane crossing fix-ups, so AVX2 and AVX-512 use the
+// SSE4.1 rows as well
+const ReorderSimdKernels kSse41Kernels = reorder_kernels<ReorderSse41>();
+
+#elif defined(__ARM_NEON__)
+
+// vld3q_u8/vld4q_u8 deinterleave the channels, storing them in another order
+// costs nothing but the register renaming
+template <ImageFormat input_format, ImageFormat output_format>
+struct ReorderNeon {
+  static void run(const unsigned char *input, unsigned char *output,
+                  size_t count) {
+    using src = ImageFormatType<input_format>;
+    using dst = ImageFormatType<output_format>;
+    constexpr size_t step = 16;
+    size_t tile = count / step;
+
+    for (size_t i = 0; i < tile; ++i) {
+      uint8x16_t r, g, b, a;
+      if (src::channels == 4) {
+        uint8x16x4_t pixels = vld4q_u8(input + 4 * step * i);
+        r = pixels.val[src::red];
+        g = pixels.val[src::green];
+        b = pixels.val[src::blue];
+        a = pixels.val[3];
+      } else {
+        uint8x16x3_t pixels = vld3q_u8(input + 3 * step * i);
+        r = pixels.val[src::red];
+        g = pixels.val[src::green];
+        b = pixels.val[src::blue];
+        a = vdupq_n_u8(255);
+      }
+      if (dst::channels == 4) {
+        uint8x16x4_t pixels;
+        pixels.val[dst::red] = r;
+        pixels.val[dst::green] = g;
+        pixels.val[dst::blue] = b;
+        pixels.val[3] = a;
+        vst4q_u8(output + 4 * step * i, pixels);
+      } else {
+        uint8x16x3_t pixels;
+        pixels.val[dst::red] = r;
+        pixels.val[dst::green] = g;
+        pixels.val[dst::blue] = b;
+        vst3q_u8(output + 3 * step * i, pixels);
+      }
+    }
+
+    reorder_scalar<input_format, output_format>(
+        input + src::channels * step * tile,
+        output + dst::channels * step * tile, count - step * tile);
+  }
+};
+
+const ReorderSimdKernels kNeonKernels = reorder_kernels<ReorderNeon>();
+
+#endif
+
+} // namespace
+
+const ReorderSimdKernels &reorder_simd_kernels() {
+  return select_simd_kernels(kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+                             nullptr, nullptr, NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/common/image-format.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// copies count packed pixels from one 8 bit RGB/BGR channel order to
+// another, alpha is kept when both sides have one and set to 255 when only
+// the output has one
+using ReorderRowFunc = void (*)(const unsigned char *input,
+                                unsigned char *output, size_t count);
+
+// the formats the reorder rows are instantiated for, in table order
+constexpr ImageFormat kReorderFormats[] = {
+    ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8,
+    ImageFormat::IMAGE_BGR8, ImageFormat::IMAGE_BGRA8};
+constexpr size_t kReorderFormatCount = 4;
+
+// rows[input][output], indexed like kReorderFormats
+struct ReorderSimdKernels {
+  ReorderRowFunc rows[kReorderFormatCount][kReorderFormatCount];
+};
+
+// Row<input_format, output_format>::run for every pair of kReorderFormats,
+// the channel offsets are template arguments of every row
+template <template <ImageFormat, ImageFormat> class Row>
+constexpr ReorderSimdKernels reorder_kernels() {
+  constexpr ImageFormat rgb = ImageFormat::IMAGE_RGB8;
+  constexpr ImageFormat rgba = ImageFormat::IMAGE_RGBA8;
+  constexpr ImageFormat bgr = ImageFormat::IMAGE_BGR8;
+  constexpr ImageFormat bgra = ImageFormat::IMAGE_BGRA8;
+  return {{{Row<rgb, rgb>::run, Row<rgb, rgba>::run, Row<rgb, bgr>::run,
+            Row<rgb, bgra>::run},
+           {Row<rgba, rgb>::run, Row<rgba, rgba>::run, Row<rgba, bgr>::run,
+            Row<rgba, bgra>::run},
+           {Row<bgr, rgb>::run, Row<bgr, rgba>::run, Row<bgr, bgr>::run,
+            Row<bgr, bgra>::run},
+           {Row<bgra, rgb>::run, Row<bgra, rgba>::run, Row<bgra, bgr>::run,
+            Row<bgra, bgra>::run}}};
+}
+
+// The plain loop: the native kernels, the generic SIMD variant (left to the
+// auto vectorizer, std::experimental::simd cannot deinterleave either) and
+// the tails of the vector loops.
+template <ImageFormat input_format, ImageFormat output_format>
+void reorder_scalar(const unsigned char *input, unsigned char *output,
+                    size_t count) {
+  using src = ImageFormatType<input_format>;
+  using dst = ImageFormatType<output_format>;
+  for (size_t i = 0; i < count; ++i) {
+    const unsigned char *in = input + src::channels * i;
+    unsigned char *out = output + dst::channels * i;
+    out[dst::red] = in[src::red];
+    out[dst::green] = in[src::green];
+    out[dst::blue] = in[src::blue];
+    if (dst::channels == 4) {
+      out[3] = src::channels == 4 ? in[3] : 255;
+    }
+  }
+}
+
+template <ImageFormat input_format, ImageFormat output_format>
+struct ReorderScalar {
+  static void run(const unsigned char *input, unsigned char *output,
+                  size_t count) {
+    reorder_scalar<input_format, output_format>(input, output, count);
+  }
+};
+
+// index of format in kReorderFormats, kReorderFormatCount if it is missing
+inline size_t reorder_format_index(ImageFormat format) {
+  size_t index = 0;
+  while (index < kReorderFormatCount && kReorderFormats[index] != format) {
+    ++index;
+  }
+  return index;
+}
+
+// the row of kernels for input_format -> output_format, nullptr if either
+// format has no row
+inline ReorderRowFunc reorder_row(const ReorderSimdKernels &kernels,
+                                  ImageFormat input_format,
+                                  ImageFormat output_format) {
+  const size_t in = reorder_format_index(input_format);
+  const size_t out = reorder_format_index(output_format);
+  if (in == kReorderFormatCount || out == kReorderFormatCount) {
+    return nullptr;
+  }
+  return kernels.rows[in][out];
+}
+
+// the variant selected by cpu_isa()
+const ReorderSimdKernels &reorder_simd_kernels();
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,84 @@
+#include "reorder.hpp"
+#include "reorder-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+const detail::ReorderSimdKernels kNativeKernels =
+    detail::reorder_kernels<detail::ReorderScalar>();
+
+} // namespace
+
+bool reorder_channels_native(const ConstImageView &input,
+                             const ImageView &output) {
+  const auto row =
+      detail::reorder_row(kNativeKernels, input.format, output.format);
+  if (row == nullptr) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    row(input.row(y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool reorder_channels_parallel(const ConstImageView &input,
+                               const ImageView &output) {
+  const auto row =
+      detail::reorder_row(kNativeKernels, input.format, output.format);
+  if (row == nullptr) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      row(input.row(y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+// the row kernel is chosen for the running CPU, see reorder-simd.cc
+bool reorder_channels_simd(const ConstImageView &input,
+                           const ImageView &output) {
+  const auto row = detail::reorder_row(detail::reorder_simd_kernels(),
+                                       input.format, output.format);
+  if (row == nullptr) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    row(input.row(y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool reorder_channels_parallel_simd(const ConstImageView &input,
+                                    const ImageView &output) {
+  const auto row = detail::reorder_row(detail::reorder_simd_kernels(),
+                                       input.format, output.format);
+  if (row == nullptr) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      row(input.row(y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
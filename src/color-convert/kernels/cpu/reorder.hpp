@@ -0,0 +1,31 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// input and output are packed RGB8, RGBA8, BGR8 or BGRA8. The channels are
+// reordered by a row instantiated for the pair of formats, alpha is kept or
+// set to 255 when the input has none.
+
+bool reorder_channels_native(const ConstImageView &input,
+                             const ImageView &output);
+
+bool reorder_channels_parallel(const ConstImageView &input,
+                               const ImageView &output);
+
+bool reorder_channels_simd(const ConstImageView &input,
+                           const ImageView &output);
+
+bool reorder_channels_parallel_simd(const ConstImageView &input,
+                                    const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -1,30 +1,26 @@
 #pragma once
 
+#include "image-processing/color-convert/common/image-view.hpp"
+
 namespace image_processing {
 
 namespace color_convert {
 
 namespace kernels {
 
-bool rgba_packed_2_gray_native(const unsigned char *input, unsigned char *output,
-                              int width, int height);
-
-bool rgba_packed_2_gray_parallel(const unsigned char *input,
-                                unsigned char *output, int width, int height);
-
-bool rgba_packed_2_gray_simd(const unsigned char *input, unsigned char *output,
-                            int width, int height);
+bool rgba_planar_2_gray_native(const ConstImageView &input,
+                               const ImageView &output);
 
-bool rgba_planar_2_gray_native(const unsigned char *input, unsigned char *output,
-                              int width, int height);
+bool rgba_planar_2_gray_parallel(const ConstImageView &input,
+                                 const ImageView &output);
 
-bool rgba_planar_2_gray_parallel(const unsigned char *input,
-                                unsigned char *output, int width, int height);
+bool rgba_planar_2_gray_simd(const ConstImageView &input,
+                             const ImageView &output);
 
-bool rgba_planar_2_gray_simd(const unsigned char *input, unsigned char *output,
-                            int width, int height);
+bool rgba_planar_2_gray_parallel_simd(const ConstImageView &input,
+                                      const ImageView &output);
 } // namespace kernels
 
 } // namespace color_convert
 
-} // namespace image_processing
\ No newline at end of file
+} // namespace image_processing
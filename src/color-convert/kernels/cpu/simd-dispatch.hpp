@@ -0,0 +1,88 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <type_traits>
+
+// The SIMD kernels are built for every variant with function level target
+// attributes rather than -m flags, and the variant is picked at run time
+// from cpu_isa().
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+// GCC 12 reports the _mm512_undefined_* placeholders used inside its own
+// AVX-512 intrinsics as uninitialized (GCC PR 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#define TARGET_AVX512BW __attribute__((target("avx512bw")))
+#endif
+
+// &kernels where the architecture has the variant, nullptr elsewhere, so the
+// kernels of the other architecture need not exist
+#if defined(__x86_64__) || defined(__i386__)
+#define X86_SIMD_KERNELS(kernels) (&(kernels))
+#define NEON_SIMD_KERNELS(kernels) nullptr
+#elif defined(__ARM_NEON__)
+#define X86_SIMD_KERNELS(kernels) nullptr
+#define NEON_SIMD_KERNELS(kernels) (&(kernels))
+#else
+#define X86_SIMD_KERNELS(kernels) nullptr
+#define NEON_SIMD_KERNELS(kernels) nullptr
+#endif
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// Returns the kernel set of the variant selected by cpu_isa(). A variant
+// without a set of its own (nullptr) falls back to the next narrower one:
+// AVX-512BW to AVX2 to SSE4.1 to generic, NEON to generic. The pointers are
+// not deduced, so nullptr can be passed for them.
+template <typename Kernels>
+const Kernels &select_simd_kernels(const Kernels &generic,
+                                   const std::remove_cv_t<Kernels> *sse41,
+                                   const std::remove_cv_t<Kernels> *avx2,
+                                   const std::remove_cv_t<Kernels> *avx512bw,
+                                   const std::remove_cv_t<Kernels> *neon) {
+  const Kernels *selected = nullptr;
+  switch (cpu_isa()) {
+  case CpuIsa::kAvx512bw:
+    selected = avx512bw;
+    if (selected != nullptr) {
+      break;
+    }
+    [[fallthrough]];
+  case CpuIsa::kAvx2:
+    selected = avx2;
+    if (selected != nullptr) {
+      break;
+    }
+    [[fallthrough]];
+  case CpuIsa::kSse41:
+    selected = sse41;
+    break;
+  case CpuIsa::kNeon:
+    selected = neon;
+    break;
+  default:
+    break;
+  }
+  return selected != nullptr ? *selected : generic;
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,445 @@
+#include "transpose-simd.hpp"
+#include "simd-dispatch.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+// pixels [begin, count), the SIMD rows finish their tail with it
+template <typename T, size_t channels>
+void split_scalar(const T *input, T *const *planes, size_t begin,
+                  size_t count) {
+  for (size_t i = begin; i < count; ++i) {
+    for (size_t c = 0; c < channels; ++c) {
+      planes[c][i] = input[channels * i + c];
+    }
+  }
+}
+
+template <typename T, size_t channels>
+void merge_scalar(const T *const *planes, T *output, size_t begin,
+                  size_t count) {
+  for (size_t i = begin; i < count; ++i) {
+    for (size_t c = 0; c < channels; ++c) {
+      output[channels * i + c] = planes[c][i];
+    }
+  }
+}
+
+// the fixed channel count lets the auto vectorizer unroll the inner loop
+template <typename T, size_t channels>
+void split_generic(const T *input, T *const *planes, size_t count) {
+  split_scalar<T, channels>(input, planes, 0, count);
+}
+
+template <typename T, size_t channels>
+void merge_generic(const T *const *planes, T *output, size_t count) {
+  merge_scalar<T, channels>(planes, output, 0, count);
+}
+
+const TransposeSimdKernels kGenericKernels = {
+    split_generic<unsigned char, 3>, split_generic<unsigned char, 4>,
+    merge_generic<unsigned char, 3>, merge_generic<unsigned char, 4>,
+    split_generic<float, 3>,         split_generic<float, 4>,
+    merge_generic<float, 3>,         merge_generic<float, 4>};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// ---------------------------------------------------------------- SSE4.1
+
+// pshufb mask gathering the samples of channel (of 3) that lie in the 16
+// byte vector `part` of a 48 byte block to their pixel positions, the three
+// masked parts of a channel are or'ed together
+TARGET_SSE41 inline __m128i split3_shuffle_sse41(int channel, int part) {
+  alignas(16) signed char mask[16];
+  for (int i = 0; i < 16; ++i) {
+    const int byte = 3 * i + channel;
+    mask[i] = static_cast<signed char>(byte / 16 == part ? byte % 16 : -1);
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+
+// the inverse: the samples of channel that go into output vector `part`
+TARGET_SSE41 inline __m128i merge3_shuffle_sse41(int channel, int part) {
+  alignas(16) signed char mask[16];
+  for (int i = 0; i < 16; ++i) {
+    const int byte = 16 * part + i;
+    mask[i] = static_cast<signed char>(byte % 3 == channel ? byte / 3 : -1);
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+
+TARGET_SSE41 void split3_u8_sse41(const unsigned char *input,
+                                  unsigned char *const *planes,
+                                  size_t count) {
+  __m128i shuffles[3][3];
+  for (int c = 0; c < 3; ++c) {
+    for (int part = 0; part < 3; ++part) {
+      shuffles[c][part] = split3_shuffle_sse41(c, part);
+    }
+  }
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src =
+        reinterpret_cast<const __m128i *>(input + 3 * step * i);
+    const __m128i a = _mm_loadu_si128(src);
+    const __m128i b = _mm_loadu_si128(src + 1);
+    const __m128i c = _mm_loadu_si128(src + 2);
+    for (int ch = 0; ch < 3; ++ch) {
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(planes[ch] + step * i),
+          _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, shuffles[ch][0]),
+                                    _mm_shuffle_epi8(b, shuffles[ch][1])),
+                       _mm_shuffle_epi8(c, shuffles[ch][2])));
+    }
+  }
+
+  split_scalar<unsigned char, 3>(input, planes, step * tile, count);
+}
+
+TARGET_SSE41 void merge3_u8_sse41(const unsigned char *const *planes,
+                                  unsigned char *output, size_t count) {
+  __m128i shuffles[3][3];
+  for (int c = 0; c < 3; ++c) {
+    for (int part = 0; part < 3; ++part) {
+      shuffles[c][part] = merge3_shuffle_sse41(c, part);
+    }
+  }
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i r = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(planes[0] + step * i));
+    const __m128i g = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(planes[1] + step * i));
+    const __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(planes[2] + step * i));
+    __m128i *dst = reinterpret_cast<__m128i *>(output + 3 * step * i);
+    for (int part = 0; part < 3; ++part) {
+      _mm_storeu_si128(
+          dst + part,
+          _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r, shuffles[0][part]),
+                                    _mm_shuffle_epi8(g, shuffles[1][part])),
+                       _mm_shuffle_epi8(b, shuffles[2][part])));
+    }
+  }
+
+  merge_scalar<unsigned char, 3>(planes, output, step * tile, count);
+}
+
+// every 16 byte vector is grouped by channel (4 samples each), a 4x4
+// transpose of the 32 bit groups then yields one vector per plane
+TARGET_SSE41 void split4_u8_sse41(const unsigned char *input,
+                                  unsigned char *const *planes,
+                                  size_t count) {
+  const __m128i group = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14,
+                                      3, 7, 11, 15);
+
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src =
+        reinterpret_cast<const __m128i *>(input + 4 * step * i);
+    __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128(src), group);
+    __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), group);
+    __m128i v2 = _mm_shuffle_epi8(_mm_loadu_si128(src + 2), group);
+    __m128i v3 = _mm_shuffle_epi8(_mm_loadu_si128(src + 3), group);
+    __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+    __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+    __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+    __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(planes[0] + step * i),
+                     _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(planes[1] + step * i),
+                     _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(planes[2] + step * i),
+                     _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(planes[3] + step * i),
+                     _mm_unpackhi_epi64(t2, t3));
+  }
+
+  split_scalar<unsigned char, 4>(input, planes, step * tile, count);
+}
+
+// (r, g) and (b, a) byte pairs, then the pairs are interleaved to pixels
+TARGET_SSE41 void merge4_u8_sse41(const unsigned char *const *planes,
+                                  unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i v[4];
+    for (int c = 0; c < 4; ++c) {
+      v[c] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(planes[c] + step * i));
+    }
+    const __m128i rg_lo = _mm_unpacklo_epi8(v[0], v[1]);
+    const __m128i rg_hi = _mm_unpackhi_epi8(v[0], v[1]);
+    const __m128i ba_lo = _mm_unpacklo_epi8(v[2], v[3]);
+    const __m128i ba_hi = _mm_unpackhi_epi8(v[2], v[3]);
+    __m128i *dst = reinterpret_cast<__m128i *>(output + 4 * step * i);
+    _mm_storeu_si128(dst, _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+  }
+
+  merge_scalar<unsigned char, 4>(planes, output, step * tile, count);
+}
+
+// 4 pixels, the blends pick every channel out of the 3 vectors like
+// rgb_packed_2_gray_f32_sse41, the shuffles restore the pixel order
+TARGET_SSE41 void split3_f32_sse41(const float *input, float *const *planes,
+                                   size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 3 * step * i;
+    __m128 a = _mm_loadu_ps(src);     // r0 g0 b0 r1
+    __m128 b = _mm_loadu_ps(src + 4); // g1 b1 r2 g2
+    __m128 c = _mm_loadu_ps(src + 8); // b2 r3 g3 b3
+    __m128 red = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);   // 0 3 2 1
+    __m128 green = _mm_blend_ps(_mm_blend_ps(b, a, 0x2), c, 0x4); // 1 0 3 2
+    __m128 blue = _mm_blend_ps(_mm_blend_ps(c, b, 0x2), a, 0x4);  // 2 1 0 3
+    _mm_storeu_ps(planes[0] + step * i,
+                  _mm_shuffle_ps(red, red, _MM_SHUFFLE(1, 2, 3, 0)));
+    _mm_storeu_ps(planes[1] + step * i,
+                  _mm_shuffle_ps(green, green, _MM_SHUFFLE(2, 3, 0, 1)));
+    _mm_storeu_ps(planes[2] + step * i,
+                  _mm_shuffle_ps(blue, blue, _MM_SHUFFLE(3, 0, 1, 2)));
+  }
+
+  split_scalar<float, 3>(input, planes, step * tile, count);
+}
+
+// the inverse of split3_f32_sse41: the channels are permuted into the orders
+// of the blends first
+TARGET_SSE41 void merge3_f32_sse41(const float *const *planes, float *output,
+                                   size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128 red = _mm_loadu_ps(planes[0] + step * i);
+    __m128 green = _mm_loadu_ps(planes[1] + step * i);
+    __m128 blue = _mm_loadu_ps(planes[2] + step * i);
+    red = _mm_shuffle_ps(red, red, _MM_SHUFFLE(1, 2, 3, 0));
+    green = _mm_shuffle_ps(green, green, _MM_SHUFFLE(2, 3, 0, 1));
+    blue = _mm_shuffle_ps(blue, blue, _MM_SHUFFLE(3, 0, 1, 2));
+    float *dst = output + 3 * step * i;
+    _mm_storeu_ps(dst, _mm_blend_ps(_mm_blend_ps(red, green, 0x2), blue, 0x4));
+    _mm_storeu_ps(dst + 4,
+                  _mm_blend_ps(_mm_blend_ps(green, blue, 0x2), red, 0x4));
+    _mm_storeu_ps(dst + 8,
+                  _mm_blend_ps(_mm_blend_ps(blue, red, 0x2), green, 0x4));
+  }
+
+  merge_scalar<float, 3>(planes, output, step * tile, count);
+}
+
+TARGET_SSE41 void split4_f32_sse41(const float *input, float *const *planes,
+                                   size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    const float *src = input + 4 * step * i;
+    __m128 p0 = _mm_loadu_ps(src);
+    __m128 p1 = _mm_loadu_ps(src + 4);
+    __m128 p2 = _mm_loadu_ps(src + 8);
+    __m128 p3 = _mm_loadu_ps(src + 12);
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    _mm_storeu_ps(planes[0] + step * i, p0);
+    _mm_storeu_ps(planes[1] + step * i, p1);
+    _mm_storeu_ps(planes[2] + step * i, p2);
+    _mm_storeu_ps(planes[3] + step * i, p3);
+  }
+
+  split_scalar<float, 4>(input, planes, step * tile, count);
+}
+
+TARGET_SSE41 void merge4_f32_sse41(const float *const *planes, float *output,
+                                   size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128 r = _mm_loadu_ps(planes[0] + step * i);
+    __m128 g = _mm_loadu_ps(planes[1] + step * i);
+    __m128 b = _mm_loadu_ps(planes[2] + step * i);
+    __m128 a = _mm_loadu_ps(planes[3] + step * i);
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    float *dst = output + 4 * step * i;
+    _mm_storeu_ps(dst, r);
+    _mm_storeu_ps(dst + 4, g);
+    _mm_storeu_ps(dst + 8, b);
+    _mm_storeu_ps(dst + 12, a);
+  }
+
+  merge_scalar<float, 4>(planes, output, step * tile, count);
+}
+
+// Each sample is loaded and stored once, already at 128 bits the rows wait
+// on memory rather than on the shuffle port, AVX2 and AVX-512 share them.
+const TransposeSimdKernels kSse41Kernels = {
+    split3_u8_sse41,  split4_u8_sse41,  merge3_u8_sse41,  merge4_u8_sse41,
+    split3_f32_sse41, split4_f32_sse41, merge3_f32_sse41, merge4_f32_sse41};
+
+#elif defined(__ARM_NEON__)
+
+// the structure loads and stores do the whole transpose
+void split3_u8_neon(const unsigned char *input, unsigned char *const *planes,
+                    size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x3_t pixels = vld3q_u8(input + 3 * step * i);
+    for (int c = 0; c < 3; ++c) {
+      vst1q_u8(planes[c] + step * i, pixels.val[c]);
+    }
+  }
+
+  split_scalar<unsigned char, 3>(input, planes, step * tile, count);
+}
+
+void split4_u8_neon(const unsigned char *input, unsigned char *const *planes,
+                    size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x4_t pixels = vld4q_u8(input + 4 * step * i);
+    for (int c = 0; c < 4; ++c) {
+      vst1q_u8(planes[c] + step * i, pixels.val[c]);
+    }
+  }
+
+  split_scalar<unsigned char, 4>(input, planes, step * tile, count);
+}
+
+void merge3_u8_neon(const unsigned char *const *planes, unsigned char *output,
+                    size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x3_t pixels;
+    for (int c = 0; c < 3; ++c) {
+      pixels.val[c] = vld1q_u8(planes[c] + step * i);
+    }
+    vst3q_u8(output + 3 * step * i, pixels);
+  }
+
+  merge_scalar<unsigned char, 3>(planes, output, step * tile, count);
+}
+
+void merge4_u8_neon(const unsigned char *const *planes, unsigned char *output,
+                    size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x4_t pixels;
+    for (int c = 0; c < 4; ++c) {
+      pixels.val[c] = vld1q_u8(planes[c] + step * i);
+    }
+    vst4q_u8(output + 4 * step * i, pixels);
+  }
+
+  merge_scalar<unsigned char, 4>(planes, output, step * tile, count);
+}
+
+void split3_f32_neon(const float *input, float *const *planes, size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x3_t pixels = vld3q_f32(input + 3 * step * i);
+    for (int c = 0; c < 3; ++c) {
+      vst1q_f32(planes[c] + step * i, pixels.val[c]);
+    }
+  }
+
+  split_scalar<float, 3>(input, planes, step * tile, count);
+}
+
+void split4_f32_neon(const float *input, float *const *planes, size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x4_t pixels = vld4q_f32(input + 4 * step * i);
+    for (int c = 0; c < 4; ++c) {
+      vst1q_f32(planes[c] + step * i, pixels.val[c]);
+    }
+  }
+
+  split_scalar<float, 4>(input, planes, step * tile, count);
+}
+
+void merge3_f32_neon(const float *const *planes, float *output,
+                     size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x3_t pixels;
+    for (int c = 0; c < 3; ++c) {
+      pixels.val[c] = vld1q_f32(planes[c] + step * i);
+    }
+    vst3q_f32(output + 3 * step * i, pixels);
+  }
+
+  merge_scalar<float, 3>(planes, output, step * tile, count);
+}
+
+void merge4_f32_neon(const float *const *planes, float *output,
+                     size_t count) {
+  constexpr size_t step = 4;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    float32x4x4_t pixels;
+    for (int c = 0; c < 4; ++c) {
+      pixels.val[c] = vld1q_f32(planes[c] + step * i);
+    }
+    vst4q_f32(output + 4 * step * i, pixels);
+  }
+
+  merge_scalar<float, 4>(planes, output, step * tile, count);
+}
+
+const TransposeSimdKernels kNeonKernels = {
+    split3_u8_neon,  split4_u8_neon,  merge3_u8_neon,  merge4_u8_neon,
+    split3_f32_neon, split4_f32_neon, merge3_f32_neon, merge4_f32_neon};
+
+#endif
+
+} // namespace
+
+const TransposeSimdKernels &transpose_simd_kernels() {
+  return select_simd_kernels(kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+                             nullptr, nullptr, NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
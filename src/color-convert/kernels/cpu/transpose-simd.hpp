@@ -0,0 +1,48 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+// splits count packed pixels into one plane per channel, planes holds 3 or 4
+// pointers depending on the row
+using SplitU8RowFunc = void (*)(const unsigned char *input,
+                                unsigned char *const *planes, size_t count);
+using SplitF32RowFunc = void (*)(const float *input, float *const *planes,
+                                 size_t count);
+
+// interleaves count pixels of one plane per channel into packed pixels
+using MergeU8RowFunc = void (*)(const unsigned char *const *planes,
+                                unsigned char *output, size_t count);
+using MergeF32RowFunc = void (*)(const float *const *planes, float *output,
+                                 size_t count);
+
+// The rows only move samples, every variant produces identical results.
+struct TransposeSimdKernels {
+  SplitU8RowFunc split3_u8;
+  SplitU8RowFunc split4_u8;
+  MergeU8RowFunc merge3_u8;
+  MergeU8RowFunc merge4_u8;
+  SplitF32RowFunc split3_f32;
+  SplitF32RowFunc split4_f32;
+  MergeF32RowFunc merge3_f32;
+  MergeF32RowFunc merge4_f32;
+};
+
+// the variant selected by cpu_isa()
+const TransposeSimdKernels &transpose_simd_kernels();
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
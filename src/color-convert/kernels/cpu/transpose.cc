@@ -0,0 +1,156 @@
+#include "transpose.hpp"
+#include "transpose-simd.hpp"
+#include "parallel-rows.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+bool valid_transpose(const ConstImageView &input, const ImageView &output) {
+  const size_t channels = image_format_channels(input.format);
+  const size_t sample =
+      image_format_pixel_size(input.format, MemLayout::Planar);
+  return input.format == output.format && input.layout != output.layout &&
+         (channels == 3 || channels == 4) && (sample == 1 || sample == 4) &&
+         !image_format_is_yuv(input.format) &&
+         !image_format_is_bayer(input.format);
+}
+
+bool is_float(ImageFormat format) {
+  return image_format_pixel_size(format, MemLayout::Planar) == sizeof(float);
+}
+
+template <typename T>
+void transpose_row_native(const ConstImageView &input, const ImageView &output,
+                          int y) {
+  const size_t channels = image_format_channels(input.format);
+  if (input.layout == MemLayout::Packed) {
+    const T *src = reinterpret_cast<const T *>(input.row(y));
+    for (size_t c = 0; c < channels; ++c) {
+      T *dst = reinterpret_cast<T *>(output.row(y, c));
+      for (int x = 0; x < input.width; ++x) {
+        dst[x] = src[channels * x + c];
+      }
+    }
+  } else {
+    T *dst = reinterpret_cast<T *>(output.row(y));
+    for (size_t c = 0; c < channels; ++c) {
+      const T *src = reinterpret_cast<const T *>(input.row(y, c));
+      for (int x = 0; x < input.width; ++x) {
+        dst[channels * x + c] = src[x];
+      }
+    }
+  }
+}
+
+void transpose_row_native(const ConstImageView &input, const ImageView &output,
+                          int y) {
+  if (is_float(input.format)) {
+    transpose_row_native<float>(input, output, y);
+  } else {
+    transpose_row_native<unsigned char>(input, output, y);
+  }
+}
+
+template <typename T, typename SplitRowFunc, typename MergeRowFunc>
+void transpose_row_simd(SplitRowFunc split, MergeRowFunc merge,
+                        const ConstImageView &input, const ImageView &output,
+                        int y) {
+  const size_t channels = image_format_channels(input.format);
+  if (input.layout == MemLayout::Packed) {
+    T *planes[4];
+    for (size_t c = 0; c < channels; ++c) {
+      planes[c] = reinterpret_cast<T *>(output.row(y, c));
+    }
+    split(reinterpret_cast<const T *>(input.row(y)), planes, input.width);
+  } else {
+    const T *planes[4];
+    for (size_t c = 0; c < channels; ++c) {
+      planes[c] = reinterpret_cast<const T *>(input.row(y, c));
+    }
+    merge(planes, reinterpret_cast<T *>(output.row(y)), input.width);
+  }
+}
+
+void transpose_row_simd(const detail::TransposeSimdKernels &kernels,
+                        const ConstImageView &input, const ImageView &output,
+                        int y) {
+  const bool four = image_format_channels(input.format) == 4;
+  if (is_float(input.format)) {
+    transpose_row_simd<float>(four ? kernels.split4_f32 : kernels.split3_f32,
+                              four ? kernels.merge4_f32 : kernels.merge3_f32,
+                              input, output, y);
+  } else {
+    transpose_row_simd<unsigned char>(
+        four ? kernels.split4_u8 : kernels.split3_u8,
+        four ? kernels.merge4_u8 : kernels.merge3_u8, input, output, y);
+  }
+}
+
+} // namespace
+
+bool transpose_layout_native(const ConstImageView &input,
+                             const ImageView &output) {
+  if (!valid_transpose(input, output)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    transpose_row_native(input, output, y);
+  }
+  return true;
+}
+
+bool transpose_layout_parallel(const ConstImageView &input,
+                               const ImageView &output) {
+  if (!valid_transpose(input, output)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      transpose_row_native(input, output, y);
+    }
+  });
+  return true;
+}
+
+// the row kernels are chosen for the running CPU, see transpose-simd.cc
+bool transpose_layout_simd(const ConstImageView &input,
+                           const ImageView &output) {
+  if (!valid_transpose(input, output)) {
+    return false;
+  }
+
+  const auto &kernels = detail::transpose_simd_kernels();
+  for (int y = 0; y < input.height; ++y) {
+    transpose_row_simd(kernels, input, output, y);
+  }
+  return true;
+}
+
+bool transpose_layout_parallel_simd(const ConstImageView &input,
+                                    const ImageView &output) {
+  if (!valid_transpose(input, output)) {
+    return false;
+  }
+
+  const auto &kernels = detail::transpose_simd_kernels();
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      transpose_row_simd(kernels, input, output, y);
+    }
+  });
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// input and output have the same 3 or 4 channel uint8 or float format and
+// opposite layouts: packed pixels are split into one plane per channel, or
+// the planes are interleaved into packed pixels. Samples are copied as is.
+
+bool transpose_layout_native(const ConstImageView &input,
+                             const ImageView &output);
+
+bool transpose_layout_parallel(const ConstImageView &input,
+                               const ImageView &output);
+
+bool transpose_layout_simd(const ConstImageView &input,
+                           const ImageView &output);
+
+bool transpose_layout_parallel_simd(const ConstImageView &input,
+                                    const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,493 @@
+#include "yuv-simd.hpp"
+#include "simd-dispatch.hpp"
+#include <stdint.h>
+#include <utility>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+namespace {
+
+// offsets of the samples in the 4 byte group of two pixels
+template <size_t y0, size_t u0, size_t v0> struct Yuv422Order {
+  static constexpr size_t y = y0;
+  static constexpr size_t u = u0;
+  static constexpr size_t v = v0;
+};
+
+using YuyvOrder = Yuv422Order<0, 1, 3>;
+using UyvyOrder = Yuv422Order<1, 0, 2>;
+using YvyuOrder = Yuv422Order<0, 3, 1>;
+
+template <bool bgr>
+void yuv_2_rgba_scalar(const unsigned char *y, const unsigned char *u,
+                       const unsigned char *v, unsigned char *output,
+                       size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    unsigned char *pixel = output + 4 * i;
+    yuv_2_rgb_fixed_point(y[i], u[i / 2], v[i / 2], &pixel[bgr ? 2 : 0],
+                          &pixel[1], &pixel[bgr ? 0 : 2]);
+    pixel[3] = 255;
+  }
+}
+
+void drop_alpha_scalar(const unsigned char *input, unsigned char *output,
+                       size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    output[3 * i] = input[4 * i];
+    output[3 * i + 1] = input[4 * i + 1];
+    output[3 * i + 2] = input[4 * i + 2];
+  }
+}
+
+void split_uv_scalar(const unsigned char *uv, unsigned char *u,
+                     unsigned char *v, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    u[i] = uv[2 * i];
+    v[i] = uv[2 * i + 1];
+  }
+}
+
+template <typename order>
+void split_yuv422_scalar(const unsigned char *input, unsigned char *y,
+                         unsigned char *u, unsigned char *v, size_t count) {
+  for (size_t i = 0; i < count / 2; ++i) {
+    y[2 * i] = input[4 * i + order::y];
+    y[2 * i + 1] = input[4 * i + order::y + 2];
+    u[i] = input[4 * i + order::u];
+    v[i] = input[4 * i + order::v];
+  }
+}
+
+const YuvSimdKernels kGenericKernels = {
+    yuv_2_rgba_scalar<false>,
+    yuv_2_rgba_scalar<true>,
+    drop_alpha_scalar,
+    split_uv_scalar,
+    split_yuv422_scalar<YuyvOrder>,
+    split_yuv422_scalar<UyvyOrder>,
+    split_yuv422_scalar<YvyuOrder>};
+
+#if defined(__x86_64__) || defined(__i386__)
+
+// the bias keeps blue, which can exceed the signed 16 bit range, positive so
+// that it is shifted as unsigned, 277 * 64 = 17728
+constexpr short kBlueBias = 277;
+
+// ---------------------------------------------------------------- SSE4.1
+
+// r, g and b of 8 pixels, luma already reduced by 16 and widened
+TARGET_SSE41 inline void yuv_2_rgb_sse41_8(__m128i y, __m128i u, __m128i v,
+                                           __m128i *r, __m128i *g,
+                                           __m128i *b) {
+  const __m128i luma =
+      _mm_srli_epi16(_mm_mullo_epi16(y, _mm_set1_epi16(149)), 1);
+  const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+  const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+  const __m128i round = _mm_set1_epi16(32);
+
+  *r = _mm_srai_epi16(
+      _mm_add_epi16(
+          _mm_add_epi16(luma, _mm_mullo_epi16(e, _mm_set1_epi16(102))), round),
+      6);
+  *g = _mm_srai_epi16(
+      _mm_add_epi16(
+          _mm_sub_epi16(
+              _mm_sub_epi16(luma, _mm_mullo_epi16(d, _mm_set1_epi16(25))),
+              _mm_mullo_epi16(e, _mm_set1_epi16(52))),
+          round),
+      6);
+  *b = _mm_sub_epi16(
+      _mm_srli_epi16(
+          _mm_add_epi16(
+              _mm_add_epi16(luma, _mm_mullo_epi16(d, _mm_set1_epi16(129))),
+              _mm_set1_epi16(32 + 64 * kBlueBias)),
+          6),
+      _mm_set1_epi16(kBlueBias));
+}
+
+template <bool bgr>
+TARGET_SSE41 void yuv_2_rgba_sse41(const unsigned char *y,
+                                   const unsigned char *u,
+                                   const unsigned char *v,
+                                   unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i alpha = _mm_set1_epi8(-1);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m128i luma = _mm_subs_epu8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + step * i)),
+        _mm_set1_epi8(16));
+    __m128i u_vec =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + step / 2 * i));
+    __m128i v_vec =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + step / 2 * i));
+    // every chroma sample covers two pixels
+    u_vec = _mm_unpacklo_epi8(u_vec, u_vec);
+    v_vec = _mm_unpacklo_epi8(v_vec, v_vec);
+
+    __m128i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    yuv_2_rgb_sse41_8(_mm_cvtepu8_epi16(luma), _mm_cvtepu8_epi16(u_vec),
+                      _mm_cvtepu8_epi16(v_vec), &r_lo, &g_lo, &b_lo);
+    yuv_2_rgb_sse41_8(_mm_cvtepu8_epi16(_mm_srli_si128(luma, 8)),
+                      _mm_cvtepu8_epi16(_mm_srli_si128(u_vec, 8)),
+                      _mm_cvtepu8_epi16(_mm_srli_si128(v_vec, 8)), &r_hi,
+                      &g_hi, &b_hi);
+    __m128i r = _mm_packus_epi16(r_lo, r_hi);
+    __m128i g = _mm_packus_epi16(g_lo, g_hi);
+    __m128i b = _mm_packus_epi16(b_lo, b_hi);
+    if (bgr) {
+      std::swap(r, b);
+    }
+
+    __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+    __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+    __m128i ba_lo = _mm_unpacklo_epi8(b, alpha);
+    __m128i ba_hi = _mm_unpackhi_epi8(b, alpha);
+    __m128i *dst = reinterpret_cast<__m128i *>(output + 4 * step * i);
+    _mm_storeu_si128(dst, _mm_unpacklo_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+  }
+
+  yuv_2_rgba_scalar<bgr>(y + step * tile, u + step / 2 * tile,
+                         v + step / 2 * tile, output + 4 * step * tile,
+                         count - step * tile);
+}
+
+// 16 pixels, every 4 pixels are shuffled to 12 bytes and the four pieces are
+// stitched into 3 vectors
+TARGET_SSE41 void drop_alpha_sse41(const unsigned char *input,
+                                   unsigned char *output, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                        -1, -1, -1, -1);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src =
+        reinterpret_cast<const __m128i *>(input + 4 * step * i);
+    __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(src), shuffle);
+    __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), shuffle);
+    __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(src + 2), shuffle);
+    __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(src + 3), shuffle);
+    __m128i *dst = reinterpret_cast<__m128i *>(output + 3 * step * i);
+    _mm_storeu_si128(dst, _mm_or_si128(a, _mm_slli_si128(b, 12)));
+    _mm_storeu_si128(dst + 1,
+                     _mm_or_si128(_mm_srli_si128(b, 4), _mm_slli_si128(c, 8)));
+    _mm_storeu_si128(dst + 2,
+                     _mm_or_si128(_mm_srli_si128(c, 8), _mm_slli_si128(d, 4)));
+  }
+
+  drop_alpha_scalar(input + 4 * step * tile, output + 3 * step * tile,
+                    count - step * tile);
+}
+
+TARGET_SSE41 void split_uv_sse41(const unsigned char *uv, unsigned char *u,
+                                 unsigned char *v, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const __m128i shuffle = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7,
+                                        9, 11, 13, 15);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src = reinterpret_cast<const __m128i *>(uv + 2 * step * i);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(src), shuffle);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(u + step * i),
+                     _mm_unpacklo_epi64(lo, hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(v + step * i),
+                     _mm_unpackhi_epi64(lo, hi));
+  }
+
+  split_uv_scalar(uv + 2 * step * tile, u + step * tile, v + step * tile,
+                  count - step * tile);
+}
+
+// 16 pixels, the shuffle moves the 8 luma samples of 8 pixels to the low half
+// and their 4 u and 4 v samples to the high half
+template <typename order>
+TARGET_SSE41 void split_yuv422_sse41(const unsigned char *input,
+                                     unsigned char *y, unsigned char *u,
+                                     unsigned char *v, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  constexpr char y0 = order::y;
+  constexpr char u0 = order::u;
+  constexpr char v0 = order::v;
+  const __m128i shuffle = _mm_setr_epi8(
+      y0, y0 + 2, y0 + 4, y0 + 6, y0 + 8, y0 + 10, y0 + 12, y0 + 14, u0,
+      u0 + 4, u0 + 8, u0 + 12, v0, v0 + 4, v0 + 8, v0 + 12);
+
+  for (size_t i = 0; i < tile; ++i) {
+    const __m128i *src =
+        reinterpret_cast<const __m128i *>(input + 2 * step * i);
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128(src), shuffle);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), shuffle);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(y + step * i),
+                     _mm_unpacklo_epi64(lo, hi));
+    // u0..3, u4..7, v0..3, v4..7
+    __m128i chroma = _mm_unpackhi_epi32(lo, hi);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(u + step / 2 * i), chroma);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(v + step / 2 * i),
+                     _mm_srli_si128(chroma, 8));
+  }
+
+  split_yuv422_scalar<order>(input + 2 * step * tile, y + step * tile,
+                             u + step / 2 * tile, v + step / 2 * tile,
+                             count - step * tile);
+}
+
+const YuvSimdKernels kSse41Kernels = {
+    yuv_2_rgba_sse41<false>,
+    yuv_2_rgba_sse41<true>,
+    drop_alpha_sse41,
+    split_uv_sse41,
+    split_yuv422_sse41<YuyvOrder>,
+    split_yuv422_sse41<UyvyOrder>,
+    split_yuv422_sse41<YvyuOrder>};
+
+// ------------------------------------------------------------------ AVX2
+
+TARGET_AVX2 inline void yuv_2_rgb_avx2_16(__m256i y, __m256i u, __m256i v,
+                                          __m256i *r, __m256i *g,
+                                          __m256i *b) {
+  const __m256i luma =
+      _mm256_srli_epi16(_mm256_mullo_epi16(y, _mm256_set1_epi16(149)), 1);
+  const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+  const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+  const __m256i round = _mm256_set1_epi16(32);
+
+  *r = _mm256_srai_epi16(
+      _mm256_add_epi16(
+          _mm256_add_epi16(luma, _mm256_mullo_epi16(e, _mm256_set1_epi16(102))),
+          round),
+      6);
+  *g = _mm256_srai_epi16(
+      _mm256_add_epi16(
+          _mm256_sub_epi16(
+              _mm256_sub_epi16(luma,
+                               _mm256_mullo_epi16(d, _mm256_set1_epi16(25))),
+              _mm256_mullo_epi16(e, _mm256_set1_epi16(52))),
+          round),
+      6);
+  *b = _mm256_sub_epi16(
+      _mm256_srli_epi16(
+          _mm256_add_epi16(
+              _mm256_add_epi16(luma,
+                               _mm256_mullo_epi16(d, _mm256_set1_epi16(129))),
+              _mm256_set1_epi16(32 + 64 * kBlueBias)),
+          6),
+      _mm256_set1_epi16(kBlueBias));
+}
+
+template <bool bgr>
+TARGET_AVX2 void yuv_2_rgba_avx2(const unsigned char *y,
+                                 const unsigned char *u,
+                                 const unsigned char *v,
+                                 unsigned char *output, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+  const __m256i alpha = _mm256_set1_epi8(-1);
+
+  for (size_t i = 0; i < tile; ++i) {
+    __m256i luma = _mm256_subs_epu8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(y + step * i)),
+        _mm256_set1_epi8(16));
+    __m128i u_vec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + step / 2 * i));
+    __m128i v_vec =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + step / 2 * i));
+
+    __m256i r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    yuv_2_rgb_avx2_16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(luma)),
+                      _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u_vec, u_vec)),
+                      _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v_vec, v_vec)),
+                      &r_lo, &g_lo, &b_lo);
+    yuv_2_rgb_avx2_16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(luma, 1)),
+                      _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(u_vec, u_vec)),
+                      _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(v_vec, v_vec)),
+                      &r_hi, &g_hi, &b_hi);
+    // lane 0 holds pixels 0..7 and 16..23, lane 1 pixels 8..15 and 24..31,
+    // the per lane unpacks below keep that order
+    __m256i r = _mm256_packus_epi16(r_lo, r_hi);
+    __m256i g = _mm256_packus_epi16(g_lo, g_hi);
+    __m256i b = _mm256_packus_epi16(b_lo, b_hi);
+    if (bgr) {
+      std::swap(r, b);
+    }
+
+    __m256i rg_lo = _mm256_unpacklo_epi8(r, g);
+    __m256i rg_hi = _mm256_unpackhi_epi8(r, g);
+    __m256i ba_lo = _mm256_unpacklo_epi8(b, alpha);
+    __m256i ba_hi = _mm256_unpackhi_epi8(b, alpha);
+    __m256i p0 = _mm256_unpacklo_epi16(rg_lo, ba_lo); // 0..3, 8..11
+    __m256i p1 = _mm256_unpackhi_epi16(rg_lo, ba_lo); // 4..7, 12..15
+    __m256i p2 = _mm256_unpacklo_epi16(rg_hi, ba_hi); // 16..19, 24..27
+    __m256i p3 = _mm256_unpackhi_epi16(rg_hi, ba_hi); // 20..23, 28..31
+
+    __m256i *dst = reinterpret_cast<__m256i *>(output + 4 * step * i);
+    _mm256_storeu_si256(dst, _mm256_permute2x128_si256(p0, p1, 0x20));
+    _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(p0, p1, 0x31));
+    _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(p2, p3, 0x20));
+    _mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+  }
+
+  yuv_2_rgba_scalar<bgr>(y + step * tile, u + step / 2 * tile,
+                         v + step / 2 * tile, output + 4 * step * tile,
+                         count - step * tile);
+}
+
+// the shuffles and stores around the arithmetic are cheap, they stay SSE4.1
+const YuvSimdKernels kAvx2Kernels = {
+    yuv_2_rgba_avx2<false>,
+    yuv_2_rgba_avx2<true>,
+    drop_alpha_sse41,
+    split_uv_sse41,
+    split_yuv422_sse41<YuyvOrder>,
+    split_yuv422_sse41<UyvyOrder>,
+    split_yuv422_sse41<YvyuOrder>};
+
+#elif defined(__ARM_NEON__)
+
+// luma already reduced by 16, d and e are the signed chroma samples
+inline void yuv_2_rgb_neon_8(uint8x8_t y, int16x8_t d, int16x8_t e,
+                             uint8x8_t *r, uint8x8_t *g, uint8x8_t *b) {
+  const int16x8_t luma =
+      vreinterpretq_s16_u16(vshrq_n_u16(vmull_u8(y, vdup_n_u8(149)), 1));
+  const int16x8_t round = vdupq_n_s16(32);
+
+  *r = vqshrun_n_s16(vaddq_s16(vmlaq_n_s16(luma, e, 102), round), 6);
+  *g = vqshrun_n_s16(
+      vaddq_s16(vmlsq_n_s16(vmlsq_n_s16(luma, d, 25), e, 52), round), 6);
+  // blue can exceed the signed 16 bit range, the bias (277 * 64) keeps it
+  // positive so that it is shifted as unsigned
+  uint16x8_t blue = vreinterpretq_u16_s16(
+      vaddq_s16(vmlaq_n_s16(luma, d, 129), vdupq_n_s16(32 + 17728)));
+  *b = vqmovun_s16(vsubq_s16(vreinterpretq_s16_u16(vshrq_n_u16(blue, 6)),
+                             vdupq_n_s16(277)));
+}
+
+template <bool bgr>
+void yuv_2_rgba_neon(const unsigned char *y, const unsigned char *u,
+                     const unsigned char *v, unsigned char *output,
+                     size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+  const uint8x8_t bias = vdup_n_u8(128);
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16_t luma = vqsubq_u8(vld1q_u8(y + step * i), vdupq_n_u8(16));
+    uint8x8_t u_vec = vld1_u8(u + step / 2 * i);
+    uint8x8_t v_vec = vld1_u8(v + step / 2 * i);
+    // every chroma sample covers two pixels
+    uint8x8x2_t u_pair = vzip_u8(u_vec, u_vec);
+    uint8x8x2_t v_pair = vzip_u8(v_vec, v_vec);
+
+    uint8x8_t r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+    yuv_2_rgb_neon_8(vget_low_u8(luma),
+                     vreinterpretq_s16_u16(vsubl_u8(u_pair.val[0], bias)),
+                     vreinterpretq_s16_u16(vsubl_u8(v_pair.val[0], bias)),
+                     &r_lo, &g_lo, &b_lo);
+    yuv_2_rgb_neon_8(vget_high_u8(luma),
+                     vreinterpretq_s16_u16(vsubl_u8(u_pair.val[1], bias)),
+                     vreinterpretq_s16_u16(vsubl_u8(v_pair.val[1], bias)),
+                     &r_hi, &g_hi, &b_hi);
+
+    uint8x16x4_t pixels;
+    pixels.val[bgr ? 2 : 0] = vcombine_u8(r_lo, r_hi);
+    pixels.val[1] = vcombine_u8(g_lo, g_hi);
+    pixels.val[bgr ? 0 : 2] = vcombine_u8(b_lo, b_hi);
+    pixels.val[3] = vdupq_n_u8(255);
+    vst4q_u8(output + 4 * step * i, pixels);
+  }
+
+  yuv_2_rgba_scalar<bgr>(y + step * tile, u + step / 2 * tile,
+                         v + step / 2 * tile, output + 4 * step * tile,
+                         count - step * tile);
+}
+
+void drop_alpha_neon(const unsigned char *input, unsigned char *output,
+                     size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x4_t pixels = vld4q_u8(input + 4 * step * i);
+    uint8x16x3_t rgb = {{pixels.val[0], pixels.val[1], pixels.val[2]}};
+    vst3q_u8(output + 3 * step * i, rgb);
+  }
+
+  drop_alpha_scalar(input + 4 * step * tile, output + 3 * step * tile,
+                    count - step * tile);
+}
+
+void split_uv_neon(const unsigned char *uv, unsigned char *u,
+                   unsigned char *v, size_t count) {
+  constexpr size_t step = 16;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x2_t pairs = vld2q_u8(uv + 2 * step * i);
+    vst1q_u8(u + step * i, pairs.val[0]);
+    vst1q_u8(v + step * i, pairs.val[1]);
+  }
+
+  split_uv_scalar(uv + 2 * step * tile, u + step * tile, v + step * tile,
+                  count - step * tile);
+}
+
+// vld4q_u8 splits 32 pixels by their position in the 4 byte group, the two
+// luma positions are interleaved again by vst2q_u8
+template <typename order>
+void split_yuv422_neon(const unsigned char *input, unsigned char *y,
+                       unsigned char *u, unsigned char *v, size_t count) {
+  constexpr size_t step = 32;
+  size_t tile = count / step;
+
+  for (size_t i = 0; i < tile; ++i) {
+    uint8x16x4_t samples = vld4q_u8(input + 2 * step * i);
+    uint8x16x2_t luma = {{samples.val[order::y], samples.val[order::y + 2]}};
+    vst2q_u8(y + step * i, luma);
+    vst1q_u8(u + step / 2 * i, samples.val[order::u]);
+    vst1q_u8(v + step / 2 * i, samples.val[order::v]);
+  }
+
+  split_yuv422_scalar<order>(input + 2 * step * tile, y + step * tile,
+                             u + step / 2 * tile, v + step / 2 * tile,
+                             count - step * tile);
+}
+
+const YuvSimdKernels kNeonKernels = {
+    yuv_2_rgba_neon<false>,
+    yuv_2_rgba_neon<true>,
+    drop_alpha_neon,
+    split_uv_neon,
+    split_yuv422_neon<YuyvOrder>,
+    split_yuv422_neon<UyvyOrder>,
+    split_yuv422_neon<YvyuOrder>};
+
+#endif
+
+} // namespace
+
+const YuvSimdKernels &yuv_simd_kernels() {
+  return select_simd_kernels(
+      kGenericKernels, X86_SIMD_KERNELS(kSse41Kernels),
+      X86_SIMD_KERNELS(kAvx2Kernels), nullptr, NEON_SIMD_KERNELS(kNeonKernels));
+}
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include <stddef.h>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace detail {
+
+inline unsigned char clamp_u8(int value) {
+  return static_cast<unsigned char>(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+// BT.601 limited range in 6 bit fixed point. Luma is scaled by 149 / 2
+// (1.164 * 64) after clamping it to 16 so that every intermediate value fits
+// the 16 bit lanes of the SIMD variants, which produce identical results.
+inline void yuv_2_rgb_fixed_point(int y, int u, int v, unsigned char *r,
+                                  unsigned char *g, unsigned char *b) {
+  const int luma = ((y > 16 ? y - 16 : 0) * 149) >> 1;
+  const int d = u - 128;
+  const int e = v - 128;
+  *r = clamp_u8((luma + 102 * e + 32) >> 6);
+  *g = clamp_u8((luma - 25 * d - 52 * e + 32) >> 6);
+  *b = clamp_u8((luma + 129 * d + 32) >> 6);
+}
+
+// converts count pixels with 4:2:x chroma, u and v hold (count + 1) / 2
+// samples, to 4 channel pixels with an opaque alpha
+using YuvRowFunc = void (*)(const unsigned char *y, const unsigned char *u,
+                            const unsigned char *v, unsigned char *output,
+                            size_t count);
+
+// copies count 4 channel pixels without their alpha channel
+using DropAlphaRowFunc = void (*)(const unsigned char *input,
+                                  unsigned char *output, size_t count);
+
+// splits count interleaved (u, v) pairs, the chroma rows of NV12
+using SplitUvRowFunc = void (*)(const unsigned char *uv, unsigned char *u,
+                                unsigned char *v, size_t count);
+
+// splits count pixels (count is even) of a packed 4:2:2 row into count luma
+// and count / 2 u and v samples
+using SplitYuv422RowFunc = void (*)(const unsigned char *input,
+                                    unsigned char *y, unsigned char *u,
+                                    unsigned char *v, size_t count);
+
+struct YuvSimdKernels {
+  YuvRowFunc yuv_2_rgba;
+  YuvRowFunc yuv_2_bgra;
+  DropAlphaRowFunc drop_alpha;
+  SplitUvRowFunc split_uv;
+  SplitYuv422RowFunc split_yuyv;
+  SplitYuv422RowFunc split_uyvy;
+  SplitYuv422RowFunc split_yvyu;
+};
+
+// the variant selected by cpu_isa()
+const YuvSimdKernels &yuv_simd_kernels();
+
+} // namespace detail
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
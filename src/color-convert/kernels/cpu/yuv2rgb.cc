@@ -0,0 +1,285 @@
+#include "yuv2rgb.hpp"
+#include "yuv-simd.hpp"
+#include "parallel-rows.hpp"
+#include <cstring>
+#include <stddef.h>
+#include <vector>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+namespace {
+
+// The samples of one row: pixel x has the luma sample y[x * y_step] and the
+// chroma samples u[x / 2 * chroma_step] and v[x / 2 * chroma_step].
+struct YuvRow {
+  const unsigned char *y;
+  size_t y_step;
+  const unsigned char *u;
+  const unsigned char *v;
+  size_t chroma_step;
+};
+
+bool valid_yuv_input(const ConstImageView &input) {
+  return input.data != nullptr && image_format_is_yuv(input.format) &&
+         input.width % 2 == 0 &&
+         (!image_format_is_yuv420(input.format) || input.height % 2 == 0);
+}
+
+bool valid_rgb_output(const ImageView &output) {
+  return output.format == ImageFormat::IMAGE_RGB8 ||
+         output.format == ImageFormat::IMAGE_RGBA8 ||
+         output.format == ImageFormat::IMAGE_BGR8 ||
+         output.format == ImageFormat::IMAGE_BGRA8;
+}
+
+// row y / 2 of the first (plane 0) or second (plane 1) chroma plane
+const unsigned char *chroma_row(const ConstImageView &input, int plane,
+                                int y) {
+  return input.chroma_plane(plane) + (y / 2) * input.chroma_pitch();
+}
+
+YuvRow yuv_row(const ConstImageView &input, int y) {
+  const unsigned char *row = input.row(y);
+  switch (input.format) {
+  case ImageFormat::IMAGE_I420:
+    return {row, 1, chroma_row(input, 0, y), chroma_row(input, 1, y), 1};
+  case ImageFormat::IMAGE_YV12:
+    return {row, 1, chroma_row(input, 1, y), chroma_row(input, 0, y), 1};
+  case ImageFormat::IMAGE_NV12: {
+    const unsigned char *uv = chroma_row(input, 0, y);
+    return {row, 1, uv, uv + 1, 2};
+  }
+  case ImageFormat::IMAGE_UYVY:
+    return {row + 1, 2, row, row + 2, 4};
+  case ImageFormat::IMAGE_YVYU:
+    return {row, 2, row + 3, row + 1, 4};
+  default: // IMAGE_YUYV
+    return {row, 2, row + 1, row + 3, 4};
+  }
+}
+
+template <size_t channels, bool bgr>
+void yuv_row_2_rgb_native(const YuvRow &row, unsigned char *output,
+                          int width) {
+  for (int x = 0; x < width; ++x) {
+    unsigned char *pixel = output + channels * x;
+    detail::yuv_2_rgb_fixed_point(
+        row.y[x * row.y_step], row.u[x / 2 * row.chroma_step],
+        row.v[x / 2 * row.chroma_step], &pixel[bgr ? 2 : 0], &pixel[1],
+        &pixel[bgr ? 0 : 2]);
+    if (channels == 4) {
+      pixel[3] = 255;
+    }
+  }
+}
+
+using YuvRowNativeFunc = void (*)(const YuvRow &row, unsigned char *output,
+                                  int width);
+
+YuvRowNativeFunc yuv_row_native_func(ImageFormat output_format) {
+  switch (output_format) {
+  case ImageFormat::IMAGE_RGB8:
+    return yuv_row_2_rgb_native<3, false>;
+  case ImageFormat::IMAGE_RGBA8:
+    return yuv_row_2_rgb_native<4, false>;
+  case ImageFormat::IMAGE_BGR8:
+    return yuv_row_2_rgb_native<3, true>;
+  default: // IMAGE_BGRA8
+    return yuv_row_2_rgb_native<4, true>;
+  }
+}
+
+void yuv_row_2_gray_native(const YuvRow &row, unsigned char *output,
+                           int width) {
+  for (int x = 0; x < width; ++x) {
+    output[x] = row.y[x * row.y_step];
+  }
+}
+
+detail::SplitYuv422RowFunc
+split_yuv422_func(const detail::YuvSimdKernels &simd, ImageFormat format) {
+  switch (format) {
+  case ImageFormat::IMAGE_UYVY:
+    return simd.split_uyvy;
+  case ImageFormat::IMAGE_YVYU:
+    return simd.split_yvyu;
+  default: // IMAGE_YUYV
+    return simd.split_yuyv;
+  }
+}
+
+// luma, u and v rows plus one row of 4 channel pixels
+size_t yuv_scratch_size(int width) { return static_cast<size_t>(width) * 6; }
+
+// The chroma of NV12 and all samples of the packed 4:2:2 formats are split
+// into planar rows in scratch first, then every format goes through the same
+// planar row converter. 3 channel outputs are produced as 4 channel pixels in
+// scratch and compacted.
+void yuv_row_2_rgb_simd(const detail::YuvSimdKernels &simd,
+                        const ConstImageView &input, const ImageView &output,
+                        int y, unsigned char *scratch) {
+  const size_t width = input.width;
+  unsigned char *y_scratch = scratch;
+  unsigned char *u_scratch = y_scratch + width;
+  unsigned char *v_scratch = u_scratch + width / 2;
+  unsigned char *rgba_scratch = v_scratch + width / 2;
+
+  YuvRow row = yuv_row(input, y);
+  const unsigned char *luma = row.y;
+  const unsigned char *u = row.u;
+  const unsigned char *v = row.v;
+  if (input.format == ImageFormat::IMAGE_NV12) {
+    simd.split_uv(row.u, u_scratch, v_scratch, width / 2);
+    u = u_scratch;
+    v = v_scratch;
+  } else if (!image_format_is_yuv420(input.format)) {
+    split_yuv422_func(simd, input.format)(input.row(y), y_scratch, u_scratch,
+                                          v_scratch, width);
+    luma = y_scratch;
+    u = u_scratch;
+    v = v_scratch;
+  }
+
+  const bool bgr = output.format == ImageFormat::IMAGE_BGR8 ||
+                   output.format == ImageFormat::IMAGE_BGRA8;
+  const auto convert = bgr ? simd.yuv_2_bgra : simd.yuv_2_rgba;
+  if (image_format_channels(output.format) == 4) {
+    convert(luma, u, v, output.row(y), width);
+  } else {
+    convert(luma, u, v, rgba_scratch, width);
+    simd.drop_alpha(rgba_scratch, output.row(y), width);
+  }
+}
+
+void yuv_row_2_gray_simd(const detail::YuvSimdKernels &simd,
+                         const ConstImageView &input, const ImageView &output,
+                         int y, unsigned char *scratch) {
+  const size_t width = input.width;
+  if (image_format_is_yuv420(input.format)) {
+    std::memcpy(output.row(y), input.row(y), width);
+    return;
+  }
+  split_yuv422_func(simd, input.format)(input.row(y), output.row(y), scratch,
+                                        scratch + width / 2, width);
+}
+
+} // namespace
+
+bool yuv_2_rgb_native(const ConstImageView &input, const ImageView &output) {
+  if (!valid_yuv_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const YuvRowNativeFunc convert = yuv_row_native_func(output.format);
+
+  for (int y = 0; y < input.height; ++y) {
+    convert(yuv_row(input, y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool yuv_2_rgb_parallel(const ConstImageView &input, const ImageView &output) {
+  if (!valid_yuv_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const YuvRowNativeFunc convert = yuv_row_native_func(output.format);
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      convert(yuv_row(input, y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+bool yuv_2_rgb_simd(const ConstImageView &input, const ImageView &output) {
+  if (!valid_yuv_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const auto &simd = detail::yuv_simd_kernels();
+  std::vector<unsigned char> scratch(yuv_scratch_size(input.width));
+
+  for (int y = 0; y < input.height; ++y) {
+    yuv_row_2_rgb_simd(simd, input, output, y, scratch.data());
+  }
+  return true;
+}
+
+bool yuv_2_rgb_parallel_simd(const ConstImageView &input,
+                             const ImageView &output) {
+  if (!valid_yuv_input(input) || !valid_rgb_output(output)) {
+    return false;
+  }
+  const auto &simd = detail::yuv_simd_kernels();
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    std::vector<unsigned char> scratch(yuv_scratch_size(input.width));
+    for (int y = begin; y != end; ++y) {
+      yuv_row_2_rgb_simd(simd, input, output, y, scratch.data());
+    }
+  });
+  return true;
+}
+
+bool yuv_2_gray_native(const ConstImageView &input, const ImageView &output) {
+  if (!valid_yuv_input(input)) {
+    return false;
+  }
+
+  for (int y = 0; y < input.height; ++y) {
+    yuv_row_2_gray_native(yuv_row(input, y), output.row(y), input.width);
+  }
+  return true;
+}
+
+bool yuv_2_gray_parallel(const ConstImageView &input,
+                         const ImageView &output) {
+  if (!valid_yuv_input(input)) {
+    return false;
+  }
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    for (int y = begin; y != end; ++y) {
+      yuv_row_2_gray_native(yuv_row(input, y), output.row(y), input.width);
+    }
+  });
+  return true;
+}
+
+bool yuv_2_gray_simd(const ConstImageView &input, const ImageView &output) {
+  if (!valid_yuv_input(input)) {
+    return false;
+  }
+  const auto &simd = detail::yuv_simd_kernels();
+  std::vector<unsigned char> scratch(input.width);
+
+  for (int y = 0; y < input.height; ++y) {
+    yuv_row_2_gray_simd(simd, input, output, y, scratch.data());
+  }
+  return true;
+}
+
+bool yuv_2_gray_parallel_simd(const ConstImageView &input,
+                              const ImageView &output) {
+  if (!valid_yuv_input(input)) {
+    return false;
+  }
+  const auto &simd = detail::yuv_simd_kernels();
+
+  detail::parallel_rows(input.height, input.width, [&](int begin, int end) {
+    std::vector<unsigned char> scratch(input.width);
+    for (int y = begin; y != end; ++y) {
+      yuv_row_2_gray_simd(simd, input, output, y, scratch.data());
+    }
+  });
+  return true;
+}
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+
+// Every YUV input format (YUYV, YVYU, UYVY, I420, YV12, NV12) is handled by
+// the same kernels, the formats of the views select the row converters. The
+// width must be even, the height too for the 4:2:0 formats.
+
+// output is RGB8, RGBA8, BGR8 or BGRA8
+bool yuv_2_rgb_native(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_rgb_parallel(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_rgb_simd(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_rgb_parallel_simd(const ConstImageView &input,
+                             const ImageView &output);
+
+// output is GRAY8, the luma samples are copied
+bool yuv_2_gray_native(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_gray_parallel(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_gray_simd(const ConstImageView &input, const ImageView &output);
+
+bool yuv_2_gray_parallel_simd(const ConstImageView &input,
+                              const ImageView &output);
+
+} // namespace kernels
+
+} // namespace color_convert
+
+} // namespace image_processing
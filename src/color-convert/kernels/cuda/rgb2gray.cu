@@ -1,6 +1,5 @@
 #include <cub/block/block_reduce.cuh>
 
-
 #include <cuda/atomic>
 
 #include <cstdio>
@@ -18,69 +17,74 @@ namespace detail {
 // TODO: use cudax::span<T> (in cccl)
 // see https://github.com/NVIDIA/cccl/tree/main/examples/cudax/vector_add
 __global__ void rgb_packed_2_gray_kernel(const unsigned char *input,
-                                         unsigned char *output, int width,
+                                         size_t input_pitch,
+                                         unsigned char *output,
+                                         size_t output_pitch, int width,
                                          int height) {
 
   int x = blockIdx.x * blockDim.x + threadIdx.x;
   int y = blockIdx.y * blockDim.y + threadIdx.y;
 
   if (x < width && y < height) {
-    int index = (y * width + x) * 3;
-    unsigned char r = input[index];
-    unsigned char g = input[index + 1];
-    unsigned char b = input[index + 2];
+    const unsigned char *pixel = input + y * input_pitch + x * 3;
+    unsigned char r = pixel[0];
+    unsigned char g = pixel[1];
+    unsigned char b = pixel[2];
 
-    output[y * width + x] =
+    output[y * output_pitch + x] =
         static_cast<unsigned char>(0.299f * r + 0.587f * g + 0.114f * b);
   }
 }
 } // namespace detail
 
-bool launch_rgb_packed_2_gray_cuda(const unsigned char *input,
-                                   unsigned char *output, int width,
-                                   int height) {
+bool launch_rgb_packed_2_gray_cuda(const ConstImageView &input,
+                                   const ImageView &output) {
 
   dim3 blockSize(32, 32);
-  dim3 gridSize((width + blockSize.x - 1) / blockSize.x,
-                (height + blockSize.y - 1) / blockSize.y);
-  detail::rgb_packed_2_gray_kernel<<<gridSize, blockSize>>>(input, output,
-                                                            width, height);
+  dim3 gridSize((input.width + blockSize.x - 1) / blockSize.x,
+                (input.height + blockSize.y - 1) / blockSize.y);
+  detail::rgb_packed_2_gray_kernel<<<gridSize, blockSize>>>(
+      input.data, input.pitch, output.data, output.pitch, input.width,
+      input.height);
   // TODO: hanle error
   cudaDeviceSynchronize();
   return true;
 }
+
 namespace detail {
 // TODO: use cudax::span<T> (in cccl)
 // see https://github.com/NVIDIA/cccl/tree/main/examples/cudax/vector_add
 __global__ void rgb_planar_2_gray_kernel(const unsigned char *input,
-                                         unsigned char *output, int width,
+                                         size_t input_pitch,
+                                         size_t input_plane_pitch,
+                                         unsigned char *output,
+                                         size_t output_pitch, int width,
                                          int height) {
 
   int x = blockIdx.x * blockDim.x + threadIdx.x;
   int y = blockIdx.y * blockDim.y + threadIdx.y;
-  int index = (y * width + x);
-  int planar_size = width * height;
 
   if (x < width && y < height) {
-    unsigned char r = input[index];
-    unsigned char g = input[index + planar_size];
-    unsigned char b = input[index + 2 * planar_size];
+    const unsigned char *pixel = input + y * input_pitch + x;
+    unsigned char r = pixel[0];
+    unsigned char g = pixel[input_plane_pitch];
+    unsigned char b = pixel[2 * input_plane_pitch];
 
-    output[y * width + x] =
+    output[y * output_pitch + x] =
         static_cast<unsigned char>(0.299f * r + 0.587f * g + 0.114f * b);
   }
 }
 
 } // namespace detail
-bool launch_rgb_planar_2_gray_cuda(const unsigned char *input,
-                                   unsigned char *output, int width,
-                                   int height) {
+bool launch_rgb_planar_2_gray_cuda(const ConstImageView &input,
+                                   const ImageView &output) {
 
   dim3 blockSize(32, 32);
-  dim3 gridSize((width + blockSize.x - 1) / blockSize.x,
-                (height + blockSize.y - 1) / blockSize.y);
-  detail::rgb_planar_2_gray_kernel<<<gridSize, blockSize>>>(input, output,
-                                                            width, height);
+  dim3 gridSize((input.width + blockSize.x - 1) / blockSize.x,
+                (input.height + blockSize.y - 1) / blockSize.y);
+  detail::rgb_planar_2_gray_kernel<<<gridSize, blockSize>>>(
+      input.data, input.pitch, input.plane_pitch, output.data, output.pitch,
+      input.width, input.height);
   // TODO: hanle error
   cudaDeviceSynchronize();
   return true;
@@ -88,4 +92,4 @@ bool launch_rgb_planar_2_gray_cuda(const unsigned char *input,
 
 } // namespace kernels
 } // namespace color_convert
-} // namespace image_processing
\ No newline at end of file
+} // namespace image_processing
@@ -1,17 +1,19 @@
 #pragma once
 
+#include "image-processing/color-convert/common/image-view.hpp"
+
 namespace image_processing {
 
 namespace color_convert {
 
 namespace kernels {
 
-bool launch_rgb_packed_2_gray_cuda(const unsigned char *input, unsigned char *output,
-                       int width, int height);
+bool launch_rgb_packed_2_gray_cuda(const ConstImageView &input,
+                                   const ImageView &output);
 
-bool launch_rgb_planar_2_gray_cuda(const unsigned char *input, unsigned char *output,
-                       int width, int height);
+bool launch_rgb_planar_2_gray_cuda(const ConstImageView &input,
+                                   const ImageView &output);
 
 } // namespace kernels
 } // namespace color_convert
-} // namespace image_processing
\ No newline at end of file
+} // namespace image_processing
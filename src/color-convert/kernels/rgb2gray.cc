@@ -1,9 +1,5 @@
 #include "image-processing/color-convert/kernels/rgb2gray.hpp"
-#include "cpu/rgb2gray.hpp"
-#include "cuda/rgb2gray.cuh"
-#include <assert.h>
-#include <iostream>
-#include <exception>
+#include "image-processing/color-convert/color-convert.hpp"
 
 namespace image_processing {
 
@@ -12,72 +8,27 @@ namespace color_convert {
 namespace kernels {
 bool rgb_2_gray(const unsigned char *input, unsigned char *output, int width,
                 int height, AlgoType algo_type, MemLayout mem_layout) {
-  if (input == nullptr || output == nullptr || width <= 0 || height <= 0) {
+  return color_convert(input, output, width, height, ImageFormat::IMAGE_RGB8,
+                       ImageFormat::IMAGE_GRAY8, algo_type, mem_layout);
+}
+
+bool rgb_2_gray(const ConstImageView &input, const ImageView &output,
+                AlgoType algo_type) {
+  if (input.format != ImageFormat::IMAGE_RGB8 ||
+      output.format != ImageFormat::IMAGE_GRAY8) {
     return false;
   }
-  bool ret = false;
-  switch (algo_type) {
-  case AlgoType::kNativeCpu:
-    switch (mem_layout) {
-    case MemLayout::Packed:
-      ret = rgb_packed_2_gray_native(input, output, width, height);
-      break;
-    case MemLayout::Planar:
-      ret = rgb_planar_2_gray_native(input, output, width, height);
-      break;
-    default:
-      assert(false);
-      break;
-    }
-    break;
+  return color_convert(input, output, algo_type);
+}
 
-  case AlgoType::kParallelCpu:
-    switch (mem_layout) {
-    case MemLayout::Packed:
-      ret = rgb_packed_2_gray_parallel(input, output, width, height);
-      break;
-    case MemLayout::Planar:
-      ret = rgb_planar_2_gray_parallel(input, output, width, height);
-      break;
-    default:
-      assert(false);
-      break;
-    }
-    break;
-  case AlgoType::kSimdCpu:
-    switch (mem_layout) {
-    case MemLayout::Packed:
-      ret = rgb_packed_2_gray_simd(input, output, width, height);
-      break;
-    case MemLayout::Planar:
-      ret = rgb_planar_2_gray_simd(input, output, width, height);
-      break;
-    default:
-      assert(false);
-      break;
-    }
-    break;
-  case AlgoType::kCuda:
-#if HAS_CUDA
-    switch (mem_layout) {
-    case MemLayout::Packed:
-      ret = launch_rgb_packed_2_gray_cuda(input, output, width, height);
-      break;
-    case MemLayout::Planar:
-      ret = launch_rgb_planar_2_gray_cuda(input, output, width, height);
-      break;
-    }
-    break;
-#else
-    throw std::runtime_error("Cuda not supported in this build.");
-#endif
-  default:
-    assert(false);
-    break;
+bool rgb_2_gray_downscale(const ConstImageView &input,
+                          const ImageView &output, int factor,
+                          AlgoType algo_type) {
+  if (input.format != ImageFormat::IMAGE_RGB8) {
+    return false;
   }
-
-  return ret;
+  return color_convert_downscale(input, output, factor, algo_type);
 }
 } // namespace kernels
 } // namespace color_convert
-} // namespace image_processing
\ No newline at end of file
+} // namespace image_processing
@@ -0,0 +1,28 @@
+#include "image-processing/color-convert/kernels/yuv2rgb.hpp"
+#include "image-processing/color-convert/color-convert.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace kernels {
+bool yuv_2_rgb(const ConstImageView &input, const ImageView &output,
+               AlgoType algo_type) {
+  if (!image_format_is_yuv(input.format) ||
+      output.format == ImageFormat::IMAGE_GRAY8) {
+    return false;
+  }
+  return color_convert(input, output, algo_type);
+}
+
+bool yuv_2_gray(const ConstImageView &input, const ImageView &output,
+                AlgoType algo_type) {
+  if (!image_format_is_yuv(input.format) ||
+      output.format != ImageFormat::IMAGE_GRAY8) {
+    return false;
+  }
+  return color_convert(input, output, algo_type);
+}
+} // namespace kernels
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,126 @@
+#include "image-processing/color-convert/pipeline.hpp"
+#include "image-processing/color-convert/execution-context.hpp"
+#include <algorithm>
+#include <atomic>
+#include <tbb/parallel_pipeline.h>
+#include <utility>
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace {
+
+struct PipelineSlot {
+  PipelineFrame frame;
+  bool failed = false;
+};
+
+} // namespace
+
+Pipeline::Pipeline(const PipelineOptions &options) : options_(options) {
+  options_.max_in_flight = std::max<size_t>(options_.max_in_flight, 1);
+}
+
+Pipeline &Pipeline::read(ReadStage stage) {
+  read_ = std::move(stage);
+  return *this;
+}
+
+Pipeline &Pipeline::convert(ImageFormat output_format, AlgoType algo_type) {
+  stages_.push_back([this, output_format, algo_type](PipelineFrame &frame) {
+    const ImageBuffer &input = frame.image;
+    ImageBuffer output = pool_.acquire(input.width(), input.height(),
+                                       output_format, input.layout());
+    if (!output || !color_convert(input.view(), output.view(), algo_type)) {
+      return false;
+    }
+    frame.image = std::move(output);
+    return true;
+  });
+  return *this;
+}
+
+Pipeline &Pipeline::then(Stage stage) {
+  stages_.push_back([stage](PipelineFrame &frame) {
+    stage(frame);
+    return true;
+  });
+  return *this;
+}
+
+Pipeline &Pipeline::write(Stage stage) {
+  write_ = std::move(stage);
+  return *this;
+}
+
+bool Pipeline::run() {
+  frames_ = 0;
+  if (!read_) {
+    return false;
+  }
+
+  // Frames are read and written in order and at most max_in_flight are
+  // alive, so frame n can reuse the slot of frame n - max_in_flight.
+  std::vector<PipelineSlot> slots(options_.max_in_flight);
+  std::atomic<bool> failed(false);
+  size_t next = 0;
+
+  tbb::filter<void, PipelineSlot *> chain = tbb::make_filter<
+      void, PipelineSlot *>(
+      tbb::filter_mode::serial_in_order,
+      [&](tbb::flow_control &control) -> PipelineSlot * {
+        if (failed.load(std::memory_order_relaxed)) {
+          control.stop();
+          return nullptr;
+        }
+        PipelineSlot *slot = &slots[next % slots.size()];
+        slot->frame.index = next;
+        slot->failed = false;
+        if (!read_(slot->frame)) {
+          control.stop();
+          return nullptr;
+        }
+        ++next;
+        return slot;
+      });
+
+  for (const auto &stage : stages_) {
+    chain = chain & tbb::make_filter<PipelineSlot *, PipelineSlot *>(
+                        tbb::filter_mode::parallel,
+                        [&stage, &failed](PipelineSlot *slot) {
+                          if (!slot->failed && !stage(slot->frame)) {
+                            slot->failed = true;
+                            failed.store(true, std::memory_order_relaxed);
+                          }
+                          return slot;
+                        });
+  }
+
+  const auto run_pipeline = [&] {
+    tbb::parallel_pipeline(
+        options_.max_in_flight,
+        chain & tbb::make_filter<PipelineSlot *, void>(
+                    tbb::filter_mode::serial_in_order,
+                    [&](PipelineSlot *slot) {
+                      if (!slot->failed) {
+                        if (write_) {
+                          write_(slot->frame);
+                        }
+                        ++frames_;
+                      }
+                      // back to the pool before the slot is read into again
+                      slot->frame.image = ImageBuffer();
+                    }));
+  };
+  if (options_.context != nullptr) {
+    options_.context->execute(run_pipeline);
+  } else {
+    run_pipeline();
+  }
+
+  return !failed.load();
+}
+
+} // namespace color_convert
+} // namespace image_processing
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-view.hpp"
+#include "image-processing/color-convert/kernel-stats.hpp"
+#ifdef IMAGE_PROCESSING_KERNEL_STATS
+#include <chrono>
+#endif
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace detail {
+
+#ifdef IMAGE_PROCESSING_KERNEL_STATS
+void record_kernel_call(KernelOperation operation, const ConstImageView &input,
+                        ImageFormat output_format, AlgoType algo_type,
+                        uint64_t nanoseconds);
+#endif
+
+// Returns kernel(). With IMAGE_PROCESSING_KERNEL_STATS a successful call is
+// timed and counted in the statistics of the calling thread, otherwise this
+// is the bare call.
+template <typename Kernel>
+bool run_recorded(KernelOperation operation, const ConstImageView &input,
+                  ImageFormat output_format, AlgoType algo_type,
+                  const Kernel &kernel) {
+#ifdef IMAGE_PROCESSING_KERNEL_STATS
+  const auto start = std::chrono::steady_clock::now();
+  const bool ok = kernel();
+  if (ok) {
+    const auto time = std::chrono::steady_clock::now() - start;
+    record_kernel_call(
+        operation, input, output_format, algo_type,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+  }
+  return ok;
+#else
+  (void)operation;
+  (void)input;
+  (void)output_format;
+  (void)algo_type;
+  return kernel();
+#endif
+}
+
+} // namespace detail
+
+} // namespace color_convert
+
+} // namespace image_processing
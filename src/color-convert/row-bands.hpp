@@ -0,0 +1,24 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-format.hpp"
+#include "image-processing/color-convert/common/mem-layout.hpp"
+
+namespace image_processing {
+
+namespace color_convert {
+
+namespace detail {
+
+// Rows of these frames convert independently: a band of rows is a region of
+// interest of the frame. Bayer needs the neighbouring rows and a 4:2:0 band
+// would have to start on an even row to share the chroma rows.
+inline bool converts_in_bands(ImageFormat format, MemLayout layout) {
+  return layout == MemLayout::Packed && !image_format_is_bayer(format) &&
+         !image_format_is_yuv420(format);
+}
+
+} // namespace detail
+
+} // namespace color_convert
+
+} // namespace image_processing
@@ -0,0 +1,190 @@
+#include "image-processing/color-convert/autotune.hpp"
+#include "image-processing/color-convert/color-convert.hpp"
+#include "gtest/gtest.h"
+#include <tbb/task_arena.h>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static const char *kCachePath = "/tmp/test_autotune.cache";
+
+static std::string read_file(const char *path) {
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+TEST(AutotuneTest, AutoConverts) {
+  autotune_set_cache_file(nullptr);
+  autotune_clear();
+
+  const int width = 160;
+  const int height = 90;
+  std::vector<unsigned char> input(width * height * 3);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  std::vector<unsigned char> expected(width * height);
+  std::vector<unsigned char> output(width * height);
+  ASSERT_TRUE(color_convert(input.data(), expected.data(), width, height,
+                            ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8,
+                            AlgoType::kNativeCpu));
+  // the first call tunes, the second one uses the result
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(color_convert(input.data(), output.data(), width, height,
+                              ImageFormat::IMAGE_RGB8,
+                              ImageFormat::IMAGE_GRAY8, AlgoType::kAuto));
+    for (size_t j = 0; j < output.size(); ++j) {
+      ASSERT_NEAR(output[j], expected[j], 1) << j;
+    }
+  }
+
+  // kAuto has no kernel of its own
+  EXPECT_EQ(color_convert_kernel(ImageFormat::IMAGE_RGB8,
+                                 ImageFormat::IMAGE_GRAY8, AlgoType::kAuto,
+                                 MemLayout::Packed),
+            nullptr);
+}
+
+TEST(AutotuneTest, CachePersisted) {
+  remove(kCachePath);
+  ASSERT_TRUE(autotune_set_cache_file(kCachePath));
+  autotune_clear();
+
+  std::vector<unsigned char> input(64 * 64 * 4, 1);
+  std::vector<unsigned char> output(64 * 64);
+  const ConstImageView rgba(input.data(), 64, 64, ImageFormat::IMAGE_RGBA8);
+  const ImageView gray(output.data(), 64, 64, ImageFormat::IMAGE_GRAY8);
+  const AlgoType tuned = autotune_algo_type(rgba, gray);
+  EXPECT_NE(tuned, AlgoType::kAuto);
+  EXPECT_NE(tuned, AlgoType::kCuda);
+
+  // 64 x 64 is bucket 12
+  const std::string cache = read_file(kCachePath);
+  EXPECT_NE(cache.find("rgba8 gray8 packed 12 "), std::string::npos) << cache;
+  EXPECT_NE(cache.find(algo_type_to_str(tuned)), std::string::npos);
+  autotune_set_cache_file(nullptr);
+}
+
+TEST(AutotuneTest, CacheLoadedWithoutTuning) {
+  const int threads = tbb::this_task_arena::max_concurrency();
+  {
+    // 100 x 10 is bucket 10, 40 x 40 bucket 11
+    std::ofstream file(kCachePath);
+    file << "# comment\nnot an entry\n"
+         << "rgb8 gray8 packed 10 " << threads << " native\n"
+         << "rgb8 gray8 packed 11 " << threads << " auto\n";
+  }
+  autotune_clear();
+  ASSERT_TRUE(autotune_set_cache_file(kCachePath));
+
+  // the SIMD kernels are faster, only the file can pick the native one
+  std::vector<unsigned char> input(40 * 40 * 3, 1);
+  std::vector<unsigned char> output(40 * 40);
+  EXPECT_EQ(autotune_algo_type(
+                ConstImageView(input.data(), 100, 10, ImageFormat::IMAGE_RGB8),
+                ImageView(output.data(), 100, 10, ImageFormat::IMAGE_GRAY8)),
+            AlgoType::kNativeCpu);
+  // an entry naming no CPU algorithm is ignored and tuned again
+  EXPECT_NE(autotune_algo_type(
+                ConstImageView(input.data(), 40, 40, ImageFormat::IMAGE_RGB8),
+                ImageView(output.data(), 40, 40, ImageFormat::IMAGE_GRAY8)),
+            AlgoType::kAuto);
+
+  autotune_set_cache_file(nullptr);
+  remove(kCachePath);
+}
+
+TEST(AutotuneTest, CacheKeepsOtherWriters) {
+  remove(kCachePath);
+  autotune_clear();
+  ASSERT_TRUE(autotune_set_cache_file(kCachePath));
+
+  // another process adds its result after this one loaded the file
+  const int threads = tbb::this_task_arena::max_concurrency();
+  {
+    std::ofstream file(kCachePath);
+    file << "bgr8 gray8 planar 30 " << threads << " native\n";
+  }
+  std::vector<unsigned char> input(64 * 64 * 3, 1);
+  std::vector<unsigned char> output(64 * 64);
+  autotune_algo_type(
+      ConstImageView(input.data(), 64, 64, ImageFormat::IMAGE_RGB8),
+      ImageView(output.data(), 64, 64, ImageFormat::IMAGE_GRAY8));
+
+  const std::string cache = read_file(kCachePath);
+  EXPECT_NE(cache.find("bgr8 gray8 planar 30 "), std::string::npos) << cache;
+  EXPECT_NE(cache.find("rgb8 gray8 packed 12 "), std::string::npos) << cache;
+
+  autotune_set_cache_file(nullptr);
+  remove(kCachePath);
+  remove((std::string(kCachePath) + ".lock").c_str());
+}
+
+TEST(AutotuneTest, AutoInOtherOperations) {
+  remove(kCachePath);
+  autotune_clear();
+  ASSERT_TRUE(autotune_set_cache_file(kCachePath));
+
+  const int width = 64;
+  const int height = 32;
+  std::vector<unsigned char> input(width * height * 3);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  const ConstImageView rgb(input.data(), width, height,
+                           ImageFormat::IMAGE_RGB8);
+
+  // the results match the native kernels of every operation
+  std::vector<unsigned char> expected(width * height * 3);
+  std::vector<unsigned char> output(width * height * 3);
+  const ImageView gray_expected(expected.data(), width / 2, height / 2,
+                                ImageFormat::IMAGE_GRAY8);
+  const ImageView gray(output.data(), width / 2, height / 2,
+                       ImageFormat::IMAGE_GRAY8);
+  ASSERT_TRUE(
+      color_convert_downscale(rgb, gray_expected, 2, AlgoType::kNativeCpu));
+  ASSERT_TRUE(color_convert_downscale(rgb, gray, 2, AlgoType::kAuto));
+  EXPECT_EQ(output, expected);
+
+  const ImageView planar_expected(expected.data(), width, height,
+                                  ImageFormat::IMAGE_RGB8, MemLayout::Planar);
+  const ImageView planar(output.data(), width, height, ImageFormat::IMAGE_RGB8,
+                         MemLayout::Planar);
+  ASSERT_TRUE(color_convert_layout(rgb, planar_expected, AlgoType::kNativeCpu));
+  ASSERT_TRUE(color_convert_layout(rgb, planar, AlgoType::kAuto));
+  EXPECT_EQ(output, expected);
+
+  std::vector<float> normalized_expected(width * height * 3);
+  std::vector<float> normalized(width * height * 3);
+  ASSERT_TRUE(color_convert_normalize(
+      rgb,
+      ImageView(reinterpret_cast<unsigned char *>(normalized_expected.data()),
+                width, height, ImageFormat::IMAGE_RGB32F),
+      0.5f, -1.0f, AlgoType::kNativeCpu));
+  ASSERT_TRUE(color_convert_normalize(
+      rgb,
+      ImageView(reinterpret_cast<unsigned char *>(normalized.data()), width,
+                height, ImageFormat::IMAGE_RGB32F),
+      0.5f, -1.0f, AlgoType::kAuto));
+  EXPECT_EQ(normalized, normalized_expected);
+
+  // every operation keeps a result of its own, 64 x 32 is bucket 11
+  const std::string cache = read_file(kCachePath);
+  EXPECT_NE(cache.find("downscale rgb8 gray8 packed 11 "), std::string::npos)
+      << cache;
+  EXPECT_NE(cache.find("layout rgb8 rgb8 packed 11 "), std::string::npos)
+      << cache;
+  EXPECT_NE(cache.find("normalize rgb8 rgb32f packed 11 "), std::string::npos)
+      << cache;
+  EXPECT_EQ(cache.find("\nrgb8 "), std::string::npos) << cache;
+
+  autotune_set_cache_file(nullptr);
+  remove(kCachePath);
+  remove((std::string(kCachePath) + ".lock").c_str());
+}
@@ -0,0 +1,197 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/kernels/bayer2rgb.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+// color filter of pixel (x, y): 'R', 'G' or 'B'
+static char bayer_color(ImageFormat format, int x, int y) {
+  const char *pattern = format == ImageFormat::IMAGE_BAYER_BGGR   ? "BGGR"
+                        : format == ImageFormat::IMAGE_BAYER_GBRG ? "GBRG"
+                        : format == ImageFormat::IMAGE_BAYER_GRBG ? "GRBG"
+                                                                  : "RGGB";
+  return pattern[(y % 2) * 2 + x % 2];
+}
+
+static int mirror(int index, int size) {
+  return index < 0 ? -index : index >= size ? 2 * size - 2 - index : index;
+}
+
+// Bilinear demosaic: every missing color is the rounded mean of the pixels of
+// that color in the 3x3 neighbourhood.
+static std::vector<unsigned char>
+expected_rgb(const std::vector<unsigned char> &bayer, int width, int height,
+             ImageFormat format, ImageFormat output_format) {
+  const size_t channels = image_format_channels(output_format);
+  const bool bgr = output_format == ImageFormat::IMAGE_BGR8 ||
+                   output_format == ImageFormat::IMAGE_BGRA8;
+  std::vector<unsigned char> rgb(width * height * channels);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      unsigned char *pixel = &rgb[(y * width + x) * channels];
+      const char colors[3] = {'R', 'G', 'B'};
+      for (int c = 0; c < 3; c++) {
+        int sum = 0;
+        int count = 0;
+        for (int dy = -1; dy <= 1; dy++) {
+          for (int dx = -1; dx <= 1; dx++) {
+            if (bayer_color(format, x + dx + 2, y + dy + 2) != colors[c]) {
+              continue;
+            }
+            sum += bayer[mirror(y + dy, height) * width +
+                         mirror(x + dx, width)];
+            count++;
+          }
+        }
+        if (bayer_color(format, x, y) == colors[c]) {
+          sum = bayer[y * width + x];
+          count = 1;
+        }
+        const int channel = bgr ? 2 - c : c;
+        pixel[channel] = static_cast<unsigned char>((sum + count / 2) / count);
+      }
+      if (channels == 4) {
+        pixel[3] = 255;
+      }
+    }
+  }
+  return rgb;
+}
+
+static std::vector<unsigned char> bayer_image(int width, int height) {
+  std::vector<unsigned char> bayer(width * height);
+  for (size_t i = 0; i < bayer.size(); i++) {
+    bayer[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  return bayer;
+}
+
+TEST(Bayer2RGBTest, FlatColor) {
+  const int width = 40;
+  const int height = 6;
+  for (ImageFormat format :
+       {ImageFormat::IMAGE_BAYER_BGGR, ImageFormat::IMAGE_BAYER_GBRG,
+        ImageFormat::IMAGE_BAYER_GRBG, ImageFormat::IMAGE_BAYER_RGGB}) {
+    std::vector<unsigned char> bayer(width * height);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        const char color = bayer_color(format, x, y);
+        bayer[y * width + x] = color == 'R' ? 200 : color == 'G' ? 100 : 50;
+      }
+    }
+    std::vector<unsigned char> rgb(width * height * 3);
+    ASSERT_TRUE(color_convert(bayer.data(), rgb.data(), width, height, format,
+                              ImageFormat::IMAGE_RGB8,
+                              AlgoType::kParallelSimdCpu));
+    for (size_t i = 0; i < rgb.size(); i += 3) {
+      ASSERT_EQ(rgb[i], 200) << i / 3;
+      ASSERT_EQ(rgb[i + 1], 100) << i / 3;
+      ASSERT_EQ(rgb[i + 2], 50) << i / 3;
+    }
+  }
+}
+
+TEST(Bayer2RGBTest, AllFormatsAndVariants) {
+  // wider than one vector of every variant with a scalar tail, taller than
+  // one parallel tile
+  const int width = 102;
+  const int height = 37;
+  const auto bayer = bayer_image(width, height);
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : {CpuIsa::kGeneric, CpuIsa::kSse41, CpuIsa::kAvx2,
+                     CpuIsa::kAvx512bw, CpuIsa::kNeon}) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat format :
+         {ImageFormat::IMAGE_BAYER_BGGR, ImageFormat::IMAGE_BAYER_GBRG,
+          ImageFormat::IMAGE_BAYER_GRBG, ImageFormat::IMAGE_BAYER_RGGB}) {
+      const ConstImageView input(bayer.data(), width, height, format);
+      for (ImageFormat output_format :
+           {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8,
+            ImageFormat::IMAGE_BGR8, ImageFormat::IMAGE_BGRA8}) {
+        const auto expected =
+            expected_rgb(bayer, width, height, format, output_format);
+        for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                              AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+          std::vector<unsigned char> output_image(expected.size());
+          ASSERT_TRUE(kernels::bayer_2_rgb(
+              input,
+              ImageView(output_image.data(), width, height, output_format),
+              algo));
+          EXPECT_EQ(output_image, expected)
+              << cpu_isa_to_str(isa) << " " << image_format_to_str(format)
+              << " -> " << image_format_to_str(output_format) << " algo "
+              << static_cast<int>(algo);
+        }
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(Bayer2RGBTest, PaddedInput) {
+  const int width = 64;
+  const int height = 40;
+  const size_t pitch = 80;
+  const auto tight = bayer_image(width, height);
+  std::vector<unsigned char> padded(pitch * height, 0);
+  for (int y = 0; y < height; y++) {
+    std::copy(tight.begin() + y * width, tight.begin() + (y + 1) * width,
+              padded.begin() + y * pitch);
+  }
+  const ConstImageView input(padded.data(), width, height,
+                             ImageFormat::IMAGE_BAYER_GRBG, MemLayout::Packed,
+                             pitch);
+
+  std::vector<unsigned char> output_image(width * height * 3);
+  ASSERT_TRUE(kernels::bayer_2_rgb(
+      input,
+      ImageView(output_image.data(), width, height, ImageFormat::IMAGE_RGB8),
+      AlgoType::kParallelSimdCpu));
+  EXPECT_EQ(output_image,
+            expected_rgb(tight, width, height, ImageFormat::IMAGE_BAYER_GRBG,
+                         ImageFormat::IMAGE_RGB8));
+}
+
+TEST(Bayer2RGBTest, BatchMatchesSingleCalls) {
+  // 3000 pixels wide makes an odd batch band of 87 rows, bands must not
+  // start on the wrong color filter phase or lose the rows of their neighbours
+  const int width = 3000;
+  const int height = 400;
+  const auto bayer = bayer_image(width, height);
+  const ConstImageView input(bayer.data(), width, height,
+                             ImageFormat::IMAGE_BAYER_RGGB);
+
+  for (AlgoType algo : {AlgoType::kParallelCpu, AlgoType::kParallelSimdCpu}) {
+    std::vector<unsigned char> expected(width * height * 3);
+    std::vector<unsigned char> output_image(expected.size());
+    ASSERT_TRUE(color_convert(
+        input,
+        ImageView(expected.data(), width, height, ImageFormat::IMAGE_RGB8),
+        algo));
+    const ImageView output(output_image.data(), width, height,
+                           ImageFormat::IMAGE_RGB8);
+    ASSERT_TRUE(color_convert_batch(&input, &output, 1, algo));
+    EXPECT_EQ(output_image, expected) << static_cast<int>(algo);
+  }
+}
+
+TEST(Bayer2RGBTest, InvalidArguments) {
+  std::vector<unsigned char> input_image(16 * 4);
+  std::vector<unsigned char> output_image(16 * 4 * 3);
+  // a single row has no vertical neighbours to mirror
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 16, 1,
+                             ImageFormat::IMAGE_BAYER_RGGB,
+                             ImageFormat::IMAGE_RGB8, AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 16, 4,
+                             ImageFormat::IMAGE_BAYER_RGGB,
+                             ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu));
+  EXPECT_FALSE(kernels::bayer_2_rgb(
+      ConstImageView(input_image.data(), 16, 4, ImageFormat::IMAGE_GRAY8),
+      ImageView(output_image.data(), 16, 4, ImageFormat::IMAGE_RGB8),
+      AlgoType::kSimdCpu));
+}
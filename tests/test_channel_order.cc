@@ -0,0 +1,137 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static const CpuIsa kIsas[] = {CpuIsa::kGeneric, CpuIsa::kSse41,
+                               CpuIsa::kAvx2, CpuIsa::kAvx512bw,
+                               CpuIsa::kNeon};
+
+static const AlgoType kCpuAlgos[] = {AlgoType::kNativeCpu,
+                                     AlgoType::kParallelCpu,
+                                     AlgoType::kSimdCpu,
+                                     AlgoType::kParallelSimdCpu};
+
+static const ImageFormat kPackedFormats[] = {
+    ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_BGR8,
+    ImageFormat::IMAGE_BGRA8};
+
+static bool is_bgr(ImageFormat format) {
+  return format == ImageFormat::IMAGE_BGR8 ||
+         format == ImageFormat::IMAGE_BGRA8;
+}
+
+// pixel i of a test image: (r, g, b, a) in RGBA order
+static void test_pixel(size_t i, unsigned char rgba[4]) {
+  rgba[0] = static_cast<unsigned char>((i * 7919) >> 3);
+  rgba[1] = static_cast<unsigned char>((i * 104729) >> 5);
+  rgba[2] = static_cast<unsigned char>((i * 1299709) >> 4);
+  rgba[3] = static_cast<unsigned char>(i * 31);
+}
+
+static std::vector<unsigned char> encode(size_t count, ImageFormat format) {
+  const size_t channels = image_format_channels(format);
+  std::vector<unsigned char> image(count * channels);
+  for (size_t i = 0; i < count; i++) {
+    unsigned char rgba[4];
+    test_pixel(i, rgba);
+    unsigned char *pixel = &image[i * channels];
+    pixel[is_bgr(format) ? 2 : 0] = rgba[0];
+    pixel[1] = rgba[1];
+    pixel[is_bgr(format) ? 0 : 2] = rgba[2];
+    if (channels == 4) {
+      pixel[3] = rgba[3];
+    }
+  }
+  return image;
+}
+
+TEST(ChannelOrderTest, GrayMatchesRgb) {
+  // wider than one vector of every variant, with a scalar tail
+  const int width = 102;
+  const int height = 3;
+  const size_t count = width * height;
+
+  std::vector<unsigned char> expected(count);
+  ASSERT_TRUE(color_convert(encode(count, ImageFormat::IMAGE_RGB8).data(),
+                            expected.data(), width, height,
+                            ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8,
+                            AlgoType::kNativeCpu));
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat format : kPackedFormats) {
+      const auto input_image = encode(count, format);
+      for (AlgoType algo : kCpuAlgos) {
+        std::vector<unsigned char> gray(count);
+        ASSERT_TRUE(color_convert(input_image.data(), gray.data(), width,
+                                  height, format, ImageFormat::IMAGE_GRAY8,
+                                  algo));
+        // the native and SIMD weights round differently by at most one
+        for (size_t i = 0; i < count; i++) {
+          ASSERT_NEAR(gray[i], expected[i], 1)
+              << cpu_isa_to_str(isa) << " " << image_format_to_str(format)
+              << " algo " << static_cast<int>(algo) << " pixel " << i;
+        }
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(ChannelOrderTest, ReorderAllPairsAndVariants) {
+  const int width = 102;
+  const int height = 3;
+  const size_t count = width * height;
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat input_format : kPackedFormats) {
+      const auto input_image = encode(count, input_format);
+      for (ImageFormat output_format : kPackedFormats) {
+        if (output_format == input_format) {
+          continue;
+        }
+        auto expected = encode(count, output_format);
+        if (image_format_channels(input_format) == 3 &&
+            image_format_channels(output_format) == 4) {
+          for (size_t i = 3; i < expected.size(); i += 4) {
+            expected[i] = 255;
+          }
+        }
+        for (AlgoType algo : kCpuAlgos) {
+          std::vector<unsigned char> output_image(expected.size());
+          ASSERT_TRUE(color_convert(input_image.data(), output_image.data(),
+                                    width, height, input_format,
+                                    output_format, algo));
+          EXPECT_EQ(output_image, expected)
+              << cpu_isa_to_str(isa) << " "
+              << image_format_to_str(input_format) << " -> "
+              << image_format_to_str(output_format) << " algo "
+              << static_cast<int>(algo);
+        }
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(ChannelOrderTest, InvalidArguments) {
+  std::vector<unsigned char> input_image(16 * 4 * 4);
+  std::vector<unsigned char> output_image(16 * 4 * 4);
+  // no identity copies and no planar reorders
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 16, 4,
+                             ImageFormat::IMAGE_BGR8, ImageFormat::IMAGE_BGR8,
+                             AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 16, 4,
+                             ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_BGR8,
+                             AlgoType::kSimdCpu, MemLayout::Planar));
+}
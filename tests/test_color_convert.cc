@@ -0,0 +1,229 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/kernels/rgb2gray.hpp"
+#include "gtest/gtest.h"
+#include "test_images.hpp"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+TEST(ColorConvertTest, KernelLookup) {
+  EXPECT_NE(color_convert_kernel(ImageFormat::IMAGE_RGB8,
+                                 ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu,
+                                 MemLayout::Packed),
+            nullptr);
+  EXPECT_NE(color_convert_kernel(ImageFormat::IMAGE_RGBA8,
+                                 ImageFormat::IMAGE_GRAY8,
+                                 AlgoType::kParallelCpu, MemLayout::Planar),
+            nullptr);
+  EXPECT_EQ(color_convert_kernel(ImageFormat::IMAGE_GRAY8,
+                                 ImageFormat::IMAGE_RGB8, AlgoType::kNativeCpu,
+                                 MemLayout::Packed),
+            nullptr);
+  EXPECT_EQ(color_convert_kernel(ImageFormat::IMAGE_UNKNOWN,
+                                 ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu,
+                                 MemLayout::Packed),
+            nullptr);
+}
+
+TEST(ColorConvertTest, MatchesKernelEntryPoint) {
+  int width = 67;
+  int height = 13;
+  auto input_image = make_test_image(width * height * 3);
+  std::vector<unsigned char> expected(width * height);
+  std::vector<unsigned char> output_image(width * height);
+
+  ASSERT_TRUE(kernels::rgb_2_gray(input_image.data(), expected.data(), width,
+                                  height, AlgoType::kNativeCpu,
+                                  MemLayout::Packed));
+  ASSERT_TRUE(color_convert(input_image.data(), output_image.data(), width,
+                            height, ImageFormat::IMAGE_RGB8,
+                            ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu));
+  EXPECT_EQ(output_image, expected);
+}
+
+TEST(ColorConvertTest, CachedKernelHandle) {
+  int width = 32;
+  int height = 8;
+  auto input_image = make_test_image(width * height * 4);
+  std::vector<unsigned char> expected(width * height);
+  std::vector<unsigned char> output_image(width * height);
+
+  ASSERT_TRUE(color_convert(input_image.data(), expected.data(), width, height,
+                            ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8,
+                            AlgoType::kParallelCpu, MemLayout::Planar));
+
+  auto kernel =
+      color_convert_kernel(ImageFormat::IMAGE_RGBA8, ImageFormat::IMAGE_GRAY8,
+                           AlgoType::kParallelCpu, MemLayout::Planar);
+  ASSERT_NE(kernel, nullptr);
+  const ConstImageView input(input_image.data(), width, height,
+                             ImageFormat::IMAGE_RGBA8, MemLayout::Planar);
+  const ImageView output(output_image.data(), width, height,
+                         ImageFormat::IMAGE_GRAY8);
+  for (int frame = 0; frame < 3; frame++) {
+    ASSERT_TRUE(kernel(input, output));
+    EXPECT_EQ(output_image, expected);
+  }
+}
+
+TEST(ColorConvertTest, InvalidArguments) {
+  std::vector<unsigned char> input_image(16 * 3);
+  std::vector<unsigned char> output_image(16);
+
+  EXPECT_FALSE(color_convert(nullptr, output_image.data(), 4, 4,
+                             ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8,
+                             AlgoType::kNativeCpu));
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 0, 4,
+                             ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_GRAY8,
+                             AlgoType::kNativeCpu));
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 4, 4,
+                             ImageFormat::IMAGE_GRAY8, ImageFormat::IMAGE_RGB8,
+                             AlgoType::kNativeCpu));
+}
+
+TEST(ColorConvertTest, MismatchedLayouts) {
+  const int width = 64;
+  const int height = 16;
+  const auto input_image = make_test_image(width * height * 3);
+  const ConstImageView input(input_image.data(), width, height,
+                             ImageFormat::IMAGE_RGB8, MemLayout::Planar);
+
+  // a packed float output would be written with the planar kernel
+  std::vector<unsigned char> output_image(width * height * 12, 0xcd);
+  const ImageView output(output_image.data(), width, height,
+                         ImageFormat::IMAGE_RGB32F);
+  for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelSimdCpu}) {
+    EXPECT_FALSE(color_convert(input, output, algo));
+    EXPECT_FALSE(color_convert_batch(&input, &output, 1, algo));
+  }
+  EXPECT_EQ(output_image,
+            std::vector<unsigned char>(output_image.size(), 0xcd));
+
+  // a single channel image is the same in both layouts
+  std::vector<unsigned char> gray(width * height);
+  EXPECT_TRUE(color_convert(
+      input, ImageView(gray.data(), width, height, ImageFormat::IMAGE_GRAY8),
+      AlgoType::kNativeCpu));
+}
+
+TEST(ColorConvertTest, BatchMatchesSingleCalls) {
+  // small frames, a frame larger than one band and mixed formats/layouts
+  struct Frame {
+    int width;
+    int height;
+    ImageFormat format;
+    MemLayout layout;
+  };
+  const std::vector<Frame> frames = {
+      {64, 48, ImageFormat::IMAGE_RGB8, MemLayout::Packed},
+      {33, 7, ImageFormat::IMAGE_RGBA8, MemLayout::Planar},
+      {1280, 720, ImageFormat::IMAGE_RGB8, MemLayout::Packed},
+      {640, 480, ImageFormat::IMAGE_RGBA8, MemLayout::Packed},
+      {17, 3, ImageFormat::IMAGE_RGB8, MemLayout::Planar},
+  };
+
+  for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                        AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+    std::vector<std::vector<unsigned char>> input_images, output_images;
+    std::vector<ConstImageView> inputs;
+    std::vector<ImageView> outputs;
+    for (const auto &frame : frames) {
+      input_images.push_back(make_test_image(
+          frame.width * frame.height * image_format_channels(frame.format)));
+      output_images.emplace_back(frame.width * frame.height);
+    }
+    for (size_t i = 0; i < frames.size(); i++) {
+      inputs.emplace_back(input_images[i].data(), frames[i].width,
+                          frames[i].height, frames[i].format, frames[i].layout);
+      outputs.emplace_back(output_images[i].data(), frames[i].width,
+                           frames[i].height, ImageFormat::IMAGE_GRAY8);
+    }
+
+    ASSERT_TRUE(
+        color_convert_batch(inputs.data(), outputs.data(), inputs.size(), algo));
+
+    for (size_t i = 0; i < frames.size(); i++) {
+      std::vector<unsigned char> expected(output_images[i].size());
+      ASSERT_TRUE(color_convert(input_images[i].data(), expected.data(),
+                                frames[i].width, frames[i].height,
+                                frames[i].format, ImageFormat::IMAGE_GRAY8,
+                                algo, frames[i].layout));
+      EXPECT_EQ(output_images[i], expected) << "frame " << i;
+    }
+  }
+
+  // one invalid pair rejects the whole batch
+  std::vector<unsigned char> input_image(16 * 3);
+  std::vector<unsigned char> output_image(16, 0xcd);
+  const ConstImageView inputs[] = {
+      ConstImageView(input_image.data(), 4, 4, ImageFormat::IMAGE_RGB8),
+      ConstImageView(input_image.data(), 4, 4, ImageFormat::IMAGE_RGB8)};
+  const ImageView outputs[] = {
+      ImageView(output_image.data(), 4, 4, ImageFormat::IMAGE_GRAY8),
+      ImageView(output_image.data(), 2, 4, ImageFormat::IMAGE_GRAY8)};
+  EXPECT_FALSE(
+      color_convert_batch(inputs, outputs, 2, AlgoType::kParallelSimdCpu));
+  EXPECT_EQ(output_image, std::vector<unsigned char>(16, 0xcd));
+}
+
+TEST(ColorConvertTest, BatchYuv420MatchesSingleCalls) {
+  // larger than one band, the chroma rows must follow the luma rows
+  const int width = 1920;
+  const int height = 1080;
+  const auto input_image = make_test_image(width * height * 3 / 2);
+
+  for (AlgoType algo : {AlgoType::kParallelCpu, AlgoType::kParallelSimdCpu}) {
+    for (ImageFormat format : {ImageFormat::IMAGE_NV12,
+                               ImageFormat::IMAGE_I420}) {
+      std::vector<unsigned char> expected(width * height * 3);
+      std::vector<unsigned char> output_image(expected.size());
+      const ConstImageView input(input_image.data(), width, height, format);
+      const ImageView output(output_image.data(), width, height,
+                             ImageFormat::IMAGE_RGB8);
+      ASSERT_TRUE(color_convert(
+          input,
+          ImageView(expected.data(), width, height, ImageFormat::IMAGE_RGB8),
+          algo));
+
+      ASSERT_TRUE(color_convert_batch(&input, &output, 1, algo));
+      EXPECT_EQ(output_image, expected) << image_format_to_str(format);
+    }
+  }
+}
+
+TEST(ColorConvertTest, BatchNestsParallelKernels) {
+  // whole NV12 frames run their parallel kernel inside the batch's loop, next
+  // to the bands of the RGB frames, with the affinity partitioner on
+  const int width = 640;
+  const int height = 480;
+  const size_t frames = 6;
+  const auto nv12 = make_test_image(width * height * 3 / 2);
+  const auto rgb = make_test_image(width * height * 3);
+
+  std::vector<ConstImageView> inputs;
+  std::vector<std::vector<unsigned char>> output_images;
+  std::vector<ImageView> outputs;
+  for (size_t i = 0; i < frames; i++) {
+    inputs.emplace_back(i % 3 == 2 ? rgb.data() : nv12.data(), width, height,
+                        i % 3 == 2 ? ImageFormat::IMAGE_RGB8
+                                   : ImageFormat::IMAGE_NV12);
+    output_images.emplace_back(width * height);
+  }
+  for (size_t i = 0; i < frames; i++) {
+    outputs.emplace_back(output_images[i].data(), width, height,
+                         ImageFormat::IMAGE_GRAY8);
+  }
+
+  for (int run = 0; run < 3; run++) {
+    ASSERT_TRUE(color_convert_batch(inputs.data(), outputs.data(), frames,
+                                    AlgoType::kParallelCpu));
+    for (size_t i = 0; i < frames; i++) {
+      std::vector<unsigned char> expected(width * height);
+      ASSERT_TRUE(color_convert(
+          inputs[i],
+          ImageView(expected.data(), width, height, ImageFormat::IMAGE_GRAY8),
+          AlgoType::kNativeCpu));
+      EXPECT_EQ(output_images[i], expected) << "frame " << i;
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/kernels/rgb2gray.hpp"
+#include "image-processing/color-convert/kernels/rgba2gray.hpp"
+#include "gtest/gtest.h"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static std::vector<unsigned char> expected_gray(
+    const std::vector<unsigned char> &input, int pixel_count, int stride,
+    int plane) {
+  std::vector<unsigned char> gray(pixel_count);
+  for (int i = 0; i < pixel_count; i++) {
+    int r = input[i * stride];
+    int g = input[i * stride + plane];
+    int b = input[i * stride + 2 * plane];
+    gray[i] = static_cast<unsigned char>((r * 77 + g * 150 + b * 29) >> 8);
+  }
+  return gray;
+}
+
+TEST(CpuIsaTest, DetectedIsaIsSupported) {
+  EXPECT_TRUE(cpu_isa_supported(cpu_isa()));
+  EXPECT_TRUE(cpu_isa_supported(CpuIsa::kGeneric));
+  EXPECT_STRNE(cpu_isa_to_str(cpu_isa()), "unknown");
+}
+
+TEST(CpuIsaTest, AllVariantsMatchFixedPoint) {
+  // odd size so that both the vector body and the scalar tail are covered
+  int width = 333;
+  int height = 5;
+  int pixel_count = width * height;
+  std::vector<unsigned char> input_image(pixel_count * 4);
+  for (size_t i = 0; i < input_image.size(); i++) {
+    input_image[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  std::vector<unsigned char> output_image(pixel_count);
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : {CpuIsa::kGeneric, CpuIsa::kSse41, CpuIsa::kAvx2,
+                     CpuIsa::kAvx512bw, CpuIsa::kNeon}) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    SCOPED_TRACE(cpu_isa_to_str(isa));
+
+    ASSERT_TRUE(kernels::rgb_2_gray(input_image.data(), output_image.data(),
+                                    width, height, AlgoType::kSimdCpu,
+                                    MemLayout::Packed));
+    EXPECT_EQ(output_image, expected_gray(input_image, pixel_count, 3, 1));
+
+    ASSERT_TRUE(kernels::rgba_2_gray(input_image.data(), output_image.data(),
+                                     width, height, AlgoType::kSimdCpu,
+                                     MemLayout::Packed));
+    EXPECT_EQ(output_image, expected_gray(input_image, pixel_count, 4, 1));
+
+    ASSERT_TRUE(kernels::rgb_2_gray(input_image.data(), output_image.data(),
+                                    width, height, AlgoType::kSimdCpu,
+                                    MemLayout::Planar));
+    EXPECT_EQ(output_image,
+              expected_gray(input_image, pixel_count, 1, pixel_count));
+  }
+  ASSERT_TRUE(set_cpu_isa(detected));
+}
@@ -0,0 +1,90 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/kernels/rgb2gray.hpp"
+#include "gtest/gtest.h"
+#include "test_images.hpp"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+// the full size conversion of the same algorithm followed by a box filter
+static std::vector<unsigned char>
+expected_downscale(const ConstImageView &input, int factor, AlgoType algo) {
+  std::vector<unsigned char> gray(input.width * input.height);
+  EXPECT_TRUE(color_convert(
+      input, ImageView(gray.data(), input.width, input.height,
+                       ImageFormat::IMAGE_GRAY8),
+      algo));
+
+  const int width = input.width / factor;
+  const int height = input.height / factor;
+  const int block = factor * factor;
+  std::vector<unsigned char> output(width * height);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int sum = 0;
+      for (int dy = 0; dy < factor; dy++) {
+        for (int dx = 0; dx < factor; dx++) {
+          sum += gray[(y * factor + dy) * input.width + x * factor + dx];
+        }
+      }
+      output[y * width + x] =
+          static_cast<unsigned char>((sum + block / 2) / block);
+    }
+  }
+  return output;
+}
+
+TEST(DownscaleTest, MatchesConvertThenBoxFilter) {
+  // odd sizes so that both the vector body and the scalar tail are covered
+  const int width = 541;
+  const int height = 19;
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : {CpuIsa::kGeneric, CpuIsa::kSse41, CpuIsa::kAvx2,
+                     CpuIsa::kAvx512bw, CpuIsa::kNeon}) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat format :
+         {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8}) {
+      for (MemLayout layout : {MemLayout::Packed, MemLayout::Planar}) {
+        auto input_image =
+            make_test_image(width * height * image_format_channels(format));
+        ConstImageView input(input_image.data(), width, height, format,
+                             layout);
+        for (int factor : {2, 4}) {
+          for (AlgoType algo :
+               {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+            auto expected = expected_downscale(input, factor, algo);
+            std::vector<unsigned char> output_image(expected.size());
+            ImageView output(output_image.data(), width / factor,
+                             height / factor, ImageFormat::IMAGE_GRAY8);
+            ASSERT_TRUE(color_convert_downscale(input, output, factor, algo));
+            EXPECT_EQ(output_image, expected)
+                << cpu_isa_to_str(isa) << " factor " << factor << " algo "
+                << static_cast<int>(algo);
+          }
+        }
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(DownscaleTest, InvalidArguments) {
+  std::vector<unsigned char> input_image(16 * 16 * 3);
+  std::vector<unsigned char> output_image(8 * 8);
+  ConstImageView input(input_image.data(), 16, 16, ImageFormat::IMAGE_RGB8);
+
+  EXPECT_TRUE(kernels::rgb_2_gray_downscale(
+      input, ImageView(output_image.data(), 8, 8, ImageFormat::IMAGE_GRAY8), 2,
+      AlgoType::kSimdCpu));
+  EXPECT_FALSE(kernels::rgb_2_gray_downscale(
+      input, ImageView(output_image.data(), 5, 5, ImageFormat::IMAGE_GRAY8), 3,
+      AlgoType::kSimdCpu));
+  EXPECT_FALSE(kernels::rgb_2_gray_downscale(
+      input, ImageView(output_image.data(), 8, 4, ImageFormat::IMAGE_GRAY8), 2,
+      AlgoType::kSimdCpu));
+}
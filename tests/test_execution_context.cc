@@ -0,0 +1,92 @@
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/execution-context.hpp"
+#include "image-processing/color-convert/pipeline.hpp"
+#include "gtest/gtest.h"
+#include "test_images.hpp"
+#include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace image_processing::color_convert;
+
+TEST(ExecutionContext, SameOutputAsGlobalScheduler) {
+  ExecutionContextOptions options;
+  options.max_threads = 2;
+  ExecutionContext context(options);
+  EXPECT_EQ(context.max_concurrency(), 2);
+
+  const ImageBuffer input = make_rgb(321, 97);
+  for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                        AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu,
+                        AlgoType::kAuto}) {
+    ImageBuffer expected(321, 97, ImageFormat::IMAGE_GRAY8);
+    ImageBuffer output(321, 97, ImageFormat::IMAGE_GRAY8);
+    ASSERT_TRUE(color_convert(input.view(), expected.view(), algo));
+    ASSERT_TRUE(color_convert(input.view(), output.view(), algo, context));
+    EXPECT_EQ(memcmp(output.data(), expected.data(), expected.size()), 0)
+        << algo_type_to_str(algo);
+  }
+
+  ImageBuffer output(320, 97, ImageFormat::IMAGE_GRAY8);
+  EXPECT_FALSE(color_convert(input.view(), output.view(),
+                             AlgoType::kParallelCpu, context));
+}
+
+TEST(ExecutionContext, Pipeline) {
+  ExecutionContextOptions context_options;
+  context_options.max_threads = 1;
+  ExecutionContext context(context_options);
+
+  PipelineOptions options;
+  options.context = &context;
+  Pipeline pipeline(options);
+  BufferPool &pool = pipeline.pool();
+
+  size_t written = 0;
+  pipeline
+      .read([&](PipelineFrame &frame) {
+        if (frame.index == 6) {
+          return false;
+        }
+        frame.image = pool.acquire(64, 48, ImageFormat::IMAGE_RGB8);
+        memset(frame.image.data(), static_cast<int>(frame.index),
+               frame.image.size());
+        return true;
+      })
+      .convert(ImageFormat::IMAGE_GRAY8, AlgoType::kParallelSimdCpu)
+      .write([&](PipelineFrame &frame) {
+        EXPECT_EQ(frame.image.format(), ImageFormat::IMAGE_GRAY8);
+        EXPECT_EQ(frame.image.data()[0], frame.index);
+        ++written;
+      });
+  EXPECT_TRUE(pipeline.run());
+  EXPECT_EQ(written, 6u);
+}
+
+#ifdef __linux__
+TEST(ExecutionContext, PinsThreadsWhileInside) {
+  cpu_set_t before;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  int cpu = 0;
+  while (!CPU_ISSET(cpu, &before)) {
+    ++cpu;
+  }
+
+  ExecutionContextOptions options;
+  options.cpus = {cpu};
+  ExecutionContext context(options);
+  int inside = -1;
+  context.execute([&] {
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+      inside = CPU_COUNT(&mask) == 1 && CPU_ISSET(cpu, &mask) ? 1 : 0;
+    }
+  });
+  EXPECT_EQ(inside, 1);
+
+  cpu_set_t after;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+  EXPECT_TRUE(CPU_EQUAL(&before, &after));
+}
+#endif
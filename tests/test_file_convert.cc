@@ -0,0 +1,110 @@
+#include "image-processing/color-convert/file-convert.hpp"
+#include "gtest/gtest.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static void write_file(const std::string &path,
+                       const std::vector<unsigned char> &data) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+static std::vector<unsigned char> read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
+
+static std::vector<unsigned char> test_frames(ImageFormat format, int width,
+                                              int height, size_t frames) {
+  std::vector<unsigned char> data(
+      frames * image_format_size(format, width, height));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  return data;
+}
+
+// converts frame by frame in memory
+static std::vector<unsigned char>
+expected_frames(const std::vector<unsigned char> &input, int width, int height,
+                ImageFormat input_format, ImageFormat output_format) {
+  const size_t input_frame = image_format_size(input_format, width, height);
+  const size_t output_frame = image_format_size(output_format, width, height);
+  const size_t frames = input.size() / input_frame;
+  std::vector<unsigned char> output(frames * output_frame);
+  for (size_t i = 0; i < frames; ++i) {
+    EXPECT_TRUE(color_convert(&input[i * input_frame],
+                              &output[i * output_frame], width, height,
+                              input_format, output_format,
+                              AlgoType::kNativeCpu));
+  }
+  return output;
+}
+
+TEST(FileConvertTest, BandsMatchInMemory) {
+  const int width = 97;
+  const int height = 33;
+  const std::string input_path = "/tmp/test_file_convert.rgb";
+  const std::string output_path = "/tmp/test_file_convert.gray";
+  const auto input = test_frames(ImageFormat::IMAGE_RGB8, width, height, 3);
+  write_file(input_path, input);
+  const auto expected = expected_frames(input, width, height,
+                                        ImageFormat::IMAGE_RGB8,
+                                        ImageFormat::IMAGE_GRAY8);
+
+  // one row, a few rows and whole frames per band
+  for (size_t band_bytes : {size_t(1), size_t(4096), size_t(1) << 20}) {
+    FileConvertOptions options;
+    options.band_bytes = band_bytes;
+    ASSERT_TRUE(color_convert_file(input_path.c_str(), output_path.c_str(),
+                                   width, height, ImageFormat::IMAGE_RGB8,
+                                   ImageFormat::IMAGE_GRAY8,
+                                   AlgoType::kNativeCpu, options));
+    EXPECT_EQ(read_file(output_path), expected) << band_bytes;
+  }
+}
+
+TEST(FileConvertTest, WholeFrameFormats) {
+  // 4:2:0 and Bayer frames are not cut into bands
+  const int width = 64;
+  const int height = 16;
+  const std::string output_path = "/tmp/test_file_convert.rgb";
+  for (ImageFormat format :
+       {ImageFormat::IMAGE_NV12, ImageFormat::IMAGE_BAYER_RGGB}) {
+    const std::string input_path =
+        std::string("/tmp/test_file_convert.") + image_format_to_str(format);
+    const auto input = test_frames(format, width, height, 2);
+    write_file(input_path, input);
+    FileConvertOptions options;
+    options.band_bytes = 1;
+    ASSERT_TRUE(color_convert_file(input_path.c_str(), output_path.c_str(),
+                                   width, height, format,
+                                   ImageFormat::IMAGE_RGB8,
+                                   AlgoType::kSimdCpu, options));
+    EXPECT_EQ(read_file(output_path),
+              expected_frames(input, width, height, format,
+                              ImageFormat::IMAGE_RGB8))
+        << image_format_to_str(format);
+  }
+}
+
+TEST(FileConvertTest, InvalidFiles) {
+  const std::string input_path = "/tmp/test_file_convert.rgb";
+  const std::string output_path = "/tmp/test_file_convert.gray";
+  // half a frame
+  write_file(input_path, std::vector<unsigned char>(8 * 8 * 3 / 2));
+  EXPECT_FALSE(color_convert_file(input_path.c_str(), output_path.c_str(), 8,
+                                  8, ImageFormat::IMAGE_RGB8,
+                                  ImageFormat::IMAGE_GRAY8,
+                                  AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert_file("/tmp/does/not/exist.rgb",
+                                  output_path.c_str(), 8, 8,
+                                  ImageFormat::IMAGE_RGB8,
+                                  ImageFormat::IMAGE_GRAY8,
+                                  AlgoType::kSimdCpu));
+}
@@ -0,0 +1,202 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static const CpuIsa kIsas[] = {CpuIsa::kGeneric, CpuIsa::kSse41,
+                               CpuIsa::kAvx2, CpuIsa::kAvx512bw,
+                               CpuIsa::kNeon};
+
+static const AlgoType kCpuAlgos[] = {AlgoType::kNativeCpu,
+                                     AlgoType::kParallelCpu,
+                                     AlgoType::kSimdCpu,
+                                     AlgoType::kParallelSimdCpu};
+
+static std::vector<float> float_image(size_t count) {
+  std::vector<float> image(count);
+  for (size_t i = 0; i < count; i++) {
+    image[i] = static_cast<float>((i * 7919) % 1000) / 1000.0f;
+  }
+  return image;
+}
+
+TEST(FloatTest, GrayAllFormatsAndVariants) {
+  // wider than one vector of every variant, with a scalar tail
+  const int width = 37;
+  const int height = 5;
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat format :
+         {ImageFormat::IMAGE_RGB32F, ImageFormat::IMAGE_RGBA32F}) {
+      const size_t channels = image_format_channels(format);
+      const auto input_image = float_image(width * height * channels);
+      for (MemLayout layout : {MemLayout::Packed, MemLayout::Planar}) {
+        std::vector<double> expected(width * height);
+        for (size_t i = 0; i < expected.size(); i++) {
+          const size_t plane = width * height;
+          const bool planar = layout == MemLayout::Planar;
+          const float r = input_image[planar ? i : channels * i];
+          const float g = input_image[planar ? plane + i : channels * i + 1];
+          const float b =
+              input_image[planar ? 2 * plane + i : channels * i + 2];
+          expected[i] = 0.299 * r + 0.587 * g + 0.114 * b;
+        }
+
+        for (AlgoType algo : kCpuAlgos) {
+          std::vector<float> gray(width * height);
+          ASSERT_TRUE(color_convert(
+              reinterpret_cast<const unsigned char *>(input_image.data()),
+              reinterpret_cast<unsigned char *>(gray.data()), width, height,
+              format, ImageFormat::IMAGE_GRAY32F, algo, layout));
+          for (size_t i = 0; i < gray.size(); i++) {
+            ASSERT_NEAR(gray[i], expected[i], 1e-6)
+                << cpu_isa_to_str(isa) << " " << image_format_to_str(format)
+                << " layout " << static_cast<int>(layout) << " algo "
+                << static_cast<int>(algo) << " pixel " << i;
+          }
+        }
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(FloatTest, DepthRoundTrip) {
+  const int width = 45;
+  const int height = 3;
+  std::vector<unsigned char> rgb(width * height * 3);
+  for (size_t i = 0; i < rgb.size(); i++) {
+    rgb[i] = static_cast<unsigned char>(i * 37);
+  }
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (AlgoType algo : kCpuAlgos) {
+      std::vector<float> rgb_float(rgb.size());
+      ASSERT_TRUE(color_convert(
+          rgb.data(), reinterpret_cast<unsigned char *>(rgb_float.data()),
+          width, height, ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGB32F,
+          algo));
+      for (size_t i = 0; i < rgb.size(); i++) {
+        ASSERT_NEAR(rgb_float[i], rgb[i] / 255.0, 1e-6) << i;
+      }
+
+      std::vector<unsigned char> back(rgb.size());
+      ASSERT_TRUE(color_convert(
+          reinterpret_cast<const unsigned char *>(rgb_float.data()),
+          back.data(), width, height, ImageFormat::IMAGE_RGB32F,
+          ImageFormat::IMAGE_RGB8, algo));
+      EXPECT_EQ(back, rgb) << cpu_isa_to_str(isa) << " algo "
+                           << static_cast<int>(algo);
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(FloatTest, NormalizeScaleOffsetAndSaturation) {
+  // ImageNet style normalization of one channel: (x / 255 - 0.5) / 0.25
+  const int width = 40;
+  std::vector<unsigned char> gray(width);
+  for (int i = 0; i < width; i++) {
+    gray[i] = static_cast<unsigned char>(i * 6);
+  }
+  std::vector<float> normalized(width);
+  ASSERT_TRUE(color_convert_normalize(
+      ConstImageView(gray.data(), width, 1, ImageFormat::IMAGE_GRAY8),
+      ImageView(reinterpret_cast<unsigned char *>(normalized.data()), width, 1,
+                ImageFormat::IMAGE_GRAY32F),
+      1.0f / (255.0f * 0.25f), -2.0f, AlgoType::kSimdCpu));
+  for (int i = 0; i < width; i++) {
+    EXPECT_NEAR(normalized[i], (gray[i] / 255.0 - 0.5) / 0.25, 1e-5);
+  }
+
+  // rounding to nearest even, saturation and NaN, repeated past one vector
+  const float pattern[] = {-1.0f, 300.0f, 2.5f, 3.5f, 254.6f,
+                           std::numeric_limits<float>::quiet_NaN(), 0.4f,
+                           255.0f};
+  const unsigned char expected_pattern[] = {0, 255, 2, 4, 255, 0, 0, 255};
+  std::vector<float> input(width);
+  std::vector<unsigned char> expected(width);
+  for (int i = 0; i < width; i++) {
+    input[i] = pattern[i % 8];
+    expected[i] = expected_pattern[i % 8];
+  }
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (AlgoType algo : kCpuAlgos) {
+      std::vector<unsigned char> output(width);
+      ASSERT_TRUE(color_convert_normalize(
+          ConstImageView(reinterpret_cast<const unsigned char *>(input.data()),
+                         width, 1, ImageFormat::IMAGE_GRAY32F),
+          ImageView(output.data(), width, 1, ImageFormat::IMAGE_GRAY8), 1.0f,
+          0.0f, algo));
+      EXPECT_EQ(output, expected) << cpu_isa_to_str(isa) << " algo "
+                                  << static_cast<int>(algo);
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(FloatTest, NormalizeSingleChannelAcrossLayouts) {
+  // a gray image is the same in both layouts, the flags may differ
+  const int width = 24;
+  std::vector<unsigned char> gray(width * 2);
+  for (size_t i = 0; i < gray.size(); i++) {
+    gray[i] = static_cast<unsigned char>(i * 5);
+  }
+  std::vector<float> normalized(gray.size());
+  for (AlgoType algo : kCpuAlgos) {
+    ASSERT_TRUE(color_convert_normalize(
+        ConstImageView(gray.data(), width, 2, ImageFormat::IMAGE_GRAY8),
+        ImageView(reinterpret_cast<unsigned char *>(normalized.data()), width,
+                  2, ImageFormat::IMAGE_GRAY32F, MemLayout::Planar),
+        2.0f, 1.0f, algo));
+    for (size_t i = 0; i < gray.size(); i++) {
+      EXPECT_EQ(normalized[i], gray[i] * 2.0f + 1.0f) << i;
+    }
+
+    std::vector<unsigned char> back(gray.size());
+    ASSERT_TRUE(color_convert_normalize(
+        ConstImageView(reinterpret_cast<const unsigned char *>(
+                           normalized.data()),
+                       width, 2, ImageFormat::IMAGE_GRAY32F, MemLayout::Planar),
+        ImageView(back.data(), width, 2, ImageFormat::IMAGE_GRAY8), 0.5f,
+        -0.5f, algo));
+    EXPECT_EQ(back, gray) << static_cast<int>(algo);
+  }
+}
+
+TEST(FloatTest, InvalidArguments) {
+  std::vector<float> float_image(16 * 4 * 4);
+  std::vector<unsigned char> image(16 * 4 * 4);
+  // the channels differ
+  EXPECT_FALSE(color_convert_normalize(
+      ConstImageView(image.data(), 16, 4, ImageFormat::IMAGE_RGB8),
+      ImageView(reinterpret_cast<unsigned char *>(float_image.data()), 16, 4,
+                ImageFormat::IMAGE_RGBA32F),
+      1.0f, 0.0f, AlgoType::kSimdCpu));
+  // both sides uint8
+  EXPECT_FALSE(color_convert_normalize(
+      ConstImageView(image.data(), 16, 4, ImageFormat::IMAGE_RGB8),
+      ImageView(image.data(), 16, 4, ImageFormat::IMAGE_RGB8), 1.0f, 0.0f,
+      AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert(
+      reinterpret_cast<const unsigned char *>(float_image.data()),
+      image.data(), 16, 4, ImageFormat::IMAGE_RGB32F,
+      ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu));
+}
@@ -0,0 +1,85 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <stdint.h>
+#include <utility>
+
+using namespace image_processing::color_convert;
+
+static bool is_aligned(const void *data) {
+  return reinterpret_cast<uintptr_t>(data) % kImageBufferAlignment == 0;
+}
+
+TEST(ImageBufferTest, AlignedAndSized) {
+  // odd sizes would end a plain allocation on any byte
+  const ImageBuffer rgb(33, 7, ImageFormat::IMAGE_RGB8);
+  ASSERT_TRUE(rgb);
+  EXPECT_TRUE(is_aligned(rgb.data()));
+  EXPECT_EQ(rgb.size(), image_format_size(ImageFormat::IMAGE_RGB8, 33, 7));
+
+  const ImageBuffer nv12(64, 8, ImageFormat::IMAGE_NV12);
+  EXPECT_EQ(nv12.size(), 64u * 8 * 3 / 2);
+  const ImageView view = nv12.view();
+  EXPECT_EQ(view.data, nv12.data());
+  EXPECT_EQ(view.pitch, 64u);
+
+  EXPECT_FALSE(ImageBuffer(0, 8, ImageFormat::IMAGE_RGB8));
+}
+
+TEST(ImageBufferTest, PoolRecyclesBuffers) {
+  BufferPool pool;
+  unsigned char *first = nullptr;
+  {
+    ImageBuffer buffer = pool.acquire(640, 480, ImageFormat::IMAGE_RGB8);
+    ASSERT_TRUE(buffer);
+    EXPECT_TRUE(is_aligned(buffer.data()));
+    first = buffer.data();
+    EXPECT_EQ(pool.cached_bytes(), 0u);
+  }
+  EXPECT_GE(pool.cached_bytes(), 640u * 480 * 3);
+
+  // the same size gets the released block back, another size does not
+  ImageBuffer same = pool.acquire(640, 480, ImageFormat::IMAGE_BGR8);
+  EXPECT_EQ(same.data(), first);
+  EXPECT_EQ(pool.cached_bytes(), 0u);
+  ImageBuffer other = pool.acquire(640, 480, ImageFormat::IMAGE_GRAY8);
+  EXPECT_NE(other.data(), first);
+
+  // moving keeps the block, the moved from buffer is empty
+  ImageBuffer moved = std::move(same);
+  EXPECT_EQ(moved.data(), first);
+  EXPECT_FALSE(same);
+
+  EXPECT_FALSE(pool.acquire(-1, 480, ImageFormat::IMAGE_RGB8));
+}
+
+TEST(ImageBufferTest, PoolLimitsAndLifetime) {
+  BufferPoolOptions options;
+  options.huge_pages = true;
+  options.max_cached_bytes = size_t(8) << 20;
+
+  ImageBuffer survivor;
+  {
+    BufferPool pool(options);
+    {
+      // 6 MiB each, only one fits the cache
+      ImageBuffer a = pool.acquire(1920, 1080, ImageFormat::IMAGE_RGB8);
+      ImageBuffer b = pool.acquire(1920, 1080, ImageFormat::IMAGE_RGB8);
+      EXPECT_TRUE(is_aligned(a.data()));
+    }
+    EXPECT_LE(pool.cached_bytes(), options.max_cached_bytes);
+    EXPECT_GT(pool.cached_bytes(), 0u);
+    pool.trim();
+    EXPECT_EQ(pool.cached_bytes(), 0u);
+
+    survivor = pool.acquire(16, 16, ImageFormat::IMAGE_RGBA8);
+  }
+  // the pool is gone, the buffer still works and is freed on its own
+  ASSERT_TRUE(survivor);
+  std::fill(survivor.data(), survivor.data() + survivor.size(), 255);
+  ImageBuffer gray(16, 16, ImageFormat::IMAGE_GRAY8);
+  EXPECT_TRUE(
+      color_convert(survivor.view(), gray.view(), AlgoType::kSimdCpu));
+  EXPECT_EQ(gray.data()[0], 255);
+}
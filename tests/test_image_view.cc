@@ -0,0 +1,107 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "gtest/gtest.h"
+#include "test_images.hpp"
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+TEST(ImageViewTest, TightPitchByDefault) {
+  std::vector<unsigned char> image(10 * 4 * 4);
+  ImageView packed(image.data(), 10, 4, ImageFormat::IMAGE_RGB8);
+  EXPECT_EQ(packed.pitch, 30u);
+  EXPECT_EQ(packed.plane_pitch, 120u);
+
+  ImageView planar(image.data(), 10, 4, ImageFormat::IMAGE_RGBA8,
+                   MemLayout::Planar);
+  EXPECT_EQ(planar.pitch, 10u);
+  EXPECT_EQ(planar.plane_pitch, 40u);
+  EXPECT_EQ(planar.row(1, 2), image.data() + 2 * 40 + 10);
+
+  ImageView gray(image.data(), 10, 4, ImageFormat::IMAGE_GRAY8,
+                 MemLayout::Planar);
+  EXPECT_EQ(gray.pitch, 10u);
+}
+
+TEST(ImageViewTest, RoiSharesPitch) {
+  const std::vector<unsigned char> image(300 * 32);
+  ConstImageView view(image.data(), 64, 32, ImageFormat::IMAGE_RGBA8,
+                      MemLayout::Packed, 300);
+  auto roi = view.roi(5, 3, 16, 8);
+  EXPECT_EQ(roi.data, image.data() + 3 * 300 + 5 * 4);
+  EXPECT_EQ(roi.pitch, 300u);
+  EXPECT_EQ(roi.width, 16);
+  EXPECT_EQ(roi.height, 8);
+}
+
+// Converting a padded region of interest must give the same result as
+// converting a tightly packed copy of it, for every cpu algorithm and layout.
+TEST(ImageViewTest, PaddedRoiMatchesTightCopy) {
+  const int width = 131;
+  const int height = 37;
+  const int x0 = 13;
+  const int y0 = 5;
+  const int roi_width = 97;
+  const int roi_height = 29;
+  const size_t out_pitch = roi_width + 19;
+
+  for (ImageFormat format : {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8}) {
+    for (MemLayout layout : {MemLayout::Packed, MemLayout::Planar}) {
+      const size_t pixel_size = image_format_pixel_size(format, layout);
+      const size_t pitch = width * pixel_size + 24;
+      const int planes = layout == MemLayout::Planar
+                             ? static_cast<int>(image_format_channels(format))
+                             : 1;
+      auto input_image = make_test_image(pitch * height * planes);
+      ConstImageView input(input_image.data(), width, height, format, layout,
+                           pitch);
+      ConstImageView roi = input.roi(x0, y0, roi_width, roi_height);
+
+      // tight copy of the region
+      ConstImageView tight_view(nullptr, roi_width, roi_height, format, layout);
+      std::vector<unsigned char> tight(tight_view.plane_pitch * planes);
+      tight_view.data = tight.data();
+      for (int plane = 0; plane < planes; plane++) {
+        for (int y = 0; y < roi_height; y++) {
+          std::copy(roi.row(y, plane), roi.row(y, plane) + tight_view.pitch,
+                    tight.data() + plane * tight_view.plane_pitch +
+                        y * tight_view.pitch);
+        }
+      }
+
+      for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                            AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+        std::vector<unsigned char> expected(roi_width * roi_height);
+        ASSERT_TRUE(color_convert(tight.data(), expected.data(), roi_width,
+                                  roi_height, format, ImageFormat::IMAGE_GRAY8,
+                                  algo, layout));
+
+        std::vector<unsigned char> output_image(out_pitch * roi_height, 0xcd);
+        ImageView output(output_image.data(), roi_width, roi_height,
+                         ImageFormat::IMAGE_GRAY8, MemLayout::Packed,
+                         out_pitch);
+        ASSERT_TRUE(color_convert(roi, output, algo));
+
+        for (int y = 0; y < roi_height; y++) {
+          for (int x = 0; x < roi_width; x++) {
+            ASSERT_EQ(output.row(y)[x], expected[y * roi_width + x])
+                << "algo " << static_cast<int>(algo) << " at " << x << ","
+                << y;
+          }
+          // the padding after each row is left untouched
+          for (size_t x = roi_width; x < out_pitch; x++) {
+            ASSERT_EQ(output.row(y)[x], 0xcd);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageViewTest, MismatchedDimensions) {
+  std::vector<unsigned char> input_image(16 * 4 * 3);
+  std::vector<unsigned char> output_image(16 * 4);
+  ConstImageView input(input_image.data(), 16, 4, ImageFormat::IMAGE_RGB8);
+  ImageView output(output_image.data(), 8, 4, ImageFormat::IMAGE_GRAY8);
+  EXPECT_FALSE(color_convert(input, output, AlgoType::kNativeCpu));
+  EXPECT_FALSE(color_convert(input, ImageView(), AlgoType::kNativeCpu));
+}
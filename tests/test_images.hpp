@@ -0,0 +1,25 @@
+#pragma once
+
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include <algorithm>
+#include <stddef.h>
+#include <vector>
+
+// size bytes of a pattern without long runs of equal values
+inline std::vector<unsigned char> make_test_image(size_t size) {
+  std::vector<unsigned char> data(size);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<unsigned char>((i * 37 + i / 7) & 0xff);
+  }
+  return data;
+}
+
+// an RGB8 frame of the same pattern
+inline image_processing::color_convert::ImageBuffer make_rgb(int width,
+                                                             int height) {
+  using namespace image_processing::color_convert;
+  ImageBuffer image(width, height, ImageFormat::IMAGE_RGB8);
+  const auto pattern = make_test_image(image.size());
+  std::copy(pattern.begin(), pattern.end(), image.data());
+  return image;
+}
@@ -0,0 +1,133 @@
+#include "image-processing/color-convert/autotune.hpp"
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/kernel-stats.hpp"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static const KernelStats *find_stats(const std::vector<KernelStats> &stats,
+                                     KernelOperation operation,
+                                     ImageFormat input_format,
+                                     ImageFormat output_format,
+                                     AlgoType algo_type) {
+  for (const KernelStats &kernel : stats) {
+    if (kernel.operation == operation &&
+        kernel.input_format == input_format &&
+        kernel.output_format == output_format &&
+        kernel.algo_type == algo_type) {
+      return &kernel;
+    }
+  }
+  return nullptr;
+}
+
+TEST(KernelStats, CountsCalls) {
+  ImageBuffer input(64, 32, ImageFormat::IMAGE_RGB8);
+  ImageBuffer output(64, 32, ImageFormat::IMAGE_GRAY8);
+  ImageBuffer small(32, 16, ImageFormat::IMAGE_GRAY8);
+
+  reset_kernel_stats();
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(
+        color_convert(input.view(), output.view(), AlgoType::kSimdCpu));
+  }
+  ASSERT_TRUE(color_convert_downscale(input.view(), small.view(), 2,
+                                      AlgoType::kNativeCpu));
+  // a failed call is not counted
+  ASSERT_FALSE(color_convert(input.view(), small.view(), AlgoType::kSimdCpu));
+
+  const std::vector<KernelStats> stats = kernel_stats();
+  if (!kernel_stats_enabled()) {
+    EXPECT_TRUE(stats.empty());
+    return;
+  }
+
+  const KernelStats *convert =
+      find_stats(stats, KernelOperation::kConvert, ImageFormat::IMAGE_RGB8,
+                 ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu);
+  ASSERT_NE(convert, nullptr);
+  EXPECT_EQ(convert->calls, 3u);
+  EXPECT_EQ(convert->pixels, 3u * 64 * 32);
+  EXPECT_EQ(convert->layout, MemLayout::Packed);
+  EXPECT_EQ(convert->isa, cpu_isa());
+  EXPECT_GE(convert->total_ns, convert->max_ns);
+
+  const KernelStats *downscale =
+      find_stats(stats, KernelOperation::kDownscale, ImageFormat::IMAGE_RGB8,
+                 ImageFormat::IMAGE_GRAY8, AlgoType::kNativeCpu);
+  ASSERT_NE(downscale, nullptr);
+  EXPECT_EQ(downscale->calls, 1u);
+  EXPECT_EQ(downscale->isa, CpuIsa::kGeneric);
+
+  reset_kernel_stats();
+  EXPECT_TRUE(kernel_stats().empty());
+}
+
+TEST(KernelStats, AutoCountsResolvedAlgorithm) {
+  ImageBuffer input(48, 48, ImageFormat::IMAGE_RGBA8);
+  ImageBuffer output(48, 48, ImageFormat::IMAGE_GRAY8);
+  ASSERT_TRUE(color_convert(input.view(), output.view(), AlgoType::kAuto));
+
+  reset_kernel_stats();
+  ASSERT_TRUE(color_convert(input.view(), output.view(), AlgoType::kAuto));
+  const std::vector<KernelStats> stats = kernel_stats();
+  if (!kernel_stats_enabled()) {
+    EXPECT_TRUE(stats.empty());
+    return;
+  }
+  ASSERT_EQ(stats.size(), 1u);
+  EXPECT_NE(stats[0].algo_type, AlgoType::kAuto);
+  EXPECT_EQ(stats[0].algo_type,
+            autotune_algo_type(input.view(), output.view()));
+}
+
+TEST(KernelStats, SumsThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kCalls = 25;
+  reset_kernel_stats();
+
+  // the threads exit before the query, their counts are kept
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([] {
+      ImageBuffer input(40, 20, ImageFormat::IMAGE_RGB8);
+      ImageBuffer output(40, 20, ImageFormat::IMAGE_RGB32F);
+      for (int i = 0; i < kCalls; ++i) {
+        color_convert(input.view(), output.view(), AlgoType::kNativeCpu);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  // bands of a parallel batch count as calls of the serial kernel
+  ImageBuffer input(640, 480, ImageFormat::IMAGE_RGB8);
+  ImageBuffer output(640, 480, ImageFormat::IMAGE_GRAY8);
+  const ConstImageView inputs[] = {input.view(), input.view()};
+  const ImageView outputs[] = {output.view(), output.view()};
+  ASSERT_TRUE(
+      color_convert_batch(inputs, outputs, 2, AlgoType::kParallelSimdCpu));
+
+  const std::vector<KernelStats> stats = kernel_stats();
+  if (!kernel_stats_enabled()) {
+    EXPECT_TRUE(stats.empty());
+    return;
+  }
+  const KernelStats *threaded =
+      find_stats(stats, KernelOperation::kConvert, ImageFormat::IMAGE_RGB8,
+                 ImageFormat::IMAGE_RGB32F, AlgoType::kNativeCpu);
+  ASSERT_NE(threaded, nullptr);
+  EXPECT_EQ(threaded->calls, static_cast<uint64_t>(kThreads * kCalls));
+  EXPECT_EQ(threaded->pixels, static_cast<uint64_t>(kThreads * kCalls) * 800);
+
+  const KernelStats *batch =
+      find_stats(stats, KernelOperation::kConvert, ImageFormat::IMAGE_RGB8,
+                 ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu);
+  ASSERT_NE(batch, nullptr);
+  EXPECT_GE(batch->calls, 2u);
+  EXPECT_EQ(batch->pixels, 2u * 640 * 480);
+}
@@ -0,0 +1,125 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "gtest/gtest.h"
+#include <stdexcept>
+#include <string.h>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static const CpuIsa kIsas[] = {CpuIsa::kGeneric, CpuIsa::kSse41,
+                               CpuIsa::kAvx2, CpuIsa::kAvx512bw,
+                               CpuIsa::kNeon};
+
+static const AlgoType kCpuAlgos[] = {AlgoType::kNativeCpu,
+                                     AlgoType::kParallelCpu,
+                                     AlgoType::kSimdCpu,
+                                     AlgoType::kParallelSimdCpu};
+
+// Splits a packed image with `padding` extra bytes per row into planes and
+// merges it back, every sample has to land in its plane and return unchanged.
+template <typename T>
+static void check_round_trip(ImageFormat format, int width, int height,
+                             size_t padding, AlgoType algo) {
+  const size_t channels = image_format_channels(format);
+  const size_t pitch = width * channels * sizeof(T) + padding;
+  std::vector<unsigned char> packed(pitch * height);
+  for (int y = 0; y < height; ++y) {
+    T *row = reinterpret_cast<T *>(&packed[y * pitch]);
+    for (size_t i = 0; i < width * channels; ++i) {
+      row[i] = static_cast<T>((y * width * channels + i) * 13);
+    }
+  }
+
+  const ImageView input(packed.data(), width, height, format,
+                        MemLayout::Packed, pitch);
+  std::vector<unsigned char> planar(image_format_size(format, width, height));
+  const ImageView planes(planar.data(), width, height, format,
+                         MemLayout::Planar);
+  ASSERT_TRUE(color_convert_layout(input, planes, algo));
+
+  for (int y = 0; y < height; ++y) {
+    const T *row = reinterpret_cast<const T *>(input.row(y));
+    for (size_t c = 0; c < channels; ++c) {
+      const T *plane = reinterpret_cast<const T *>(planes.row(y, c));
+      for (int x = 0; x < width; ++x) {
+        ASSERT_EQ(plane[x], row[channels * x + c])
+            << image_format_to_str(format) << " algo "
+            << static_cast<int>(algo) << " plane " << c << " at " << x
+            << "," << y;
+      }
+    }
+  }
+
+  std::vector<unsigned char> repacked(packed.size(), 0);
+  const ImageView output(repacked.data(), width, height, format,
+                         MemLayout::Packed, pitch);
+  ASSERT_TRUE(color_convert_layout(planes, output, algo));
+  for (int y = 0; y < height; ++y) {
+    ASSERT_EQ(memcmp(input.row(y), output.row(y), pitch - padding), 0)
+        << image_format_to_str(format) << " algo " << static_cast<int>(algo)
+        << " row " << y;
+  }
+}
+
+TEST(LayoutTest, RoundTripAllVariants) {
+  // wider than one vector of every variant, with a scalar tail
+  const int width = 53;
+  const int height = 3;
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : kIsas) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (AlgoType algo : kCpuAlgos) {
+      SCOPED_TRACE(cpu_isa_to_str(isa));
+      check_round_trip<unsigned char>(ImageFormat::IMAGE_RGB8, width, height,
+                                      0, algo);
+      check_round_trip<unsigned char>(ImageFormat::IMAGE_BGRA8, width,
+                                      height, 0, algo);
+      check_round_trip<float>(ImageFormat::IMAGE_RGB32F, width, height, 0,
+                              algo);
+      check_round_trip<float>(ImageFormat::IMAGE_RGBA32F, width, height, 0,
+                              algo);
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(LayoutTest, PaddedRows) {
+  for (AlgoType algo : kCpuAlgos) {
+    check_round_trip<unsigned char>(ImageFormat::IMAGE_BGR8, 37, 5, 11, algo);
+    check_round_trip<float>(ImageFormat::IMAGE_BGRA32F, 19, 4, 16, algo);
+  }
+}
+
+TEST(LayoutTest, InvalidArguments) {
+  std::vector<unsigned char> a(64 * 4 * 4);
+  std::vector<unsigned char> b(64 * 4 * 4);
+  const ImageView packed(a.data(), 8, 8, ImageFormat::IMAGE_RGBA8);
+  const ImageView planar(b.data(), 8, 8, ImageFormat::IMAGE_RGBA8,
+                         MemLayout::Planar);
+
+  // same layout, other format, other size
+  EXPECT_FALSE(color_convert_layout(
+      packed, ImageView(b.data(), 8, 8, ImageFormat::IMAGE_RGBA8),
+      AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert_layout(
+      packed,
+      ImageView(b.data(), 8, 8, ImageFormat::IMAGE_BGRA8, MemLayout::Planar),
+      AlgoType::kSimdCpu));
+  EXPECT_FALSE(color_convert_layout(packed, planar.roi(0, 0, 4, 8),
+                                    AlgoType::kSimdCpu));
+
+  // a single channel has no second layout
+  EXPECT_FALSE(color_convert_layout(
+      ImageView(a.data(), 8, 8, ImageFormat::IMAGE_GRAY8),
+      ImageView(b.data(), 8, 8, ImageFormat::IMAGE_GRAY8, MemLayout::Planar),
+      AlgoType::kNativeCpu));
+
+#if !HAS_CUDA
+  EXPECT_THROW(color_convert_layout(packed, planar, AlgoType::kCuda),
+               std::runtime_error);
+#endif
+}
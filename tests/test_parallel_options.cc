@@ -0,0 +1,96 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/image-buffer.hpp"
+#include "image-processing/color-convert/common/parallel-options.hpp"
+#include "gtest/gtest.h"
+#include "test_images.hpp"
+#include <string.h>
+
+using namespace image_processing::color_convert;
+
+TEST(ParallelOptions, StatsCoverEveryRow) {
+  set_parallel_options(ParallelOptions());
+  const ImageBuffer input = make_rgb(640, 480);
+  ImageBuffer output(640, 480, ImageFormat::IMAGE_GRAY8);
+
+  reset_parallel_stats();
+  ASSERT_TRUE(color_convert(input.view(), output.view(),
+                            AlgoType::kParallelSimdCpu));
+  ASSERT_TRUE(
+      color_convert(input.view(), output.view(), AlgoType::kParallelCpu));
+  const ParallelStats stats = parallel_stats();
+  EXPECT_EQ(stats.calls, 2u);
+  EXPECT_EQ(stats.rows, 2u * 480);
+  EXPECT_GE(stats.bands, 2u);
+  EXPECT_GE(stats.min_band_rows, 1u);
+  EXPECT_LE(stats.min_band_rows, stats.max_band_rows);
+  EXPECT_LE(stats.max_band_rows, 480u);
+
+  reset_parallel_stats();
+  const ParallelStats reset = parallel_stats();
+  EXPECT_EQ(reset.calls, 0u);
+  EXPECT_EQ(reset.bands, 0u);
+  EXPECT_EQ(reset.rows, 0u);
+  EXPECT_EQ(reset.min_band_rows, 0u);
+  EXPECT_EQ(reset.max_band_rows, 0u);
+}
+
+TEST(ParallelOptions, GrainRows) {
+  const ImageBuffer input = make_rgb(640, 480);
+  ImageBuffer output(640, 480, ImageFormat::IMAGE_GRAY8);
+
+  for (bool affinity : {true, false}) {
+    ParallelOptions options;
+    options.affinity = affinity;
+
+    // a band is never split below the grain, so it holds at least half of it
+    options.grain_rows = 100;
+    set_parallel_options(options);
+    EXPECT_EQ(parallel_options().grain_rows, 100);
+    reset_parallel_stats();
+    ASSERT_TRUE(
+        color_convert(input.view(), output.view(), AlgoType::kParallelCpu));
+    EXPECT_GE(parallel_stats().min_band_rows, 50u);
+
+    // a grain covering the frame leaves a single band
+    options.grain_rows = 480;
+    set_parallel_options(options);
+    reset_parallel_stats();
+    ASSERT_TRUE(
+        color_convert(input.view(), output.view(), AlgoType::kParallelCpu));
+    EXPECT_EQ(parallel_stats().bands, 1u);
+    EXPECT_EQ(parallel_stats().max_band_rows, 480u);
+  }
+
+  ParallelOptions invalid;
+  invalid.grain_rows = -5;
+  set_parallel_options(invalid);
+  EXPECT_EQ(parallel_options().grain_rows, 0);
+  set_parallel_options(ParallelOptions());
+}
+
+TEST(ParallelOptions, SameOutputForEveryOption) {
+  const int width = 333, height = 129;
+  const ImageBuffer input = make_rgb(width, height);
+  // every parallel kernel has to match its serial counterpart
+  const AlgoType algos[][2] = {
+      {AlgoType::kParallelCpu, AlgoType::kNativeCpu},
+      {AlgoType::kParallelSimdCpu, AlgoType::kSimdCpu}};
+
+  for (const auto &pair : algos) {
+    ImageBuffer expected(width, height, ImageFormat::IMAGE_GRAY8);
+    ASSERT_TRUE(color_convert(input.view(), expected.view(), pair[1]));
+    for (int grain : {0, 1, 7, 1000}) {
+      for (bool affinity : {true, false}) {
+        ParallelOptions options;
+        options.grain_rows = grain;
+        options.affinity = affinity;
+        set_parallel_options(options);
+        ImageBuffer output(width, height, ImageFormat::IMAGE_GRAY8);
+        ASSERT_TRUE(color_convert(input.view(), output.view(), pair[0]));
+        EXPECT_EQ(memcmp(output.data(), expected.data(), expected.size()), 0)
+            << "grain " << grain << " affinity " << affinity;
+      }
+    }
+  }
+  set_parallel_options(ParallelOptions());
+}
@@ -0,0 +1,100 @@
+#include "image-processing/color-convert/pipeline.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+TEST(PipelineTest, ConvertsFramesInOrder) {
+  const int width = 64;
+  const int height = 16;
+  const size_t count = 24;
+
+  PipelineOptions options;
+  options.max_in_flight = 3;
+  Pipeline pipeline(options);
+
+  std::atomic<int> in_flight(0);
+  int max_in_flight = 0;
+  std::vector<size_t> written;
+  pipeline
+      .read([&](PipelineFrame &frame) {
+        if (frame.index == count) {
+          return false;
+        }
+        frame.image = pipeline.pool().acquire(width, height,
+                                              ImageFormat::IMAGE_RGB8);
+        // a gray frame of value index
+        std::fill(frame.image.data(),
+                  frame.image.data() + frame.image.size(), frame.index);
+        max_in_flight = std::max(max_in_flight, ++in_flight);
+        return true;
+      })
+      .convert(ImageFormat::IMAGE_GRAY8, AlgoType::kSimdCpu)
+      .then([](PipelineFrame &frame) {
+        for (size_t i = 0; i < frame.image.size(); ++i) {
+          frame.image.data()[i] += 1;
+        }
+      })
+      .write([&](PipelineFrame &frame) {
+        ASSERT_EQ(frame.image.format(), ImageFormat::IMAGE_GRAY8);
+        for (size_t i = 0; i < frame.image.size(); ++i) {
+          ASSERT_EQ(frame.image.data()[i], frame.index + 1);
+        }
+        written.push_back(frame.index);
+        --in_flight;
+      });
+
+  ASSERT_TRUE(pipeline.run());
+  EXPECT_EQ(pipeline.frames(), count);
+  ASSERT_EQ(written.size(), count);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(written[i], i);
+  }
+  EXPECT_LE(max_in_flight, 3);
+
+  // the released frames are recycled, not reallocated per frame
+  EXPECT_GT(pipeline.pool().cached_bytes(), 0u);
+  EXPECT_LE(pipeline.pool().cached_bytes(), 4u * width * height * 4);
+}
+
+TEST(PipelineTest, FailedConversionStops) {
+  Pipeline pipeline;
+  size_t read = 0;
+  pipeline
+      .read([&](PipelineFrame &frame) {
+        if (frame.index == 100) {
+          return false;
+        }
+        ++read;
+        // gray has no conversion to NV12
+        frame.image =
+            pipeline.pool().acquire(16, 16, ImageFormat::IMAGE_GRAY8);
+        return true;
+      })
+      .convert(ImageFormat::IMAGE_NV12, AlgoType::kNativeCpu)
+      .write([](PipelineFrame &) { FAIL() << "a failed frame was written"; });
+
+  EXPECT_FALSE(pipeline.run());
+  EXPECT_EQ(pipeline.frames(), 0u);
+  EXPECT_LT(read, 100u);
+
+  EXPECT_FALSE(Pipeline().run());
+}
+
+TEST(PipelineTest, StageExceptionIsRethrown) {
+  Pipeline pipeline;
+  pipeline
+      .read([&](PipelineFrame &frame) {
+        frame.image = pipeline.pool().acquire(8, 8, ImageFormat::IMAGE_RGB8);
+        return frame.index < 10;
+      })
+      .then([](PipelineFrame &frame) {
+        if (frame.index == 5) {
+          throw std::runtime_error("stage failed");
+        }
+      });
+  EXPECT_THROW(pipeline.run(), std::runtime_error);
+}
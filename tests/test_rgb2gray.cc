@@ -3,7 +3,9 @@
 #include <fstream>
 #include <stdexcept>
 #include <vector>
+#if HAS_CUDA
 #include <thrust/device_vector.h>
+#endif
 
 static std::vector<unsigned char> read_raw_image(const std::string &filename,
                                                  int width, int height) {
@@ -151,6 +153,81 @@ TEST(RGB2GrayTest, PlanarSIMDConversion) {
       << " to be equal to 29 but it was not.";
 }
 
+TEST(RGB2GrayTest, PackedParallelSIMDConversion) {
+  int width = 1920;
+  int height = 1080;
+  auto input_image = read_raw_image("/tmp/geometric_image.rgb", width, height);
+  std::vector<unsigned char> output_image(width * height);
+
+  ASSERT_TRUE(image_processing::color_convert::kernels::rgb_2_gray(
+      input_image.data(), output_image.data(), width, height,
+      image_processing::color_convert::AlgoType::kParallelSimdCpu,
+      image_processing::color_convert::MemLayout::Packed))
+      << "Expected rgb_2_gray to return true but it returned false.";
+
+  EXPECT_TRUE(std::abs(output_image[100 * width + 100] - 76) <= 2)
+      << "Expected " << static_cast<int>(output_image[100 * width + 100])
+      << " to be equal to 76 but it was not.";
+  EXPECT_TRUE(std::abs(output_image[50 * width + 400] - 29) <= 2)
+      << "Expected " << static_cast<int>(output_image[50 * width + 400])
+      << " to be equal to 29 but it was not.";
+}
+
+TEST(RGB2GrayTest, PlanarParallelSIMDConversion) {
+  int width = 1920;
+  int height = 1080;
+  auto input_image = read_raw_image("/tmp/geometric_image.rgb", width, height);
+  std::vector<unsigned char> output_image(width * height);
+  auto input_image_planar = input_image;
+
+  for (int index = 0; index < height * width; index++) {
+    input_image_planar[index] = input_image[index * 3];
+    input_image_planar[index + height * width] = input_image[index * 3 + 1];
+    input_image_planar[index + 2 * height * width] = input_image[index * 3 + 2];
+  }
+
+  ASSERT_TRUE(image_processing::color_convert::kernels::rgb_2_gray(
+      input_image_planar.data(), output_image.data(), width, height,
+      image_processing::color_convert::AlgoType::kParallelSimdCpu,
+      image_processing::color_convert::MemLayout::Planar))
+      << "Expected rgb_2_gray to return true but it returned false.";
+
+  EXPECT_TRUE(std::abs(output_image[100 * width + 100] - 76) <= 2)
+      << "Expected " << static_cast<int>(output_image[100 * width + 100])
+      << " to be equal to 76 but it was not.";
+  EXPECT_TRUE(std::abs(output_image[50 * width + 400] - 29) <= 2)
+      << "Expected " << static_cast<int>(output_image[50 * width + 400])
+      << " to be equal to 29 but it was not.";
+}
+
+TEST(RGB2GrayTest, PackedSIMDMatchesFixedPoint) {
+  // odd size so that both the vector body and the scalar tail are covered
+  int width = 1001;
+  int height = 7;
+  std::vector<unsigned char> input_image(width * height * 3);
+  for (size_t i = 0; i < input_image.size(); i++) {
+    input_image[i] = static_cast<unsigned char>((i * 7919) >> 3);
+  }
+  std::vector<unsigned char> output_image(width * height);
+
+  for (auto algo_type :
+       {image_processing::color_convert::AlgoType::kSimdCpu,
+        image_processing::color_convert::AlgoType::kParallelSimdCpu}) {
+    ASSERT_TRUE(image_processing::color_convert::kernels::rgb_2_gray(
+        input_image.data(), output_image.data(), width, height, algo_type,
+        image_processing::color_convert::MemLayout::Packed))
+        << "Expected rgb_2_gray to return true but it returned false.";
+
+    for (int i = 0; i < width * height; i++) {
+      int r = input_image[i * 3];
+      int g = input_image[i * 3 + 1];
+      int b = input_image[i * 3 + 2];
+      ASSERT_EQ(output_image[i], (r * 77 + g * 150 + b * 29) >> 8)
+          << "Mismatch at pixel " << i;
+    }
+  }
+}
+
 #if HAS_CUDA
 TEST(RGB2GrayTest, PackedCUDAConversion) {
   int width = 1920;
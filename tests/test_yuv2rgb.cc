@@ -0,0 +1,279 @@
+#include "image-processing/color-convert/color-convert.hpp"
+#include "image-processing/color-convert/common/cpu-isa.hpp"
+#include "image-processing/color-convert/kernels/yuv2rgb.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+using namespace image_processing::color_convert;
+
+static unsigned char clamp_u8(int value) {
+  return static_cast<unsigned char>(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+// A YUV image as separate planes, u and v at half horizontal resolution and
+// half (4:2:0) or full (4:2:2) vertical resolution.
+struct YuvPlanes {
+  int width;
+  int height;
+  bool is_420;
+  std::vector<unsigned char> y, u, v;
+
+  YuvPlanes(int width, int height, bool is_420)
+      : width(width), height(height), is_420(is_420),
+        y(width * height), u(width / 2 * chroma_height()),
+        v(width / 2 * chroma_height()) {
+    for (size_t i = 0; i < y.size(); i++) {
+      y[i] = static_cast<unsigned char>((i * 7919) >> 3);
+    }
+    for (size_t i = 0; i < u.size(); i++) {
+      u[i] = static_cast<unsigned char>((i * 104729) >> 5);
+      v[i] = static_cast<unsigned char>((i * 1299709) >> 4);
+    }
+  }
+
+  int chroma_height() const { return is_420 ? height / 2 : height; }
+  int chroma_index(int x, int row) const {
+    return (is_420 ? row / 2 : row) * (width / 2) + x / 2;
+  }
+
+  // tightly packed image in format
+  std::vector<unsigned char> encode(ImageFormat format) const {
+    std::vector<unsigned char> data;
+    switch (format) {
+    case ImageFormat::IMAGE_I420:
+      data = y;
+      data.insert(data.end(), u.begin(), u.end());
+      data.insert(data.end(), v.begin(), v.end());
+      break;
+    case ImageFormat::IMAGE_YV12:
+      data = y;
+      data.insert(data.end(), v.begin(), v.end());
+      data.insert(data.end(), u.begin(), u.end());
+      break;
+    case ImageFormat::IMAGE_NV12:
+      data = y;
+      for (size_t i = 0; i < u.size(); i++) {
+        data.push_back(u[i]);
+        data.push_back(v[i]);
+      }
+      break;
+    default:
+      for (int row = 0; row < height; row++) {
+        for (int x = 0; x < width; x += 2) {
+          const unsigned char y0 = y[row * width + x];
+          const unsigned char y1 = y[row * width + x + 1];
+          const unsigned char u0 = u[chroma_index(x, row)];
+          const unsigned char v0 = v[chroma_index(x, row)];
+          if (format == ImageFormat::IMAGE_YUYV) {
+            data.insert(data.end(), {y0, u0, y1, v0});
+          } else if (format == ImageFormat::IMAGE_UYVY) {
+            data.insert(data.end(), {u0, y0, v0, y1});
+          } else {
+            data.insert(data.end(), {y0, v0, y1, u0});
+          }
+        }
+      }
+    }
+    return data;
+  }
+
+  // BT.601 limited range, 6 bit fixed point
+  std::vector<unsigned char> expected_rgb(ImageFormat output_format) const {
+    const size_t channels = image_format_channels(output_format);
+    const bool bgr = output_format == ImageFormat::IMAGE_BGR8 ||
+                     output_format == ImageFormat::IMAGE_BGRA8;
+    std::vector<unsigned char> rgb(width * height * channels);
+    for (int row = 0; row < height; row++) {
+      for (int x = 0; x < width; x++) {
+        const int luma = y[row * width + x];
+        const int d = u[chroma_index(x, row)] - 128;
+        const int e = v[chroma_index(x, row)] - 128;
+        const int c = ((luma > 16 ? luma - 16 : 0) * 149) >> 1;
+        unsigned char *pixel = &rgb[(row * width + x) * channels];
+        pixel[bgr ? 2 : 0] = clamp_u8((c + 102 * e + 32) >> 6);
+        pixel[1] = clamp_u8((c - 25 * d - 52 * e + 32) >> 6);
+        pixel[bgr ? 0 : 2] = clamp_u8((c + 129 * d + 32) >> 6);
+        if (channels == 4) {
+          pixel[3] = 255;
+        }
+      }
+    }
+    return rgb;
+  }
+};
+
+static bool is_420(ImageFormat format) {
+  return format == ImageFormat::IMAGE_I420 ||
+         format == ImageFormat::IMAGE_YV12 ||
+         format == ImageFormat::IMAGE_NV12;
+}
+
+TEST(YUV2RGBTest, KnownColors) {
+  // white, black and BT.601 red, 2x2 each
+  const std::vector<unsigned char> nv12 = {235, 235, 16, 16, 81, 81,
+                                           235, 235, 16, 16, 81, 81,
+                                           128, 128, 128, 128, 90, 240};
+  std::vector<unsigned char> rgb(6 * 2 * 3);
+  ASSERT_TRUE(color_convert(nv12.data(), rgb.data(), 6, 2,
+                            ImageFormat::IMAGE_NV12, ImageFormat::IMAGE_RGB8,
+                            AlgoType::kNativeCpu));
+  const std::vector<unsigned char> row = {255, 255, 255, 255, 255, 255,
+                                          0,   0,   0,   0,   0,   0,
+                                          254, 0,   0,   254, 0,   0};
+  EXPECT_EQ(std::vector<unsigned char>(rgb.begin(), rgb.begin() + 18), row);
+  EXPECT_EQ(std::vector<unsigned char>(rgb.begin() + 18, rgb.end()), row);
+}
+
+TEST(YUV2RGBTest, AllFormatsAndVariants) {
+  // wider than one vector of every variant, with a scalar tail
+  const int width = 102;
+  const int height = 6;
+
+  const CpuIsa detected = cpu_isa();
+  for (CpuIsa isa : {CpuIsa::kGeneric, CpuIsa::kSse41, CpuIsa::kAvx2,
+                     CpuIsa::kAvx512bw, CpuIsa::kNeon}) {
+    if (!set_cpu_isa(isa)) {
+      continue;
+    }
+    for (ImageFormat format :
+         {ImageFormat::IMAGE_I420, ImageFormat::IMAGE_YV12,
+          ImageFormat::IMAGE_NV12, ImageFormat::IMAGE_YUYV,
+          ImageFormat::IMAGE_UYVY, ImageFormat::IMAGE_YVYU}) {
+      const YuvPlanes planes(width, height, is_420(format));
+      const auto input_image = planes.encode(format);
+      const ConstImageView input(input_image.data(), width, height, format);
+
+      for (ImageFormat output_format :
+           {ImageFormat::IMAGE_RGB8, ImageFormat::IMAGE_RGBA8,
+            ImageFormat::IMAGE_BGR8, ImageFormat::IMAGE_BGRA8}) {
+        const auto expected = planes.expected_rgb(output_format);
+        for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                              AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+          std::vector<unsigned char> output_image(expected.size());
+          ASSERT_TRUE(kernels::yuv_2_rgb(
+              input,
+              ImageView(output_image.data(), width, height, output_format),
+              algo));
+          EXPECT_EQ(output_image, expected)
+              << cpu_isa_to_str(isa) << " " << image_format_to_str(format)
+              << " -> " << image_format_to_str(output_format) << " algo "
+              << static_cast<int>(algo);
+        }
+      }
+
+      for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                            AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+        std::vector<unsigned char> gray(width * height);
+        ASSERT_TRUE(kernels::yuv_2_gray(
+            input,
+            ImageView(gray.data(), width, height, ImageFormat::IMAGE_GRAY8),
+            algo));
+        EXPECT_EQ(gray, planes.y) << image_format_to_str(format);
+      }
+    }
+  }
+  set_cpu_isa(detected);
+}
+
+TEST(YUV2RGBTest, PaddedNV12) {
+  const int width = 64;
+  const int height = 8;
+  const size_t pitch = 80;
+  const YuvPlanes planes(width, height, true);
+  const auto tight = planes.encode(ImageFormat::IMAGE_NV12);
+
+  // luma rows and chroma rows both use the padded pitch
+  std::vector<unsigned char> padded(pitch * height * 3 / 2, 0);
+  for (int row = 0; row < height * 3 / 2; row++) {
+    std::copy(tight.begin() + row * width, tight.begin() + (row + 1) * width,
+              padded.begin() + row * pitch);
+  }
+  const ConstImageView input(padded.data(), width, height,
+                             ImageFormat::IMAGE_NV12, MemLayout::Packed,
+                             pitch);
+
+  std::vector<unsigned char> output_image(width * height * 4);
+  ASSERT_TRUE(kernels::yuv_2_rgb(
+      input,
+      ImageView(output_image.data(), width, height, ImageFormat::IMAGE_RGBA8),
+      AlgoType::kParallelSimdCpu));
+  EXPECT_EQ(output_image, planes.expected_rgb(ImageFormat::IMAGE_RGBA8));
+}
+
+TEST(YUV2RGBTest, RegionOfInterest) {
+  const int width = 96;
+  const int height = 64;
+  const int x0 = 18;
+  const int y0 = 10;
+  const int roi_width = 40;
+  const int roi_height = 36;
+  const YuvPlanes planes(width, height, true);
+
+  for (ImageFormat format : {ImageFormat::IMAGE_I420, ImageFormat::IMAGE_YV12,
+                             ImageFormat::IMAGE_NV12}) {
+    const auto image = planes.encode(format);
+    const ConstImageView input(image.data(), width, height, format);
+    std::vector<unsigned char> full(width * height * 3);
+    ASSERT_TRUE(color_convert(
+        input, ImageView(full.data(), width, height, ImageFormat::IMAGE_RGB8),
+        AlgoType::kNativeCpu));
+
+    for (AlgoType algo : {AlgoType::kNativeCpu, AlgoType::kParallelCpu,
+                          AlgoType::kSimdCpu, AlgoType::kParallelSimdCpu}) {
+      std::vector<unsigned char> output_image(roi_width * roi_height * 3);
+      ASSERT_TRUE(color_convert(input.roi(x0, y0, roi_width, roi_height),
+                                ImageView(output_image.data(), roi_width,
+                                          roi_height, ImageFormat::IMAGE_RGB8),
+                                algo));
+      // the same crop of the full frame conversion
+      for (int y = 0; y < roi_height; y++) {
+        ASSERT_TRUE(std::equal(
+            output_image.begin() + y * roi_width * 3,
+            output_image.begin() + (y + 1) * roi_width * 3,
+            full.begin() + ((y0 + y) * width + x0) * 3))
+            << image_format_to_str(format) << " algo "
+            << static_cast<int>(algo) << " row " << y;
+      }
+    }
+
+    // a region splitting chroma samples cannot be converted
+    std::vector<unsigned char> output_image(roi_width * roi_height * 3);
+    const ImageView output(output_image.data(), roi_width, roi_height,
+                           ImageFormat::IMAGE_RGB8);
+    EXPECT_FALSE(color_convert(input.roi(x0 + 1, y0, roi_width, roi_height),
+                               output, AlgoType::kNativeCpu));
+    EXPECT_FALSE(color_convert(input.roi(x0, y0 + 1, roi_width, roi_height),
+                               output, AlgoType::kNativeCpu));
+  }
+}
+
+TEST(YUV2RGBTest, LumaView) {
+  std::vector<unsigned char> nv12(64 * 8 * 3 / 2);
+  const ConstImageView input(nv12.data(), 64, 8, ImageFormat::IMAGE_NV12,
+                             MemLayout::Packed, 80);
+  const ConstImageView luma = luma_view(input);
+  EXPECT_EQ(luma.data, nv12.data());
+  EXPECT_EQ(luma.format, ImageFormat::IMAGE_GRAY8);
+  EXPECT_EQ(luma.pitch, 80u);
+  EXPECT_EQ(luma.width, 64);
+
+  const ConstImageView yuyv(nv12.data(), 32, 8, ImageFormat::IMAGE_YUYV);
+  EXPECT_EQ(luma_view(yuyv).data, nullptr);
+}
+
+TEST(YUV2RGBTest, InvalidArguments) {
+  std::vector<unsigned char> input_image(16 * 4 * 2);
+  std::vector<unsigned char> output_image(16 * 4 * 3);
+  // odd width
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 15, 4,
+                             ImageFormat::IMAGE_YUYV, ImageFormat::IMAGE_RGB8,
+                             AlgoType::kSimdCpu));
+  // odd height of a 4:2:0 image
+  EXPECT_FALSE(color_convert(input_image.data(), output_image.data(), 16, 3,
+                             ImageFormat::IMAGE_I420, ImageFormat::IMAGE_RGB8,
+                             AlgoType::kSimdCpu));
+  EXPECT_TRUE(color_convert(input_image.data(), output_image.data(), 16, 3,
+                            ImageFormat::IMAGE_UYVY, ImageFormat::IMAGE_RGB8,
+                            AlgoType::kSimdCpu));
+}
@@ -0,0 +1,49 @@
+#include "image-processing/color-convert/file-convert.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace image_processing::color_convert;
+
+static void usage(const char *program) {
+  fprintf(stderr,
+          "usage: %s <input> <output> <width> <height> <input-format> "
+          "<output-format> [native|parallel|simd|parallel-simd|auto] "
+          "[band-MiB]\n"
+          "\n"
+          "Converts a raw file of tightly packed frames, e.g.\n"
+          "  %s capture.nv12 capture.rgb 1920 1080 nv12 rgb8\n",
+          program, program);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 7 || argc > 9) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  const int width = atoi(argv[3]);
+  const int height = atoi(argv[4]);
+  const ImageFormat input_format = image_format_from_str(argv[5]);
+  const ImageFormat output_format = image_format_from_str(argv[6]);
+  AlgoType algo_type = AlgoType::kParallelSimdCpu;
+  FileConvertOptions options;
+  if (width <= 0 || height <= 0 ||
+      input_format == ImageFormat::IMAGE_UNKNOWN ||
+      output_format == ImageFormat::IMAGE_UNKNOWN ||
+      (argc > 7 && !algo_type_from_str(argv[7], &algo_type))) {
+    usage(argv[0]);
+    return 1;
+  }
+  if (argc > 8) {
+    options.band_bytes = strtoull(argv[8], nullptr, 10) << 20;
+  }
+
+  if (!color_convert_file(argv[1], argv[2], width, height, input_format,
+                          output_format, algo_type, options)) {
+    fprintf(stderr, "%s: converting %s (%s) to %s (%s) failed\n", argv[0],
+            argv[1], image_format_to_str(input_format), argv[2],
+            image_format_to_str(output_format));
+    return 1;
+  }
+  return 0;
+}